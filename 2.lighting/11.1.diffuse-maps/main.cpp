@@ -3,6 +3,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <learnopengl/shader.h>
 #include <learnopengl/camera.h>
+#include <learnopengl/texture_cache.h>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <stbi_image.h>
@@ -272,41 +273,7 @@ unsigned int setupLightVAO() {
 * Utility function for loading a 2D texture from a file
 */
 unsigned int loadTexture(char const *path) {
-  unsigned int textureID;
-  glGenTextures(1, &textureID);
-  
-  int width, height, nrChannels;
-  std::string resourcePath = (std::string(RESOURCES_DIR) + path);
-  unsigned char *data = stbi_load(resourcePath.c_str(), &width, &height, &nrChannels, 0);
-
-  if (data) {
-    GLenum format;
-    if (nrChannels == 1)
-      format = GL_RED;
-    else if (nrChannels == 3)
-      format = GL_RGB;
-    else if (nrChannels == 4)
-      format = GL_RGBA;
-
-    // Bind and set the newly created texture
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // set the texture wrapping / filtering options
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // free the data
-    stbi_image_free(data);
-  } else {
-    std::cout << "Failed to load texture" << std::endl;
-    stbi_image_free(data);
-  }
-
-  return textureID;
+  return TextureCache::instance().acquire(std::string(RESOURCES_DIR) + path);
 }
 
 std::array<unsigned int, 2> setupTextures() {
@@ -314,7 +281,7 @@ std::array<unsigned int, 2> setupTextures() {
   std::array<unsigned int, 2> textures{};
 
   // flip images vertically
-  stbi_set_flip_vertically_on_load(true);
+  ImageLoader::setFlipVerticallyOnLoad(true);
 
   textures[0] = loadTexture("/textures/container2.png");
   textures[1] = loadTexture("/textures/awesomeface.png");
@@ -3,6 +3,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <learnopengl/shader.h>
 #include <learnopengl/camera.h>
+#include <learnopengl/texture_cache.h>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <stbi_image.h>
@@ -11,9 +12,11 @@
 #include <algorithm>
 
 // Data Structures
+const unsigned int NUM_POINT_LIGHTS = 4;
+
 struct WorldData {
   glm::vec3 cubePositions[10];
-  glm::vec3 lightPositions[4];
+  glm::vec3 lightPositions[NUM_POINT_LIGHTS];
 };
 
 // Function Headers
@@ -83,7 +86,12 @@ int main() {
   GLFWwindow *window = init();
 
   // setup shader
-  Shader shader((std::string(SHADER_DIR) + "/cube-vertex.glsl").c_str(), (std::string(SHADER_DIR) + "/cube-fragment.glsl").c_str());
+  Shader shader({
+    std::string(SHADER_DIR) + "/cube-vertex.glsl",
+    std::string(SHADER_DIR) + "/cube-fragment.glsl",
+    "",
+    { { "NUM_POINT_LIGHTS", std::to_string(NUM_POINT_LIGHTS) } },
+  });
   shader.use();
   shader.setInt("texture1", 0);
   shader.setInt("texture2", 1);
@@ -300,41 +308,7 @@ unsigned int setupLightVAO() {
 * Utility function for loading a 2D texture from a file
 */
 unsigned int loadTexture(char const *path) {
-  unsigned int textureID;
-  glGenTextures(1, &textureID);
-  
-  int width, height, nrChannels;
-  std::string resourcePath = (std::string(RESOURCES_DIR) + path);
-  unsigned char *data = stbi_load(resourcePath.c_str(), &width, &height, &nrChannels, 0);
-
-  if (data) {
-    GLenum format;
-    if (nrChannels == 1)
-      format = GL_RED;
-    else if (nrChannels == 3)
-      format = GL_RGB;
-    else if (nrChannels == 4)
-      format = GL_RGBA;
-
-    // Bind and set the newly created texture
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // set the texture wrapping / filtering options
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // free the data
-    stbi_image_free(data);
-  } else {
-    std::cout << "Failed to load texture" << std::endl;
-    stbi_image_free(data);
-  }
-
-  return textureID;
+  return TextureCache::instance().acquire(std::string(RESOURCES_DIR) + path);
 }
 
 std::array<unsigned int, 2> setupTextures() {
@@ -342,7 +316,7 @@ std::array<unsigned int, 2> setupTextures() {
   std::array<unsigned int, 2> textures{};
 
   // flip images vertically
-  stbi_set_flip_vertically_on_load(true);
+  ImageLoader::setFlipVerticallyOnLoad(true);
 
   textures[0] = loadTexture("/textures/container2.png");
   textures[1] = loadTexture("/textures/container2_specular.png");
@@ -363,7 +337,7 @@ void renderLight(Shader &shader, unsigned int VAO, WorldData world) {
 
   // Render the lights
   glBindVertexArray(VAO);
-  for (unsigned int i = 0; i < 4; ++i) {
+  for (unsigned int i = 0; i < NUM_POINT_LIGHTS; ++i) {
     glm::mat4 model = glm::mat4(1.0f);
     model = glm::translate(model, world.lightPositions[i]);
     model = glm::scale(model, glm::vec3(0.2f));
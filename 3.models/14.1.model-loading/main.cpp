@@ -4,6 +4,8 @@
 #include <learnopengl/shader.h>
 #include <learnopengl/camera.h>
 #include <learnopengl/model.h>
+#include <learnopengl/cluster_culling.h>
+#include <learnopengl/texture_cache.h>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <stbi_image.h>
@@ -38,6 +40,8 @@ float lastFrame = 0.0f;
 float lastX = 400.0f;
 float lastY = 300.0f;
 Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+ClusterCuller culler;
+float lastCullReport = 0.0f;
 glm::vec3 lightPos(2.0f, 1.0f, 2.0f);
 
 GLFWwindow *init() {
@@ -113,7 +117,8 @@ int main() {
   };
 
   Shader backpackShader = Shader((string(SHADER_DIR) + "/model-vertex.glsl").c_str(), (string(SHADER_DIR) + "/model-fragment.glsl").c_str());
-  Model backpack = Model("/objects/backpack/backpack.obj");
+  Model backpack = Model("/objects/backpack/backpack.obj", { .retention = GeometryRetention::Release, .clusters = true });
+  backpack.printMemoryReport("backpack");
 
   // Create a render loop that swaps the front/back buffers and polls for user events
   // Necessary to prevent the window from closing instantly
@@ -132,6 +137,13 @@ int main() {
     renderModel(backpack, backpackShader, world);
     renderLight(lightShader, LIGHT_VAO, world);
 
+    // report the cluster culling counters once a second
+    ClusterCuller::Stats culled = culler.endFrame();
+    if (currentFrame - lastCullReport > 1.0f) {
+      ClusterCuller::printStats(culled);
+      lastCullReport = currentFrame;
+    }
+
     // check events and swap buffers
     glfwSwapBuffers(window);
     glfwPollEvents();
@@ -292,41 +304,7 @@ unsigned int setupLightVAO() {
 * Utility function for loading a 2D texture from a file
 */
 unsigned int loadTexture(char const *path) {
-  unsigned int textureID;
-  glGenTextures(1, &textureID);
-  
-  int width, height, nrChannels;
-  std::string resourcePath = (std::string(RESOURCES_DIR) + path);
-  unsigned char *data = stbi_load(resourcePath.c_str(), &width, &height, &nrChannels, 0);
-
-  if (data) {
-    GLenum format;
-    if (nrChannels == 1)
-      format = GL_RED;
-    else if (nrChannels == 3)
-      format = GL_RGB;
-    else if (nrChannels == 4)
-      format = GL_RGBA;
-
-    // Bind and set the newly created texture
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // set the texture wrapping / filtering options
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // free the data
-    stbi_image_free(data);
-  } else {
-    std::cout << "Failed to load texture" << std::endl;
-    stbi_image_free(data);
-  }
-
-  return textureID;
+  return TextureCache::instance().acquire(std::string(RESOURCES_DIR) + path);
 }
 
 std::array<unsigned int, 2> setupTextures() {
@@ -334,7 +312,7 @@ std::array<unsigned int, 2> setupTextures() {
   std::array<unsigned int, 2> textures{};
 
   // flip images vertically
-  stbi_set_flip_vertically_on_load(true);
+  ImageLoader::setFlipVerticallyOnLoad(true);
 
   textures[0] = loadTexture("/textures/container2.png");
   textures[1] = loadTexture("/textures/container2_specular.png");
@@ -417,7 +395,7 @@ void renderModel(Model &model, Shader &shader, WorldData world) {
 
   sendLightData(shader, world);
 
-  model.draw(shader);
+  culler.draw(model, shader, modelMatrix, view, projection);
 }
 
 void renderLight(Shader &shader, unsigned int VAO, WorldData world) {
@@ -320,16 +320,19 @@ unsigned int loadCubemap(vector<string> faces) {
   glGenTextures(1, &textureID);
   glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
 
-  int width, height, nrChannels;
+  // Decode all six faces in parallel, then upload them in face order
+  vector<ImageRequest> requests;
   for (int i=0; i<faces.size(); ++i) {
-    string resourcePath = (string(RESOURCES_DIR) + faces[i]);
-    unsigned char *data = stbi_load(resourcePath.c_str(), &width, &height, &nrChannels, 0);
-    if (data) {
-      glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+    requests.push_back({ string(RESOURCES_DIR) + faces[i] });
+  }
+  vector<Image> images = ImageLoader::instance().loadAll(requests);
+
+  for (int i=0; i<images.size(); ++i) {
+    if (images[i].valid()) {
+      glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, images[i].width, images[i].height, 0, GL_RGB, GL_UNSIGNED_BYTE, images[i].data());
     } else {
       std::cout << "Cubemap failed to load at path: " << faces[i] << std::endl;
     }
-    stbi_image_free(data);
   }
 
   glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -72,7 +72,7 @@ int main() {
   GLFWwindow *window = init();
 
   // flip images vertically
-  stbi_set_flip_vertically_on_load(true);
+  ImageLoader::setFlipVerticallyOnLoad(true);
 
   Shader backpackShader = Shader(
     (string(SHADER_DIR) + "/model-vertex.glsl").c_str(), 
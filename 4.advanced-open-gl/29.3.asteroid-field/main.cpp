@@ -4,6 +4,8 @@
 #include <learnopengl/shader.h>
 #include <learnopengl/camera.h>
 #include <learnopengl/model.h>
+#include <learnopengl/lod.h>
+#include <learnopengl/draw_queue.h>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <stbi_image.h>
@@ -14,7 +16,12 @@ using std::string;
 // Function Headers
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow *window, float &deltaTime);
-void renderModel(Model &model, Shader &shader, glm::mat4 modelMatrix);
+
+// Resolved once, the draw queue resolves "model" itself
+struct ModelUniforms {
+  UniformHandle<glm::mat4> view;
+  UniformHandle<glm::mat4> projection;
+};
 void mouseCallback(GLFWwindow *window, double xPos, double yPos);
 void scrollCallback(GLFWwindow *window, double xPos, double yPos);
 
@@ -25,6 +32,7 @@ float lastFrame = 0.0f;
 float lastX = 400.0f;
 float lastY = 300.0f;
 Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+ModelUniforms modelUniforms;
 
 GLFWwindow *init() {
   // Init GLFW and set the context variables
@@ -75,9 +83,17 @@ int main() {
     (string(SHADER_DIR) + "/model-vertex.glsl").c_str(),
     (string(SHADER_DIR) + "/model-fragment.glsl").c_str()
   );
+  modelUniforms = {
+    modelShader.uniform<glm::mat4>("view"),
+    modelShader.uniform<glm::mat4>("projection"),
+  };
 
-  Model rock = Model("/objects/rock/rock.obj");
+  Model rock = Model("/objects/rock/rock.obj", { .lodCount = 4 });
+  LodSelector rockLods = LodSelector(rock);
   Model planet = Model("/objects/planet/planet.obj");
+  // rock and planet share texture arrays, so the rocks never rebind anything
+  Model::packTextureArrays({ &rock, &planet });
+  TextureCache::instance().printStats();
 
   // Movement of the asteroids
   unsigned int amount = 1000;
@@ -108,6 +124,9 @@ int main() {
     modelMatrices[i] = model;
   }
 
+  unsigned int frameCount = 0;
+  DrawQueue drawQueue;
+
   // Create a render loop that swaps the front/back buffers and polls for user events
   // Necessary to prevent the window from closing instantly
   while (!glfwWindowShouldClose(window)) {
@@ -125,9 +144,36 @@ int main() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // Render something
-    renderModel(planet, modelShader, glm::mat4(1.0));
+    // every bind in the frame goes through GLState, so the rocks only issue their draw calls
+    GLState &state = GLState::instance();
+    state.beginFrame();
+    glm::mat4 view = camera.getLookAt();
+    glm::mat4 projection = glm::perspective(glm::radians(camera.zoom), 800.0f / 600.0f, 0.1f, 100.0f);
+    modelShader.use();
+    modelShader.set(modelUniforms.view, view);
+    modelShader.set(modelUniforms.projection, projection);
+
+    // submit in any order, the sort groups the rocks by mesh and draws each group front to back;
+    // every level is an index range of the same VAO, so mixing levels costs no state change
+    drawQueue.clear();
+    drawQueue.setView(camera.cameraPos, 100.0f);
+    drawQueue.submit(DrawPass::Opaque, modelShader, planet, glm::mat4(1.0), 0);
+    float projectionScale = LodSelector::projectionScale(camera.getPerspective(), 600.0f);
     for (unsigned int i=0; i<amount; ++i) {
-      renderModel(rock, modelShader, modelMatrices[i]);
+      unsigned int lod = rockLods.select(modelMatrices[i], camera.cameraPos, projectionScale);
+      drawQueue.submit(DrawPass::Opaque, modelShader, rock, modelMatrices[i], lod);
+    }
+    drawQueue.sort();
+    drawQueue.execute();
+    state.endFrame();
+
+    // every uniform above goes through a handle, so this should stay at zero
+    unsigned int stringLookups = Shader::resetStringLookups();
+    if (stringLookups > 0)
+      std::cout << "Uniform string lookups this frame: " << stringLookups << std::endl;
+    if (++frameCount % 600 == 1) {
+      state.printStats();
+      drawQueue.printStats();
     }
 
     // check events and swap buffers
@@ -139,19 +185,6 @@ int main() {
   return 0;
 }
 
-void renderModel(Model &model, Shader &shader, glm::mat4 modelMatrix) {
-  shader.use();
-
-  glm::mat4 view = camera.getLookAt();
-  glm::mat4 projection = glm::perspective(glm::radians(camera.zoom), 800.0f / 600.0f, 0.1f, 100.0f);
-
-  shader.setMat4("view", view);
-  shader.setMat4("projection", projection);
-  shader.setMat4("model", modelMatrix);
-
-  model.draw(shader);
-}
-
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
   glViewport(0, 0, width, height);
 }
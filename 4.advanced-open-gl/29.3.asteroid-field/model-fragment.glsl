@@ -1,8 +1,10 @@
 #version 330 core
 
 struct Material {
-  sampler2D texture_specular1;
-  sampler2D texture_diffuse1;
+  sampler2DArray texture_specular1;
+  sampler2DArray texture_diffuse1;
+  float texture_specular1Layer;
+  float texture_diffuse1Layer;
   float shininess;
 };
 
@@ -17,7 +19,7 @@ in V_OUT {
 uniform Material material;
 
 void main() {    
-  vec3 textureColour = vec3(texture(material.texture_diffuse1, f_in.tex));
+  vec3 textureColour = vec3(texture(material.texture_diffuse1, vec3(f_in.tex, material.texture_diffuse1Layer)));
   FragColor = vec4(textureColour, 1.0);
 }
 
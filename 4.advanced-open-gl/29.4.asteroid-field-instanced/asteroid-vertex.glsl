@@ -1,11 +1,14 @@
 #version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec2 aTexCoords;
+// VertexFormat::Packed
+layout (location = 0) in vec4 aPos;       // unorm16 against the mesh bounds, w = bitangent sign
+layout (location = 1) in vec2 aNormal;    // octahedral snorm16
+layout (location = 2) in vec2 aTexCoords; // half float
 layout (location = 3) in mat4 aModel;
 
 uniform mat4 view;
 uniform mat4 projection;
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
 
 out V_OUT {
   vec3 normal;
@@ -13,10 +16,20 @@ out V_OUT {
   vec2 tex;
 } v_out;
 
+// Inverse of octEncode in vertex_format.h
+vec3 octDecode(vec2 e) {
+  vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+  if (n.z < 0.0)
+    n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+  return normalize(n);
+}
+
 void main()
 {
-  gl_Position = projection * view * aModel * vec4(aPos, 1.0);
-  v_out.position = vec3(aModel * vec4(aPos, 1.0));
-  v_out.normal = mat3(transpose(inverse(aModel))) * aNormal;
+  vec3 position = positionOffset + aPos.xyz * positionScale;
+  vec3 normal = octDecode(aNormal);
+  gl_Position = projection * view * aModel * vec4(position, 1.0);
+  v_out.position = vec3(aModel * vec4(position, 1.0));
+  v_out.normal = mat3(transpose(inverse(aModel))) * normal;
   v_out.tex = aTexCoords;
 }
@@ -4,6 +4,7 @@
 #include <learnopengl/shader.h>
 #include <learnopengl/camera.h>
 #include <learnopengl/model.h>
+#include <learnopengl/lod.h>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <stbi_image.h>
@@ -82,7 +83,8 @@ int main() {
   );
 
   Model planet = Model("/objects/planet/planet.obj");
-  Model rock = Model("/objects/rock/rock.obj");
+  Model rock = Model("/objects/rock/rock.obj", { .vertexFormat = VertexFormat::Packed, .lodCount = 4 });
+  TextureCache::instance().printStats();
 
   // Movement of the asteroids
   unsigned int amount = 10000;
@@ -113,32 +115,9 @@ int main() {
     modelMatrices[i] = model;
   }
 
-  // Insert the instanced matrices here per mesh
-  unsigned int buffer;
-  glGenBuffers(1, &buffer);
-  glBindBuffer(GL_ARRAY_BUFFER, buffer);
-  glBufferData(GL_ARRAY_BUFFER, amount * sizeof(glm::mat4), &modelMatrices[0], GL_STATIC_DRAW);
-
-  // Tell the meshes to take from the buffer with a divisor
-  for (unsigned int i=0; i<rock.meshes.size(); ++i) {
-    unsigned int VAO = rock.meshes[i].VAO;
-    glBindVertexArray(VAO);
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)0);
-    glEnableVertexAttribArray(4);
-    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(1 * sizeof(glm::vec4)));
-    glEnableVertexAttribArray(5);
-    glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(2 * sizeof(glm::vec4)));
-    glEnableVertexAttribArray(6);
-    glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(3 * sizeof(glm::vec4)));
-
-    glVertexAttribDivisor(3, 1);
-    glVertexAttribDivisor(4, 1);
-    glVertexAttribDivisor(5, 1);
-    glVertexAttribDivisor(6, 1);
-
-    glBindVertexArray(0);
-  }
+  // Hand the matrices to the instancer, which buckets them per LOD every frame
+  LodInstancer rocks(rock, vector<glm::mat4>(modelMatrices, modelMatrices + amount));
+  delete[] modelMatrices;
 
   // Create a render loop that swaps the front/back buffers and polls for user events
   // Necessary to prevent the window from closing instantly
@@ -162,11 +141,8 @@ int main() {
     asteroidShader.use();
     asteroidShader.setMat4("view", camera.getLookAt());
     asteroidShader.setMat4("projection", camera.getPerspective());
-    for (unsigned int i=0; i<rock.meshes.size(); ++i) {
-      rock.meshes[i].setMaterial(asteroidShader);
-      glBindVertexArray(rock.meshes[i].VAO);
-      glDrawElementsInstanced(GL_TRIANGLES, rock.meshes[i].indices.size(), GL_UNSIGNED_INT, 0, amount);
-    }
+    rocks.update(camera.cameraPos, camera.getPerspective(), 600.0f);
+    rocks.draw(asteroidShader);
 
     // check events and swap buffers
     glfwSwapBuffers(window);
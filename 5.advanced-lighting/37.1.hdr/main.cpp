@@ -4,6 +4,7 @@
 #include <learnopengl/shader.h>
 #include <learnopengl/camera.h>
 #include <learnopengl/model.h> 
+#include <learnopengl/texture_cache.h>
 #include <glad/glad.h> 
 #include <GLFW/glfw3.h>
 #include <stbi_image.h>
@@ -33,8 +34,8 @@ struct Scene {
 // Function Headers
 unsigned int generateWall();
 Scene generateScene();
-void renderTunnel(Scene scene);
-void renderQuad(Scene scene);
+void renderTunnel(Scene &scene);
+void renderQuad(Scene &scene);
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow *window, float &deltaTime);
 unsigned int loadTexture(char const *path);
@@ -236,7 +237,8 @@ tuple<unsigned int, unsigned int, unsigned int> generateBuffers() {
   unsigned int colorBuffer; 
   glGenTextures(1, &colorBuffer);
   glBindTexture(GL_TEXTURE_2D, colorBuffer);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, SCREEN_WIDTH, SCREEN_HEIGHT, 0, GL_RGBA, GL_FLOAT, NULL);
+  // HDR colour never goes negative, so the packed float format holds it in half the memory of RGBA16F
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, SCREEN_WIDTH, SCREEN_HEIGHT, 0, GL_RGB, GL_FLOAT, NULL);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
@@ -281,8 +283,8 @@ Scene generateScene() {
   const auto buffers = generateBuffers();
 
   return {
-    .cube =  { cubeShader, cubeVAO, woodTexture },
-    .quad = { hdrShader, quadVAO, 0 },
+    .cube =  { std::move(cubeShader), cubeVAO, woodTexture },
+    .quad = { std::move(hdrShader), quadVAO, 0 },
     .lights = lights,
     .frameBuffer = get<0>(buffers),
     .colorBuffer = get<1>(buffers),
@@ -290,8 +292,8 @@ Scene generateScene() {
   };
 }
 
-void renderTunnel(Scene scene) {
-  GameObject cube = scene.cube;
+void renderTunnel(Scene &scene) {
+  GameObject &cube = scene.cube;
 
   cube.shader.use();
   glm::mat4 model = glm::mat4(1.0);
@@ -315,7 +317,7 @@ void renderTunnel(Scene scene) {
   glBindVertexArray(0);
 }
 
-void renderQuad(Scene scene) {
+void renderQuad(Scene &scene) {
   scene.quad.shader.use();
   scene.quad.shader.setInt("colorBuffer", 0);
   scene.quad.shader.setFloat("exposure", 0.1);
@@ -330,43 +332,7 @@ void renderQuad(Scene scene) {
 * Utility function for loading a 2D texture from a file
 */
 unsigned int loadTexture(char const *path) {
-  unsigned int textureID;
-  glGenTextures(1, &textureID);
-  
-  int width, height, nrChannels;
-  std::string resourcePath = (std::string(RESOURCES_DIR) + path);
-  unsigned char *data = stbi_load(resourcePath.c_str(), &width, &height, &nrChannels, 0);
-
-  if (data) {
-    GLenum format;
-    if (nrChannels == 1)
-      format = GL_RED;
-    else if (nrChannels == 3)
-      format = GL_RGB;
-    else if (nrChannels == 4)
-      format = GL_RGBA;
-
-    // Bind and set the newly created texture
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    /*glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);*/
-    // Force to GL_SRGB
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // set the texture wrapping / filtering options
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // free the data
-    stbi_image_free(data);
-  } else {
-    std::cout << "Failed to load texture" << std::endl;
-    stbi_image_free(data);
-  }
-
-  return textureID;
+  return TextureCache::instance().acquire(std::string(RESOURCES_DIR) + path, { .srgb = true });
 }
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
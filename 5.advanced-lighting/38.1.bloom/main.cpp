@@ -4,6 +4,7 @@
 #include <learnopengl/shader.h>
 #include <learnopengl/camera.h>
 #include <learnopengl/model.h> 
+#include <learnopengl/texture_cache.h>
 #include <glad/glad.h> 
 #include <GLFW/glfw3.h>
 #include <stbi_image.h>
@@ -33,6 +34,33 @@ struct Buffers {
   array<unsigned int, 2> pingpongTextures;
 };
 
+// Handles resolved once the programs are built, so a frame never looks a uniform up by name
+struct LightUniforms {
+  UniformHandle<glm::vec3> position;
+  UniformHandle<glm::vec3> colour;
+};
+
+struct CubeUniforms {
+  UniformHandle<glm::mat4> view;
+  UniformHandle<glm::mat4> projection;
+  UniformHandle<glm::mat4> model;
+  UniformHandle<glm::vec3> viewPos;
+  array<LightUniforms, 4> lights;
+};
+
+struct LightBoxUniforms {
+  UniformHandle<glm::mat4> view;
+  UniformHandle<glm::mat4> projection;
+  UniformHandle<glm::mat4> model;
+  UniformHandle<glm::vec3> lightColour;
+};
+
+struct Uniforms {
+  CubeUniforms cube;
+  LightBoxUniforms light;
+  UniformHandle<bool> horizontal;
+};
+
 struct Scene {
   GameObject cube;
   GameObject light;
@@ -41,13 +69,14 @@ struct Scene {
   Textures textures;
   array<Light, 4> lights;
   Buffers buffers;
+  Uniforms uniforms;
 };
 
 // Function Headers
 unsigned int generateWall();
 Scene generateScene();
-void renderScene(Scene scene);
-void renderQuad(GameObject quad);
+void renderScene(Scene &scene);
+void renderQuad(GameObject &quad);
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow *window, float &deltaTime);
 unsigned int loadTexture(char const *path);
@@ -110,6 +139,7 @@ int main() {
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
   Scene scene = generateScene();
+  unsigned int frameCount = 0;
 
   // Create a render loop that swaps the front/back buffers and polls for user events
   // Necessary to prevent the window from closing instantly
@@ -122,12 +152,16 @@ int main() {
     // inputs
     processInput(window, deltaTime);
 
+    // every bind in the frame goes through GLState, so the passes only issue what changes
+    GLState &state = GLState::instance();
+    state.beginFrame();
+
     // Reset the buffer from the previous render!
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // 1. render the scene to the framebuffer
-    glBindFramebuffer(GL_FRAMEBUFFER, scene.buffers.framebuffer);
+    state.bindFramebuffer(GL_FRAMEBUFFER, scene.buffers.framebuffer);
       glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
       renderScene(scene);
 
@@ -136,26 +170,24 @@ int main() {
     int amount = 10;
     scene.blur.shader.use();
     for (unsigned int i=0; i<amount; i++) {
-      glBindFramebuffer(GL_FRAMEBUFFER, scene.buffers.pingpongFBO[horizontal]);
-      scene.blur.shader.setBool("horizontal", horizontal);
-      glBindTexture(GL_TEXTURE_2D, first_iteration ? scene.buffers.colorBuffers[1] : scene.buffers.pingpongTextures[!horizontal]);
+      state.bindFramebuffer(GL_FRAMEBUFFER, scene.buffers.pingpongFBO[horizontal]);
+      scene.blur.shader.set(scene.uniforms.horizontal, horizontal);
+      state.bindTexture(0, GL_TEXTURE_2D, first_iteration ? scene.buffers.colorBuffers[1] : scene.buffers.pingpongTextures[!horizontal]);
       renderQuad(scene.quad);
       horizontal = !horizontal;
       first_iteration = false;
     }
 
     // 3. render the colour buffer to the screen with a tonemap
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    state.bindFramebuffer(GL_FRAMEBUFFER, 0);
       glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
       scene.quad.shader.use();
-      scene.quad.shader.setInt("colorBuffer", 0);
-      scene.quad.shader.setInt("blurBuffer", 1);
-      scene.quad.shader.setFloat("exposure", 0.1);
-      glActiveTexture(GL_TEXTURE0);
-      glBindTexture(GL_TEXTURE_2D, scene.buffers.colorBuffers[0]); // the original framebuffer
-      glActiveTexture(GL_TEXTURE1);
-      glBindTexture(GL_TEXTURE_2D, scene.buffers.pingpongTextures[1]); // mathematically the last one is the final blur
+      state.bindTexture(0, GL_TEXTURE_2D, scene.buffers.colorBuffers[0]); // the original framebuffer
+      state.bindTexture(1, GL_TEXTURE_2D, scene.buffers.pingpongTextures[1]); // mathematically the last one is the final blur
       renderQuad(scene.quad);
+    state.endFrame();
+    if (++frameCount % 600 == 1)
+      state.printStats();
 
     // check events and swap buffers
     glfwSwapBuffers(window);
@@ -269,7 +301,8 @@ Buffers generateBuffers() {
   glGenTextures(2, colorBuffers);
   for (unsigned int i=0; i<2; i++) {
     glBindTexture(GL_TEXTURE_2D, colorBuffers[i]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, SCREEN_WIDTH, SCREEN_HEIGHT, 0, GL_RGBA, GL_FLOAT, NULL);
+    // HDR colour never goes negative, so the packed float format holds it in half the memory of RGBA16F
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, SCREEN_WIDTH, SCREEN_HEIGHT, 0, GL_RGB, GL_FLOAT, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -298,7 +331,7 @@ Buffers generateBuffers() {
   for (unsigned int i=0; i<2; i++) {
     glBindFramebuffer(GL_FRAMEBUFFER, pingpongFBO[i]);
     glBindTexture(GL_TEXTURE_2D, pingpongTextures[i]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, SCREEN_WIDTH, SCREEN_HEIGHT, 0, GL_RGBA, GL_FLOAT, NULL);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, SCREEN_WIDTH, SCREEN_HEIGHT, 0, GL_RGB, GL_FLOAT, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -318,6 +351,37 @@ Buffers generateBuffers() {
   };
 }
 
+Uniforms generateUniforms(Shader &cube, Shader &light, Shader &hdr, Shader &blur) {
+  // samplers and the exposure never change, so they are set once here
+  cube.use();
+  cube.setInt("diffuseTexture", 0);
+  hdr.use();
+  hdr.setInt("colorBuffer", 0);
+  hdr.setInt("blurBuffer", 1);
+  hdr.setFloat("exposure", 0.1);
+
+  Uniforms uniforms = {
+    .cube = {
+      .view = cube.uniform<glm::mat4>("view"),
+      .projection = cube.uniform<glm::mat4>("projection"),
+      .model = cube.uniform<glm::mat4>("model"),
+      .viewPos = cube.uniform<glm::vec3>("viewPos"),
+    },
+    .light = {
+      .view = light.uniform<glm::mat4>("view"),
+      .projection = light.uniform<glm::mat4>("projection"),
+      .model = light.uniform<glm::mat4>("model"),
+      .lightColour = light.uniform<glm::vec3>("lightColour"),
+    },
+    .horizontal = blur.uniform<bool>("horizontal"),
+  };
+  for (int i=0; i<uniforms.cube.lights.size(); i++) {
+    string element = "lights[" + to_string(i) + "]";
+    uniforms.cube.lights[i] = { cube.uniform<glm::vec3>(element + ".position"), cube.uniform<glm::vec3>(element + ".colour") };
+  }
+  return uniforms;
+}
+
 Scene generateScene() {
   Shader lightShader = Shader(
     (string(SHADER_DIR) + "/cube-vertex.glsl").c_str(),
@@ -350,39 +414,40 @@ Scene generateScene() {
   lights[3] = { glm::vec3(-.8f,  2.4f, -1.0f), glm::vec3(0.0f,   5.0f,  0.0f) };
 
   Buffers buffers = generateBuffers();
+  Uniforms uniforms = generateUniforms(cubeShader, lightShader, hdrShader, blurShader);
 
   return {
-    .cube =  { cubeShader, cubeVAO },
-    .light = { lightShader, cubeVAO },
-    .blur = { blurShader, quadVAO },
-    .quad = { hdrShader, quadVAO },
+    .cube =  { std::move(cubeShader), cubeVAO },
+    .light = { std::move(lightShader), cubeVAO },
+    .blur = { std::move(blurShader), quadVAO },
+    .quad = { std::move(hdrShader), quadVAO },
     .textures = { wood, container },
     .lights = lights,
     .buffers = buffers,
+    .uniforms = uniforms,
   };
 }
 
-void renderCube(GameObject cube, glm::mat4 model) {
-  cube.shader.setMat4("model", model);
-  glBindVertexArray(cube.VAO);
+void renderCube(GameObject &cube, UniformHandle<glm::mat4> modelUniform, glm::mat4 model) {
+  cube.shader.set(modelUniform, model);
+  GLState::instance().bindVertexArray(cube.VAO);
   glDrawArrays(GL_TRIANGLES, 0, 36);
-  glBindVertexArray(0);
+  GLState::instance().releaseVertexArray();
 }
 
-void renderScene(Scene scene) {
+void renderScene(Scene &scene) {
   // Render Cubes
-  GameObject cube = scene.cube;
+  GameObject &cube = scene.cube;
+  const CubeUniforms &cubeUniforms = scene.uniforms.cube;
   cube.shader.use();
-  cube.shader.setMat4("view", camera.getLookAt());
-  cube.shader.setMat4("projection", camera.getPerspective());
-  cube.shader.setVec3("viewPos", camera.cameraPos);
-  cube.shader.setInt("diffuseTexture", 0);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, scene.textures.wood);
+  cube.shader.set(cubeUniforms.view, camera.getLookAt());
+  cube.shader.set(cubeUniforms.projection, camera.getPerspective());
+  cube.shader.set(cubeUniforms.viewPos, camera.cameraPos);
+  GLState::instance().bindTexture(0, GL_TEXTURE_2D, scene.textures.wood);
 
   for (int i=0; i<scene.lights.size(); i++) {
-    cube.shader.setVec3("lights[" + to_string(i) + "].position", scene.lights[i].position);
-    cube.shader.setVec3("lights[" + to_string(i) + "].colour", scene.lights[i].colour);
+    cube.shader.set(cubeUniforms.lights[i].position, scene.lights[i].position);
+    cube.shader.set(cubeUniforms.lights[i].colour, scene.lights[i].colour);
   }
   glm::mat4 model = glm::mat4(1.0);
 
@@ -390,103 +455,68 @@ void renderScene(Scene scene) {
   model = glm::mat4(1.0f);
   model = glm::translate(model, glm::vec3(0.0f, -1.0f, 0.0));
   model = glm::scale(model, glm::vec3(12.5f, 0.5f, 12.5f));
-  renderCube(cube, model);
+  renderCube(cube, cubeUniforms.model, model);
 
   // then create multiple cubes as the scenery
-  glBindTexture(GL_TEXTURE_2D, scene.textures.container);
+  GLState::instance().bindTexture(0, GL_TEXTURE_2D, scene.textures.container);
   model = glm::mat4(1.0f);
   model = glm::translate(model, glm::vec3(0.0f, 1.5f, 0.0));
   model = glm::scale(model, glm::vec3(0.5f));
-  renderCube(cube, model);
+  renderCube(cube, cubeUniforms.model, model);
 
   model = glm::mat4(1.0f);
   model = glm::translate(model, glm::vec3(2.0f, 0.0f, 1.0));
   model = glm::scale(model, glm::vec3(0.5f));
-  renderCube(cube, model);
+  renderCube(cube, cubeUniforms.model, model);
 
   model = glm::mat4(1.0f);
   model = glm::translate(model, glm::vec3(-1.0f, -1.0f, 2.0));
   model = glm::rotate(model, glm::radians(60.0f), glm::normalize(glm::vec3(1.0, 0.0, 1.0)));
-  renderCube(cube, model);
+  renderCube(cube, cubeUniforms.model, model);
 
   model = glm::mat4(1.0f);
   model = glm::translate(model, glm::vec3(0.0f, 2.7f, 4.0));
   model = glm::rotate(model, glm::radians(23.0f), glm::normalize(glm::vec3(1.0, 0.0, 1.0)));
   model = glm::scale(model, glm::vec3(1.25));
-  renderCube(cube, model);
+  renderCube(cube, cubeUniforms.model, model);
 
   model = glm::mat4(1.0f);
   model = glm::translate(model, glm::vec3(-2.0f, 1.0f, -3.0));
   model = glm::rotate(model, glm::radians(124.0f), glm::normalize(glm::vec3(1.0, 0.0, 1.0)));
-  renderCube(cube, model);
+  renderCube(cube, cubeUniforms.model, model);
 
   model = glm::mat4(1.0f);
   model = glm::translate(model, glm::vec3(-3.0f, 0.0f, 0.0));
   model = glm::scale(model, glm::vec3(0.5f));
-  renderCube(cube, model);
+  renderCube(cube, cubeUniforms.model, model);
 
-  GameObject light = scene.light;
+  GameObject &light = scene.light;
+  const LightBoxUniforms &lightUniforms = scene.uniforms.light;
   light.shader.use();
-  light.shader.setMat4("view", camera.getLookAt());
-  light.shader.setMat4("projection", camera.getPerspective());
+  light.shader.set(lightUniforms.view, camera.getLookAt());
+  light.shader.set(lightUniforms.projection, camera.getPerspective());
 
   // Render Lights
   for (int i=0; i<scene.lights.size(); i++) {
     glm::mat4 model = glm::mat4(1.0);
     model = glm::translate(model, scene.lights[i].position);
     model = glm::scale(model, glm::vec3(0.2));
-    light.shader.setVec3("lightColour", scene.lights[i].colour);
-    renderCube(light, model);
+    light.shader.set(lightUniforms.lightColour, scene.lights[i].colour);
+    renderCube(light, lightUniforms.model, model);
   }
 }
 
-void renderQuad(GameObject quad) {
-  glBindVertexArray(quad.VAO);
+void renderQuad(GameObject &quad) {
+  GLState::instance().bindVertexArray(quad.VAO);
   glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-  glBindVertexArray(0);
+  GLState::instance().releaseVertexArray();
 }
 
 /*
 * Utility function for loading a 2D texture from a file
 */
 unsigned int loadTexture(char const *path) {
-  unsigned int textureID;
-  glGenTextures(1, &textureID);
-  
-  int width, height, nrChannels;
-  std::string resourcePath = (std::string(RESOURCES_DIR) + path);
-  unsigned char *data = stbi_load(resourcePath.c_str(), &width, &height, &nrChannels, 0);
-
-  if (data) {
-    GLenum format;
-    if (nrChannels == 1)
-      format = GL_RED;
-    else if (nrChannels == 3)
-      format = GL_RGB;
-    else if (nrChannels == 4)
-      format = GL_RGBA;
-
-    // Bind and set the newly created texture
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    /*glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);*/
-    // Force to GL_SRGB
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // set the texture wrapping / filtering options
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // free the data
-    stbi_image_free(data);
-  } else {
-    std::cout << "Failed to load texture" << std::endl;
-    stbi_image_free(data);
-  }
-
-  return textureID;
+  return TextureCache::instance().acquire(std::string(RESOURCES_DIR) + path, { .srgb = true });
 }
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
@@ -4,6 +4,10 @@
 #include <learnopengl/shader.h>
 #include <learnopengl/camera.h>
 #include <learnopengl/model.h> 
+#include <learnopengl/texture_cache.h>
+#include <learnopengl/asset_streamer.h>
+#include <learnopengl/geometry_buffer.h>
+#include <learnopengl/allocation_counter.h>
 #include <glad/glad.h> 
 #include <GLFW/glfw3.h>
 #include <stbi_image.h>
@@ -42,21 +46,40 @@ struct Models {
   Model backpack;
 };
 
+// Handles resolved once the programs are built, so a frame never looks a uniform up by name
+struct LightUniforms {
+  UniformHandle<glm::vec3> position;
+  UniformHandle<glm::vec3> colour;
+};
+
+struct Uniforms {
+  vector<LightUniforms> lights; // screen
+  UniformHandle<glm::mat4> modelView;
+  UniformHandle<glm::mat4> modelProjection;
+  UniformHandle<glm::mat4> lightBoxView;
+  UniformHandle<glm::mat4> lightBoxProjection;
+  UniformHandle<glm::mat4> lightBoxModel;
+  UniformHandle<glm::vec3> lightColour;
+};
+
 struct Scene {
   Shaders shaders;
   Vertices vertices;
   Models models;
+  std::unique_ptr<GeometryBuffer> geometry; // after models, so it goes first
   Buffers buffers;
   vector<Light> lights;
   vector<glm::vec3> modelPositions;
+  Uniforms uniforms;
 };
 
 // Function Headers
 unsigned int generateCube();
 unsigned int generateQuad();
 Scene generateScene();
-void renderScene(Scene scene);
-void renderLights(Scene scene);
+Uniforms generateUniforms(Shaders &shaders, size_t lightCount);
+void renderScene(Scene &scene);
+void renderLights(Scene &scene);
 void renderCube(unsigned int cube);
 void renderQuad(unsigned int quad);
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -120,46 +143,42 @@ GLFWwindow *init() {
   return window;
 }
 
-void geometryPass(Scene scene) {
-  glBindFramebuffer(GL_FRAMEBUFFER, scene.buffers.gBuffer);
+void geometryPass(Scene &scene) {
+  GLState::instance().bindFramebuffer(GL_FRAMEBUFFER, scene.buffers.gBuffer);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   renderScene(scene);
 }
 
-void lightingPass(Scene scene) {
-  // Deferred Pass
-  Shader screen = scene.shaders.screen;
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+void lightingPass(Scene &scene) {
+  // Deferred Pass, the samplers were set when the scene was generated
+  Shader &screen = scene.shaders.screen;
+  GLState &state = GLState::instance();
+  state.bindFramebuffer(GL_FRAMEBUFFER, 0);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   screen.use();
-  screen.setInt("positionBuffer", 0);
-  screen.setInt("normalBuffer", 1);
-  screen.setInt("albedoBuffer", 2);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, scene.buffers.gPosition);
-  glActiveTexture(GL_TEXTURE1);
-  glBindTexture(GL_TEXTURE_2D, scene.buffers.gNormal);
-  glActiveTexture(GL_TEXTURE2);
-  glBindTexture(GL_TEXTURE_2D, scene.buffers.gColor);
+  state.bindTexture(0, GL_TEXTURE_2D, scene.buffers.gPosition);
+  state.bindTexture(1, GL_TEXTURE_2D, scene.buffers.gNormal);
+  state.bindTexture(2, GL_TEXTURE_2D, scene.buffers.gColor);
 
   for (int i=0; i<scene.lights.size(); ++i) {
-    screen.setVec3("lights[" + to_string(i) + "].position", scene.lights[i].position);
-    screen.setVec3("lights[" + to_string(i) + "].colour", scene.lights[i].colour);
+    screen.set(scene.uniforms.lights[i].position, scene.lights[i].position);
+    screen.set(scene.uniforms.lights[i].colour, scene.lights[i].colour);
   }
   renderQuad(scene.vertices.quad);
 }
 
-void deferredRendering(Scene scene) {
+void deferredRendering(Scene &scene) {
   geometryPass(scene);
   lightingPass(scene);
 }
 
 // NOTE: This does not support window resizing
-void forwardRendering(Scene scene) {
-  glBindFramebuffer(GL_READ_FRAMEBUFFER, scene.buffers.gBuffer);
-  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+void forwardRendering(Scene &scene) {
+  GLState &state = GLState::instance();
+  state.bindFramebuffer(GL_READ_FRAMEBUFFER, scene.buffers.gBuffer);
+  state.bindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
   glBlitFramebuffer(0, 0, windowWidth, windowHeight, 0, 0, windowWidth, windowHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  state.bindFramebuffer(GL_FRAMEBUFFER, 0);
   // Forward Rendering
   renderLights(scene);
 }
@@ -170,11 +189,18 @@ int main() {
   /*glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);*/
   glEnable(GL_DEPTH_TEST);
 
+  // The backpack streams in on the upload thread, the first frames render without it
+  AssetStreamer::instance().start(window);
   Scene scene = generateScene();
+  bool firstFrame = true;
+  bool backpackReported = false;
+  unsigned int frameCount = 0;
+  FrameAllocations allocations;
 
   // Create a render loop that swaps the front/back buffers and polls for user events
   // Necessary to prevent the window from closing instantly
   while (!glfwWindowShouldClose(window)) {
+    allocations.beginFrame();
     // delta time calculations
     float currentFrame = glfwGetTime();
     deltaTime = currentFrame - lastFrame;
@@ -183,20 +209,40 @@ int main() {
     // inputs
     processInput(window, deltaTime);
 
+    // every bind in the frame goes through GLState, so the passes only issue what changes
+    GLState &state = GLState::instance();
+    state.beginFrame();
+
     // Reset the buffer from the previous render!
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     deferredRendering(scene);
     forwardRendering(scene);
+    state.endFrame();
+    if (++frameCount % 600 == 1)
+      state.printStats();
 
     // check events and swap buffers
     glfwSwapBuffers(window);
     glfwPollEvents();
+    if (firstFrame) {
+      std::cout << "First frame after " << glfwGetTime() << "s" << std::endl;
+      firstFrame = false;
+    }
+    if (!backpackReported && scene.models.backpack.ready()) {
+      scene.geometry->printStats();
+      backpackReported = true;
+    }
+    // the streaming thread allocates too, so frames are checked once the backpack is in the pools
+    if (!backpackReported)
+      allocations.warmUp();
+    allocations.endFrame();
   }
 
+  AssetStreamer::instance().stop();
   // Terminate and clean up all resources glfwTerminate();
-  return 0;
+  return allocations.steadyAllocations() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 Buffers generateBuffers() {
@@ -259,18 +305,21 @@ Shaders generateShaders() {
     (string(SHADER_DIR) + "/light-vertex.glsl").c_str(),
     (string(SHADER_DIR) + "/light-fragment.glsl").c_str()
   );
-  Shader model = Shader(
-    (string(SHADER_DIR) + "/model-vertex.glsl").c_str(),
-    (string(SHADER_DIR) + "/model-fragment.glsl").c_str()
-  );
+  // transforms come from the geometry buffer's per draw data instead of uniforms
+  Shader model = Shader({
+    string(SHADER_DIR) + "/model-vertex.glsl",
+    string(SHADER_DIR) + "/model-fragment.glsl",
+    "",
+    { { "MULTI_DRAW", "1" } },
+  });
   Shader screen = Shader(
     (string(SHADER_DIR) + "/screen-vertex.glsl").c_str(),
     (string(SHADER_DIR) + "/screen-fragment.glsl").c_str()
   );
   return { 
-    .lightBox = lightBox, 
-    .model = model, 
-    .screen = screen
+    .lightBox = std::move(lightBox), 
+    .model = std::move(model), 
+    .screen = std::move(screen)
   };
 }
 
@@ -281,8 +330,8 @@ Vertices generateVertices() {
 }
 
 Models generateModels() {
-  Model backpack = Model("/objects/backpack/backpack.obj");
-  return { backpack };
+  Model backpack = Model("/objects/backpack/backpack.obj", { .vertexFormat = VertexFormat::Packed, .async = true });
+  return { std::move(backpack) };
 }
 
 Scene generateScene() {
@@ -318,88 +367,81 @@ Scene generateScene() {
   modelPositions.push_back(glm::vec3( 0.0,  -0.5,  3.0));
   modelPositions.push_back(glm::vec3( 3.0,  -0.5,  3.0));
 
-  return {
+  Scene scene = {
     .shaders = generateShaders(),
     .vertices = generateVertices(),
     .models = generateModels(),
+    .geometry = std::make_unique<GeometryBuffer>(),
     .buffers = generateBuffers(),
     .lights = lights,
     .modelPositions = modelPositions,
   };
+  scene.uniforms = generateUniforms(scene.shaders, scene.lights.size());
+  return scene;
+}
+
+Uniforms generateUniforms(Shaders &shaders, size_t lightCount) {
+  // the G-buffer always sits on the same units
+  Shader &screen = shaders.screen;
+  screen.use();
+  screen.setInt("positionBuffer", 0);
+  screen.setInt("normalBuffer", 1);
+  screen.setInt("albedoBuffer", 2);
+
+  Uniforms uniforms = {
+    .modelView = shaders.model.uniform<glm::mat4>("view"),
+    .modelProjection = shaders.model.uniform<glm::mat4>("projection"),
+    .lightBoxView = shaders.lightBox.uniform<glm::mat4>("view"),
+    .lightBoxProjection = shaders.lightBox.uniform<glm::mat4>("projection"),
+    .lightBoxModel = shaders.lightBox.uniform<glm::mat4>("model"),
+    .lightColour = shaders.lightBox.uniform<glm::vec3>("lightColour"),
+  };
+  for (size_t i = 0; i < lightCount; ++i) {
+    string light = "lights[" + to_string(i) + "]";
+    uniforms.lights.push_back({ screen.uniform<glm::vec3>(light + ".position"), screen.uniform<glm::vec3>(light + ".colour") });
+  }
+  return uniforms;
 }
 
-void renderLights(Scene scene) {
+void renderLights(Scene &scene) {
   // render lights
-  Shader lightBox = scene.shaders.lightBox;
+  Shader &lightBox = scene.shaders.lightBox;
   lightBox.use();
-  lightBox.setMat4("view", camera.getLookAt());
-  lightBox.setMat4("projection", camera.getPerspective());
+  lightBox.set(scene.uniforms.lightBoxView, camera.getLookAt());
+  lightBox.set(scene.uniforms.lightBoxProjection, camera.getPerspective());
   for (int i=0; i<scene.lights.size(); i++) {
     glm::mat4 model = glm::mat4(1.0);
     model = glm::translate(model, scene.lights[i].position);
     model = glm::scale(model, glm::vec3(0.2));
-    lightBox.setVec3("lightColour", scene.lights[i].colour);
-    lightBox.setMat4("model", model);
+    lightBox.set(scene.uniforms.lightColour, scene.lights[i].colour);
+    lightBox.set(scene.uniforms.lightBoxModel, model);
     renderCube(scene.vertices.cube);
   }
 }
 
-void renderScene(Scene scene) {
+void renderScene(Scene &scene) {
   // render models
-  Shader modelShader = scene.shaders.model;
+  Shader &modelShader = scene.shaders.model;
   modelShader.use();
-  modelShader.setMat4("view", camera.getLookAt());
-  modelShader.setMat4("projection", camera.getPerspective());
+  modelShader.set(scene.uniforms.modelView, camera.getLookAt());
+  modelShader.set(scene.uniforms.modelProjection, camera.getPerspective());
+  // every backpack goes out in one batch per material
+  GeometryBuffer &geometry = *scene.geometry;
+  geometry.clear();
   for (int i=0; i<scene.modelPositions.size(); i++) {
     glm::mat4 model = glm::mat4(1.0);
     model = glm::translate(model, scene.modelPositions[i]);
     model = glm::scale(model, glm::vec3(0.2));
-    modelShader.setMat4("model", model);
-    scene.models.backpack.draw(modelShader);
+    geometry.submit(scene.models.backpack, model);
   }
+  geometry.draw(modelShader);
 }
 
 /*
 * Utility function for loading a 2D texture from a file
 */
 unsigned int loadTexture(char const *path) {
-  unsigned int textureID;
-  glGenTextures(1, &textureID);
-  
-  int width, height, nrChannels;
-  std::string resourcePath = (std::string(RESOURCES_DIR) + path);
-  unsigned char *data = stbi_load(resourcePath.c_str(), &width, &height, &nrChannels, 0);
-
-  if (data) {
-    GLenum format;
-    if (nrChannels == 1)
-      format = GL_RED;
-    else if (nrChannels == 3)
-      format = GL_RGB;
-    else if (nrChannels == 4)
-      format = GL_RGBA;
-
-    // Bind and set the newly created texture
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    /*glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);*/
-    // Force to GL_SRGB
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // set the texture wrapping / filtering options
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // free the data
-    stbi_image_free(data);
-  } else {
-    std::cout << "Failed to load texture" << std::endl;
-    stbi_image_free(data);
-  }
-
-  return textureID;
+  return TextureCache::instance().acquire(std::string(RESOURCES_DIR) + path, { .srgb = true });
 }
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
@@ -527,14 +569,14 @@ unsigned int generateQuad() {
 }
 
 void renderQuad(unsigned int quad) {
-  glBindVertexArray(quad);
+  GLState::instance().bindVertexArray(quad);
   glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-  glBindVertexArray(0);
+  GLState::instance().releaseVertexArray();
 }
 
 void renderCube(unsigned int cube) {
-  glBindVertexArray(cube);
+  GLState::instance().bindVertexArray(cube);
   glDrawArrays(GL_TRIANGLES, 0, 36);
-  glBindVertexArray(0);
+  GLState::instance().releaseVertexArray();
 }
 
@@ -0,0 +1,6 @@
+// CameraBlock in uniform_buffer.h, written once a frame for every program
+layout (std140) uniform Camera {
+  mat4 view;
+  mat4 projection;
+  vec4 cameraPosition;
+};
@@ -2,6 +2,9 @@
 #include <learnopengl/shader.h>
 #include <learnopengl/camera.h>
 #include <learnopengl/model.h> 
+#include <learnopengl/texture_cache.h>
+#include <learnopengl/uniform_buffer.h>
+#include <learnopengl/allocation_counter.h>
 #include <glad/glad.h> 
 #include <GLFW/glfw3.h>
 #include <stbi_image.h>
@@ -13,11 +16,16 @@ struct GameObject {
   unsigned int VAO;
 };
 
+// One element of the Lights block in screen-fragment.glsl
 struct Light {
-  vec3 position;
-  vec3 colour;
+  alignas(16) vec3 position;
+  alignas(16) vec3 colour;
   float radius;
 };
+STD140_OFFSET(Light, position, 0);
+STD140_OFFSET(Light, colour, 16);
+STD140_OFFSET(Light, radius, 28);
+STD140_SIZE(Light, 32);
 
 struct Buffers {
   unsigned int gBuffer;
@@ -29,7 +37,7 @@ struct Buffers {
 struct Shaders {
   Shader lightBox;
   Shader model;
-  Shader screen;
+  ShaderVariants screen; // one variant per light count
 };
 
 struct Vertices {
@@ -41,6 +49,14 @@ struct Models {
   Model backpack;
 };
 
+// Resolved once the programs are built, so a frame never builds a string to find a uniform
+struct Uniforms {
+  Shader *screen; // the screen variant for this light count
+  UniformHandle<glm::mat4> model;
+  UniformHandle<glm::vec3> lightColour;
+  UniformHandle<glm::mat4> lightModel;
+};
+
 struct Scene {
   Shaders shaders;
   Vertices vertices;
@@ -48,14 +64,17 @@ struct Scene {
   Buffers buffers;
   vector<Light> lights;
   vector<glm::vec3> modelPositions;
+  std::unique_ptr<UniformRing> uniforms;
+  Uniforms handles;
 };
 
 // Function Headers
 unsigned int generateCube();
 unsigned int generateQuad();
 Scene generateScene();
-void renderScene(Scene scene);
-void renderLights(Scene scene);
+Uniforms generateUniforms(Scene &scene);
+void renderScene(Scene &scene);
+void renderLights(Scene &scene);
 void renderCube(unsigned int cube);
 void renderQuad(unsigned int quad);
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -119,47 +138,37 @@ GLFWwindow *init() {
   return window;
 }
 
-void geometryPass(Scene scene) {
-  glBindFramebuffer(GL_FRAMEBUFFER, scene.buffers.gBuffer);
+void geometryPass(Scene &scene) {
+  GLState::instance().bindFramebuffer(GL_FRAMEBUFFER, scene.buffers.gBuffer);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   renderScene(scene);
 }
 
-void lightingPass(Scene scene) {
-  // Deferred Pass
-  Shader screen = scene.shaders.screen;
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+void lightingPass(Scene &scene) {
+  // Deferred Pass, the screen variant already has its samplers set
+  GLState &state = GLState::instance();
+  state.bindFramebuffer(GL_FRAMEBUFFER, 0);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  screen.use();
-  screen.setInt("positionBuffer", 0);
-  screen.setInt("normalBuffer", 1);
-  screen.setInt("albedoBuffer", 2);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, scene.buffers.gPosition);
-  glActiveTexture(GL_TEXTURE1);
-  glBindTexture(GL_TEXTURE_2D, scene.buffers.gNormal);
-  glActiveTexture(GL_TEXTURE2);
-  glBindTexture(GL_TEXTURE_2D, scene.buffers.gColor);
-
-  for (int i=0; i<scene.lights.size(); ++i) {
-    screen.setVec3("lights[" + to_string(i) + "].position", scene.lights[i].position);
-    screen.setVec3("lights[" + to_string(i) + "].colour", scene.lights[i].colour);
-    screen.setFloat("lights[" + to_string(i) + "].radius", scene.lights[i].radius);
-  }
+  scene.handles.screen->use();
+  state.bindTexture(0, GL_TEXTURE_2D, scene.buffers.gPosition);
+  state.bindTexture(1, GL_TEXTURE_2D, scene.buffers.gNormal);
+  state.bindTexture(2, GL_TEXTURE_2D, scene.buffers.gColor);
+
   renderQuad(scene.vertices.quad);
 }
 
-void deferredRendering(Scene scene) {
+void deferredRendering(Scene &scene) {
   geometryPass(scene);
   lightingPass(scene);
 }
 
 // NOTE: This does not support window resizing
-void forwardRendering(Scene scene) {
-  glBindFramebuffer(GL_READ_FRAMEBUFFER, scene.buffers.gBuffer);
-  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+void forwardRendering(Scene &scene) {
+  GLState &state = GLState::instance();
+  state.bindFramebuffer(GL_READ_FRAMEBUFFER, scene.buffers.gBuffer);
+  state.bindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
   glBlitFramebuffer(0, 0, windowWidth, windowHeight, 0, 0, windowWidth, windowHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  state.bindFramebuffer(GL_FRAMEBUFFER, 0);
   // Forward Rendering
   renderLights(scene);
 }
@@ -171,11 +180,14 @@ int main() {
   glEnable(GL_DEPTH_TEST);
 
   Scene scene = generateScene();
+  unsigned int frameCount = 0;
+  FrameAllocations allocations;
 
   // Create a render loop that swaps the front/back buffers and polls for user events
   // Necessary to prevent the window from closing instantly
   while (!glfwWindowShouldClose(window)) {
     // delta time calculations
+    allocations.beginFrame();
     float currentFrame = glfwGetTime();
     deltaTime = currentFrame - lastFrame;
     lastFrame = currentFrame;
@@ -183,20 +195,34 @@ int main() {
     // inputs
     processInput(window, deltaTime);
 
+    // every bind in the frame goes through GLState, so the passes only issue what changes
+    GLState &state = GLState::instance();
+    state.beginFrame();
+
     // Reset the buffer from the previous render!
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // camera and lights are written once and read by every program this frame
+    scene.uniforms->beginFrame();
+    scene.uniforms->write(CameraBlock { camera.getLookAt(), camera.getPerspective(), glm::vec4(camera.cameraPos, 1.0f) });
+    scene.uniforms->writeArray("Lights", scene.lights);
+
     deferredRendering(scene);
     forwardRendering(scene);
+    scene.uniforms->endFrame();
+    state.endFrame();
+    if (++frameCount % 600 == 1)
+      state.printStats();
 
     // check events and swap buffers
     glfwSwapBuffers(window);
     glfwPollEvents();
+    allocations.endFrame();
   }
 
   // Terminate and clean up all resources glfwTerminate();
-  return 0;
+  return allocations.steadyAllocations() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 Buffers generateBuffers() {
@@ -263,14 +289,14 @@ Shaders generateShaders() {
     (string(SHADER_DIR) + "/model-vertex.glsl").c_str(),
     (string(SHADER_DIR) + "/model-fragment.glsl").c_str()
   );
-  Shader screen = Shader(
-    (string(SHADER_DIR) + "/screen-vertex.glsl").c_str(),
-    (string(SHADER_DIR) + "/screen-fragment.glsl").c_str()
-  );
+  ShaderVariants screen = ShaderVariants({
+    string(SHADER_DIR) + "/screen-vertex.glsl",
+    string(SHADER_DIR) + "/screen-fragment.glsl",
+  });
   return { 
-    .lightBox = lightBox, 
-    .model = model, 
-    .screen = screen
+    .lightBox = std::move(lightBox), 
+    .model = std::move(model), 
+    .screen = std::move(screen)
   };
 }
 
@@ -281,8 +307,8 @@ Vertices generateVertices() {
 }
 
 Models generateModels() {
-  Model backpack = Model("/objects/backpack/backpack.obj");
-  return { backpack };
+  Model backpack = Model("/objects/backpack/backpack.obj", { .vertexFormat = VertexFormat::Packed });
+  return { std::move(backpack) };
 }
 
 Scene generateScene() {
@@ -326,43 +352,58 @@ Scene generateScene() {
   modelPositions.push_back(glm::vec3( 0.0,  -0.5,  3.0));
   modelPositions.push_back(glm::vec3( 3.0,  -0.5,  3.0));
 
-  return {
+  Scene scene = {
     .shaders = generateShaders(),
     .vertices = generateVertices(),
     .models = generateModels(),
     .buffers = generateBuffers(),
     .lights = lights,
     .modelPositions = modelPositions,
+    .uniforms = std::make_unique<UniformRing>(16 * 1024),
   };
+  scene.handles = generateUniforms(scene);
+  return scene;
 }
 
-void renderLights(Scene scene) {
+Uniforms generateUniforms(Scene &scene) {
+  // specialised for the number of lights so the loop has a constant bound
+  Shader &screen = scene.shaders.screen.get({ { "NUM_LIGHTS", to_string(scene.lights.size()) } });
+  screen.use();
+  screen.setInt("positionBuffer", 0);
+  screen.setInt("normalBuffer", 1);
+  screen.setInt("albedoBuffer", 2);
+
+  return {
+    .screen = &screen,
+    .model = scene.shaders.model.uniform<glm::mat4>("model"),
+    .lightColour = scene.shaders.lightBox.uniform<glm::vec3>("lightColour"),
+    .lightModel = scene.shaders.lightBox.uniform<glm::mat4>("model"),
+  };
+}
+
+void renderLights(Scene &scene) {
   // render lights
-  Shader lightBox = scene.shaders.lightBox;
+  Shader &lightBox = scene.shaders.lightBox;
   lightBox.use();
-  lightBox.setMat4("view", camera.getLookAt());
-  lightBox.setMat4("projection", camera.getPerspective());
   for (int i=0; i<scene.lights.size(); i++) {
     glm::mat4 model = glm::mat4(1.0);
     model = glm::translate(model, scene.lights[i].position);
     model = glm::scale(model, glm::vec3(0.2));
-    lightBox.setVec3("lightColour", scene.lights[i].colour);
-    lightBox.setMat4("model", model);
+    lightBox.set(scene.handles.lightColour, scene.lights[i].colour);
+    lightBox.set(scene.handles.lightModel, model);
     renderCube(scene.vertices.cube);
   }
 }
 
-void renderScene(Scene scene) {
+void renderScene(Scene &scene) {
   // render models
-  Shader modelShader = scene.shaders.model;
+  Shader &modelShader = scene.shaders.model;
   modelShader.use();
-  modelShader.setMat4("view", camera.getLookAt());
-  modelShader.setMat4("projection", camera.getPerspective());
   for (int i=0; i<scene.modelPositions.size(); i++) {
     glm::mat4 model = glm::mat4(1.0);
     model = glm::translate(model, scene.modelPositions[i]);
     model = glm::scale(model, glm::vec3(0.2));
-    modelShader.setMat4("model", model);
+    modelShader.set(scene.handles.model, model);
     scene.models.backpack.draw(modelShader);
   }
 }
@@ -371,43 +412,7 @@ void renderScene(Scene scene) {
 * Utility function for loading a 2D texture from a file
 */
 unsigned int loadTexture(char const *path) {
-  unsigned int textureID;
-  glGenTextures(1, &textureID);
-  
-  int width, height, nrChannels;
-  std::string resourcePath = (std::string(RESOURCES_DIR) + path);
-  unsigned char *data = stbi_load(resourcePath.c_str(), &width, &height, &nrChannels, 0);
-
-  if (data) {
-    GLenum format;
-    if (nrChannels == 1)
-      format = GL_RED;
-    else if (nrChannels == 3)
-      format = GL_RGB;
-    else if (nrChannels == 4)
-      format = GL_RGBA;
-
-    // Bind and set the newly created texture
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    /*glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);*/
-    // Force to GL_SRGB
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // set the texture wrapping / filtering options
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // free the data
-    stbi_image_free(data);
-  } else {
-    std::cout << "Failed to load texture" << std::endl;
-    stbi_image_free(data);
-  }
-
-  return textureID;
+  return TextureCache::instance().acquire(std::string(RESOURCES_DIR) + path, { .srgb = true });
 }
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
@@ -535,14 +540,14 @@ unsigned int generateQuad() {
 }
 
 void renderQuad(unsigned int quad) {
-  glBindVertexArray(quad);
+  GLState::instance().bindVertexArray(quad);
   glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-  glBindVertexArray(0);
+  GLState::instance().releaseVertexArray();
 }
 
 void renderCube(unsigned int cube) {
-  glBindVertexArray(cube);
+  GLState::instance().bindVertexArray(cube);
   glDrawArrays(GL_TRIANGLES, 0, 36);
-  glBindVertexArray(0);
+  GLState::instance().releaseVertexArray();
 }
 
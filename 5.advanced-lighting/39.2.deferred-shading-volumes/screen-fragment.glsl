@@ -14,8 +14,13 @@ struct Light {
   float radius;
 };
 
-const int NUM_LIGHTS = 32;
-uniform Light lights[NUM_LIGHTS];
+// injected by the application with the scene's exact light count
+#ifndef NUM_LIGHTS
+#define NUM_LIGHTS 32
+#endif
+layout (std140) uniform Lights {
+  Light lights[NUM_LIGHTS];
+};
 
 void main() {
   vec3 position = texture(positionBuffer, texCoords).rgb;
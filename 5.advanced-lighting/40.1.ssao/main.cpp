@@ -2,6 +2,9 @@
 #include <learnopengl/shader.h>
 #include <learnopengl/camera.h>
 #include <learnopengl/model.h> 
+#include <learnopengl/texture_cache.h>
+#include <learnopengl/uniform_buffer.h>
+#include <learnopengl/allocation_counter.h>
 #include <glad/glad.h> 
 #include <GLFW/glfw3.h>
 #include <stbi_image.h>
@@ -44,10 +47,18 @@ struct Models {
   Model backpack;
 };
 
+// layout (std140) uniform Kernel in ssao-fragment.glsl, w unused
+struct KernelBlock {
+  static constexpr const char *NAME = "Kernel";
+  glm::vec4 samples[64];
+};
+STD140_OFFSET(KernelBlock, samples, 0);
+STD140_SIZE(KernelBlock, 1024);
+
 struct SSAO {
   unsigned int ssaoBuffer;
   unsigned int ssaoTexture;
-  vector<glm::vec3> kernel;
+  KernelBlock kernel;
   unsigned int noiseTexture;
 };
 
@@ -56,6 +67,16 @@ struct Blur {
   unsigned int texture;
 };
 
+// Handles resolved once the programs are built, so a frame never looks a uniform up by name
+struct Uniforms {
+  UniformHandle<glm::mat4> model;
+  UniformHandle<bool> invertedNormals;
+  UniformHandle<glm::vec3> lightPosition;
+  UniformHandle<glm::vec3> lightColour;
+  UniformHandle<float> lightLinear;
+  UniformHandle<float> lightQuadratic;
+};
+
 struct Scene {
   Light light;
   Shaders shaders;
@@ -64,13 +85,16 @@ struct Scene {
   GBuffer buffers;
   SSAO ssao;
   Blur blur;
+  std::unique_ptr<UniformRing> uniforms;
+  Uniforms handles;
 };
 
 // Function Headers
 unsigned int generateCube();
 unsigned int generateQuad();
 Scene generateScene();
-void renderScene(Scene scene);
+Uniforms generateUniforms(Shaders &shaders);
+void renderScene(Scene &scene);
 void renderCube(unsigned int cube);
 void renderQuad(unsigned int quad);
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -134,75 +158,57 @@ GLFWwindow *init() {
   return window;
 }
 
-void geometryPass(Scene scene) {
-  glBindFramebuffer(GL_FRAMEBUFFER, scene.buffers.gBuffer);
+void geometryPass(Scene &scene) {
+  GLState::instance().bindFramebuffer(GL_FRAMEBUFFER, scene.buffers.gBuffer);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   renderScene(scene);
 }
 
-void ssaoPass(Scene scene) {
-  Shader ssao = scene.shaders.ssao;
-  glBindFramebuffer(GL_FRAMEBUFFER, scene.ssao.ssaoBuffer);
+void ssaoPass(Scene &scene) {
+  Shader &ssao = scene.shaders.ssao;
+  GLState &state = GLState::instance();
+  state.bindFramebuffer(GL_FRAMEBUFFER, scene.ssao.ssaoBuffer);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   ssao.use();
-  ssao.setInt("positionBuffer", 0);
-  ssao.setInt("normalBuffer", 1);
-  ssao.setInt("noiseBuffer", 2);
-  ssao.setMat4("projection", camera.getPerspective());
-
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, scene.buffers.gPosition);
-  glActiveTexture(GL_TEXTURE1);
-  glBindTexture(GL_TEXTURE_2D, scene.buffers.gNormal);
-  glActiveTexture(GL_TEXTURE2);
-  glBindTexture(GL_TEXTURE_2D, scene.ssao.noiseTexture);
-
-  // Send kernel data
-  for (unsigned int i=0; i<scene.ssao.kernel.size(); ++i)
-    ssao.setVec3("samples[" + to_string(i) + "]", scene.ssao.kernel[i]);
+
+  state.bindTexture(0, GL_TEXTURE_2D, scene.buffers.gPosition);
+  state.bindTexture(1, GL_TEXTURE_2D, scene.buffers.gNormal);
+  state.bindTexture(2, GL_TEXTURE_2D, scene.ssao.noiseTexture);
 
   renderQuad(scene.vertices.quad);
 }
 
-void blurPass(Scene scene) {
-  Shader blur = scene.shaders.blur;
-  glBindFramebuffer(GL_FRAMEBUFFER, scene.blur.buffer);
+void blurPass(Scene &scene) {
+  Shader &blur = scene.shaders.blur;
+  GLState &state = GLState::instance();
+  state.bindFramebuffer(GL_FRAMEBUFFER, scene.blur.buffer);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   blur.use();
-  blur.setInt("ssaoInput", 0);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, scene.ssao.ssaoTexture);
+  state.bindTexture(0, GL_TEXTURE_2D, scene.ssao.ssaoTexture);
   renderQuad(scene.vertices.quad);
 }
 
-void lightingPass(Scene scene) {
+void lightingPass(Scene &scene) {
   // Deferred Pass
-  Shader screen = scene.shaders.screen;
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  Shader &screen = scene.shaders.screen;
+  GLState &state = GLState::instance();
+  state.bindFramebuffer(GL_FRAMEBUFFER, 0);
   glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   screen.use();
-  screen.setInt("positionBuffer", 0);
-  screen.setInt("normalBuffer", 1);
-  screen.setInt("albedoBuffer", 2);
-  screen.setInt("ssaoBuffer", 3);
-  screen.setVec3("light.position", scene.light.position);
-  screen.setVec3("light.colour", scene.light.colour);
-  screen.setFloat("light.linear", scene.light.linear);
-  screen.setFloat("light.quadratic", scene.light.quadratic);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, scene.buffers.gPosition);
-  glActiveTexture(GL_TEXTURE1);
-  glBindTexture(GL_TEXTURE_2D, scene.buffers.gNormal);
-  glActiveTexture(GL_TEXTURE2);
-  glBindTexture(GL_TEXTURE_2D, scene.buffers.gColor);
-  glActiveTexture(GL_TEXTURE3);
-  glBindTexture(GL_TEXTURE_2D, scene.ssao.ssaoTexture);
+  screen.set(scene.handles.lightPosition, scene.light.position);
+  screen.set(scene.handles.lightColour, scene.light.colour);
+  screen.set(scene.handles.lightLinear, scene.light.linear);
+  screen.set(scene.handles.lightQuadratic, scene.light.quadratic);
+  state.bindTexture(0, GL_TEXTURE_2D, scene.buffers.gPosition);
+  state.bindTexture(1, GL_TEXTURE_2D, scene.buffers.gNormal);
+  state.bindTexture(2, GL_TEXTURE_2D, scene.buffers.gColor);
+  state.bindTexture(3, GL_TEXTURE_2D, scene.ssao.ssaoTexture);
 
   renderQuad(scene.vertices.quad);
 }
 
-void deferredRendering(Scene scene) {
+void deferredRendering(Scene &scene) {
   geometryPass(scene);
   ssaoPass(scene);
   blurPass(scene);
@@ -216,10 +222,13 @@ int main() {
   glEnable(GL_DEPTH_TEST);
 
   Scene scene = generateScene();
+  unsigned int frameCount = 0;
+  FrameAllocations allocations;
 
   // Create a render loop that swaps the front/back buffers and polls for user events
   // Necessary to prevent the window from closing instantly
   while (!glfwWindowShouldClose(window)) {
+    allocations.beginFrame();
     // delta time calculations
     float currentFrame = glfwGetTime();
     deltaTime = currentFrame - lastFrame;
@@ -228,20 +237,34 @@ int main() {
     // inputs
     processInput(window, deltaTime);
 
+    // every bind in the frame goes through GLState, so the passes only issue what changes
+    GLState &state = GLState::instance();
+    state.beginFrame();
+
     // Reset the buffer from the previous render!
     glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // camera and kernel are written once and read by every program this frame
+    scene.uniforms->beginFrame();
+    scene.uniforms->write(CameraBlock { camera.getLookAt(), camera.getPerspective(), glm::vec4(camera.cameraPos, 1.0f) });
+    scene.uniforms->write(scene.ssao.kernel);
+
     deferredRendering(scene);
+    scene.uniforms->endFrame();
+    state.endFrame();
+    if (++frameCount % 600 == 1)
+      state.printStats();
 
     // check events and swap buffers
     glfwSwapBuffers(window);
     glfwPollEvents();
+    allocations.endFrame();
   }
 
   // Terminate and clean up all resources glfwTerminate();
   glfwTerminate();
-  return 0;
+  return allocations.steadyAllocations() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 GBuffer generateBuffers() {
@@ -302,27 +325,19 @@ GBuffer generateBuffers() {
 }
 
 Shaders generateShaders() {
-  Shader geometry = Shader(
-    (string(SHADER_DIR) + "/geometry-pass-vertex.glsl").c_str(),
-    (string(SHADER_DIR) + "/geometry-pass-fragment.glsl").c_str()
-  );
-  Shader ssao = Shader(
-    (string(SHADER_DIR) + "/ssao-vertex.glsl").c_str(),
-    (string(SHADER_DIR) + "/ssao-fragment.glsl").c_str()
-  );
-  Shader blur = Shader(
-    (string(SHADER_DIR) + "/blur-vertex.glsl").c_str(),
-    (string(SHADER_DIR) + "/blur-fragment.glsl").c_str()
-  );
-  Shader screen = Shader(
-    (string(SHADER_DIR) + "/screen-vertex.glsl").c_str(),
-    (string(SHADER_DIR) + "/screen-fragment.glsl").c_str()
-  );
+  // compiled together so the driver can overlap them, or loaded from the program cache
+  vector<Shader> shaders = Shader::compileAll({
+    { string(SHADER_DIR) + "/geometry-pass-vertex.glsl", string(SHADER_DIR) + "/geometry-pass-fragment.glsl" },
+    { string(SHADER_DIR) + "/ssao-vertex.glsl", string(SHADER_DIR) + "/ssao-fragment.glsl" },
+    { string(SHADER_DIR) + "/blur-vertex.glsl", string(SHADER_DIR) + "/blur-fragment.glsl" },
+    { string(SHADER_DIR) + "/screen-vertex.glsl", string(SHADER_DIR) + "/screen-fragment.glsl" },
+  });
+  ProgramCache::instance().printStats();
   return { 
-    .geometry = geometry,
-    .screen = screen,
-    .ssao = ssao,
-    .blur = blur,
+    .geometry = std::move(shaders[0]),
+    .screen = std::move(shaders[3]),
+    .ssao = std::move(shaders[1]),
+    .blur = std::move(shaders[2]),
   };
 }
 
@@ -334,7 +349,7 @@ Vertices generateVertices() {
 
 Models generateModels() {
   Model backpack = Model("/objects/backpack/backpack.obj");
-  return { backpack };
+  return { std::move(backpack) };
 }
 
 float lerpFloat(float a, float b, float f) {
@@ -344,7 +359,7 @@ float lerpFloat(float a, float b, float f) {
 SSAO generateSSAO() {
   uniform_real_distribution<float> randomFloats(0.0, 1.0);
   default_random_engine generator;
-  vector<glm::vec3> kernel;
+  KernelBlock kernel;
   for (unsigned int i=0; i<64; ++i) {
     glm::vec3 sample(
       randomFloats(generator) * 2.0 - 1.0,
@@ -356,7 +371,7 @@ SSAO generateSSAO() {
     float scale = (float)i / 64.0;
     scale = lerpFloat(0.1f, 1.0f, scale * scale);
     sample *= scale;
-    kernel.push_back(sample);
+    kernel.samples[i] = glm::vec4(sample, 0.0f);
   }
 
   vector<glm::vec3> noises;
@@ -435,7 +450,7 @@ Scene generateScene() {
     .quadratic = 0.032,
   };
 
-  return {
+  Scene scene = {
     .light = light,
     .shaders = generateShaders(),
     .vertices = generateVertices(),
@@ -443,31 +458,56 @@ Scene generateScene() {
     .buffers = generateBuffers(),
     .ssao = generateSSAO(),
     .blur = generateBlur(),
+    .uniforms = std::make_unique<UniformRing>(16 * 1024),
   };
+  scene.handles = generateUniforms(scene.shaders);
+  return scene;
 }
 
-void renderScene(Scene scene) {
-  Shader geometryPass = scene.shaders.geometry;
+Uniforms generateUniforms(Shaders &shaders) {
+  // every pass samples the same units, so the samplers are set once
+  shaders.ssao.use();
+  shaders.ssao.setInt("positionBuffer", 0);
+  shaders.ssao.setInt("normalBuffer", 1);
+  shaders.ssao.setInt("noiseBuffer", 2);
+  shaders.blur.use();
+  shaders.blur.setInt("ssaoInput", 0);
+  shaders.screen.use();
+  shaders.screen.setInt("positionBuffer", 0);
+  shaders.screen.setInt("normalBuffer", 1);
+  shaders.screen.setInt("albedoBuffer", 2);
+  shaders.screen.setInt("ssaoBuffer", 3);
+
+  return {
+    .model = shaders.geometry.uniform<glm::mat4>("model"),
+    .invertedNormals = shaders.geometry.uniform<bool>("invertedNormals"),
+    .lightPosition = shaders.screen.uniform<glm::vec3>("light.position"),
+    .lightColour = shaders.screen.uniform<glm::vec3>("light.colour"),
+    .lightLinear = shaders.screen.uniform<float>("light.linear"),
+    .lightQuadratic = shaders.screen.uniform<float>("light.quadratic"),
+  };
+}
+
+void renderScene(Scene &scene) {
+  Shader &geometryPass = scene.shaders.geometry;
   geometryPass.use();
-  geometryPass.setMat4("view", camera.getLookAt());
-  geometryPass.setMat4("projection", camera.getPerspective());
   glm::mat4 model = glm::mat4(1.0f);
 
   // render room cube
   model = glm::mat4(1.0f);
   model = glm::translate(model, glm::vec3(0.0, 7.0f, 0.0f));
   model = glm::scale(model, glm::vec3(7.5f, 7.5f, 7.5f));
-  geometryPass.setMat4("model", model);
-  geometryPass.setBool("invertedNormals", true); // invert normals as we're inside the cube
+  geometryPass.set(scene.handles.model, model);
+  geometryPass.set(scene.handles.invertedNormals, true); // invert normals as we're inside the cube
   renderCube(scene.vertices.cube);
-  geometryPass.setBool("invertedNormals", false); 
+  geometryPass.set(scene.handles.invertedNormals, false);
 
   // render backpack
   model = glm::mat4(1.0f);
   model = glm::translate(model, glm::vec3(0.0f, 0.5f, 0.0));
   model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(1.0, 0.0, 0.0));
   model = glm::scale(model, glm::vec3(1.0f));
-  geometryPass.setMat4("model", model);
+  geometryPass.set(scene.handles.model, model);
   scene.models.backpack.draw(geometryPass);
 }
 
@@ -475,43 +515,7 @@ void renderScene(Scene scene) {
 * Utility function for loading a 2D texture from a file
 */
 unsigned int loadTexture(char const *path) {
-  unsigned int textureID;
-  glGenTextures(1, &textureID);
-  
-  int width, height, nrChannels;
-  std::string resourcePath = (std::string(RESOURCES_DIR) + path);
-  unsigned char *data = stbi_load(resourcePath.c_str(), &width, &height, &nrChannels, 0);
-
-  if (data) {
-    GLenum format;
-    if (nrChannels == 1)
-      format = GL_RED;
-    else if (nrChannels == 3)
-      format = GL_RGB;
-    else if (nrChannels == 4)
-      format = GL_RGBA;
-
-    // Bind and set the newly created texture
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    /*glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);*/
-    // Force to GL_SRGB
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // set the texture wrapping / filtering options
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // free the data
-    stbi_image_free(data);
-  } else {
-    std::cout << "Failed to load texture" << std::endl;
-    stbi_image_free(data);
-  }
-
-  return textureID;
+  return TextureCache::instance().acquire(std::string(RESOURCES_DIR) + path, { .srgb = true });
 }
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
@@ -639,14 +643,14 @@ unsigned int generateQuad() {
 }
 
 void renderQuad(unsigned int quad) {
-  glBindVertexArray(quad);
+  GLState::instance().bindVertexArray(quad);
   glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-  glBindVertexArray(0);
+  GLState::instance().releaseVertexArray();
 }
 
 void renderCube(unsigned int cube) {
-  glBindVertexArray(cube);
+  GLState::instance().bindVertexArray(cube);
   glDrawArrays(GL_TRIANGLES, 0, 36);
-  glBindVertexArray(0);
+  GLState::instance().releaseVertexArray();
 }
 
@@ -8,8 +8,12 @@ uniform sampler2D noiseBuffer;
 
 out float FragColor;
 
-uniform vec3 samples[64];
-uniform mat4 projection;
+// KernelBlock in main.cpp, array elements are padded to 16 bytes either way
+layout (std140) uniform Kernel {
+  vec3 samples[64];
+};
+
+#include "camera.glsl"
 
 const float KERNEL_SIZE = 64;
 const float RADIUS = 0.5;
@@ -2,6 +2,7 @@
 #include <learnopengl/shader.h>
 #include <learnopengl/camera.h>
 #include <learnopengl/shapes.h>
+#include <learnopengl/texture_cache.h>
 #include <glad/glad.h> 
 #include <GLFW/glfw3.h>
 #include <stbi_image.h>
@@ -37,10 +38,9 @@ struct Scene {
 
 // Function Headers
 Scene generateScene();
-void renderScene(Scene scene);
+void renderScene(Scene &scene);
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow *window, float &deltaTime);
-unsigned int loadTexture(char const *path);
 void mouseCallback(GLFWwindow *window, double xPos, double yPos);
 void scrollCallback(GLFWwindow *window, double xPos, double yPos);
 
@@ -140,7 +140,7 @@ Shaders generateShaders() {
     (string(SHADER_DIR) + "/pbr-fragment.glsl").c_str()
   );
   return { 
-    .pbr = pbr,
+    .pbr = std::move(pbr),
   };
 }
 
@@ -156,11 +156,19 @@ Shapes generateShapes() {
 }
 
 Textures generateTextures() {
-  unsigned int albedo = loadTexture("/textures/rusted_iron/albedo.png");
-  unsigned int normal = loadTexture("/textures/rusted_iron/normal.png");
-  unsigned int metallic = loadTexture("/textures/rusted_iron/metallic.png");
-  unsigned int roughness = loadTexture("/textures/rusted_iron/roughness.png");
-  unsigned int ao = loadTexture("/textures/rusted_iron/ao.png");
+  // Decode all five maps in parallel through the shared texture cache
+  vector<unsigned int> ids = TextureCache::instance().acquireAll({
+    { string(RESOURCES_DIR) + "/textures/rusted_iron/albedo.png", { .srgb = true } },
+    { string(RESOURCES_DIR) + "/textures/rusted_iron/normal.png", { .srgb = true } },
+    { string(RESOURCES_DIR) + "/textures/rusted_iron/metallic.png", { .srgb = true } },
+    { string(RESOURCES_DIR) + "/textures/rusted_iron/roughness.png", { .srgb = true } },
+    { string(RESOURCES_DIR) + "/textures/rusted_iron/ao.png", { .srgb = true } },
+  });
+  unsigned int albedo = ids[0];
+  unsigned int normal = ids[1];
+  unsigned int metallic = ids[2];
+  unsigned int roughness = ids[3];
+  unsigned int ao = ids[4];
 
   return {
     .albedo = albedo,
@@ -186,8 +194,8 @@ Scene generateScene() {
   };
 }
 
-void renderScene(Scene scene) {
-  Shader shader = scene.shaders.pbr;
+void renderScene(Scene &scene) {
+  Shader &shader = scene.shaders.pbr;
   shader.use();
   // Texture Parameters
   shader.setInt("albedoMap", 0);
@@ -247,49 +255,6 @@ void renderScene(Scene scene) {
   }
 }
 
-/*
-* Utility function for loading a 2D texture from a file
-*/
-unsigned int loadTexture(char const *path) {
-  unsigned int textureID;
-  glGenTextures(1, &textureID);
-  
-  int width, height, nrChannels;
-  std::string resourcePath = (std::string(RESOURCES_DIR) + path);
-  unsigned char *data = stbi_load(resourcePath.c_str(), &width, &height, &nrChannels, 0);
-
-  if (data) {
-    GLenum format;
-    if (nrChannels == 1)
-      format = GL_RED;
-    else if (nrChannels == 3)
-      format = GL_RGB;
-    else if (nrChannels == 4)
-      format = GL_RGBA;
-
-    // Bind and set the newly created texture
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    /*glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);*/
-    // Force to GL_SRGB
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // set the texture wrapping / filtering options
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // free the data
-    stbi_image_free(data);
-  } else {
-    std::cout << "Failed to load texture" << std::endl;
-    stbi_image_free(data);
-  }
-
-  return textureID;
-}
-
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
   /*glViewport(0, 0, width, height);*/
 }
@@ -2,6 +2,7 @@
 #include <learnopengl/shader.h>
 #include <learnopengl/camera.h>
 #include <learnopengl/shapes.h>
+#include <learnopengl/texture_cache.h>
 #include <glad/glad.h> 
 #include <GLFW/glfw3.h>
 #include <stbi_image.h>
@@ -46,10 +47,9 @@ struct Scene {
 
 // Function Headers
 Scene generateScene();
-void renderScene(Scene scene);
+void renderScene(Scene &scene);
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow *window, float &deltaTime);
-unsigned int loadTexture(char const *path);
 void mouseCallback(GLFWwindow *window, double xPos, double yPos);
 void scrollCallback(GLFWwindow *window, double xPos, double yPos);
 
@@ -156,8 +156,8 @@ Shaders generateShaders() {
     (string(SHADER_DIR) + "/background-fragment.glsl").c_str()
   );
   return { 
-    .pbr = pbr,
-    .background = background,
+    .pbr = std::move(pbr),
+    .background = std::move(background),
   };
 }
 
@@ -173,11 +173,19 @@ Shapes generateShapes() {
 }
 
 Textures generateTextures() {
-  unsigned int albedo = loadTexture("/textures/rusted_iron/albedo.png");
-  unsigned int normal = loadTexture("/textures/rusted_iron/normal.png");
-  unsigned int metallic = loadTexture("/textures/rusted_iron/metallic.png");
-  unsigned int roughness = loadTexture("/textures/rusted_iron/roughness.png");
-  unsigned int ao = loadTexture("/textures/rusted_iron/ao.png");
+  // Decode all five maps in parallel through the shared texture cache
+  vector<unsigned int> ids = TextureCache::instance().acquireAll({
+    { string(RESOURCES_DIR) + "/textures/rusted_iron/albedo.png", { .srgb = true } },
+    { string(RESOURCES_DIR) + "/textures/rusted_iron/normal.png", { .srgb = true } },
+    { string(RESOURCES_DIR) + "/textures/rusted_iron/metallic.png", { .srgb = true } },
+    { string(RESOURCES_DIR) + "/textures/rusted_iron/roughness.png", { .srgb = true } },
+    { string(RESOURCES_DIR) + "/textures/rusted_iron/ao.png", { .srgb = true } },
+  });
+  unsigned int albedo = ids[0];
+  unsigned int normal = ids[1];
+  unsigned int metallic = ids[2];
+  unsigned int roughness = ids[3];
+  unsigned int ao = ids[4];
 
   return {
     .albedo = albedo,
@@ -205,7 +213,7 @@ Environment generateEnvironment() {
 
   // Load the HDR Environment Texture
   // --------------------------------
-  stbi_set_flip_vertically_on_load(true);
+  ImageLoader::setFlipVerticallyOnLoad(true);
   int width, height, nrComponents;
   string resourcePath = (std::string(RESOURCES_DIR) + "/textures/hdr/newport_loft.hdr");
   float *data = stbi_loadf(resourcePath.c_str(), &width, &height, &nrComponents, 0);
@@ -213,7 +221,8 @@ Environment generateEnvironment() {
   if (data) {
     glGenTextures(1, &hdrTexture);
     glBindTexture(GL_TEXTURE_2D, hdrTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, data);
+    // radiance is never negative, so a shared exponent keeps it in a third of the memory of RGB32F
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB9_E5, width, height, 0, GL_RGB, GL_FLOAT, data);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -236,8 +245,8 @@ Environment generateEnvironment() {
   glGenTextures(1, &environmentCubemap);
   glBindTexture(GL_TEXTURE_CUBE_MAP, environmentCubemap);
   for (unsigned int i = 0; i < 6; ++i) {
-    // store each face with 16 bit floating point values
-    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 512, 512, 0, GL_RGB, GL_FLOAT, nullptr);
+    // store each face as packed 11/11/10 bit floats, renderable unlike RGB9E5
+    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_R11F_G11F_B10F, 512, 512, 0, GL_RGB, GL_FLOAT, nullptr);
   }
   glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -278,7 +287,7 @@ Environment generateEnvironment() {
   glGenTextures(1, &irradianceMap);
   glBindTexture(GL_TEXTURE_CUBE_MAP, irradianceMap);
   for (unsigned int i = 0; i < 6; ++i) {
-    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA16F, 32, 32, 0, GL_RGB, GL_FLOAT, nullptr);
+    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_R11F_G11F_B10F, 32, 32, 0, GL_RGB, GL_FLOAT, nullptr);
   }
   glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -308,7 +317,7 @@ Environment generateEnvironment() {
   glGenTextures(1, &prefilterMap);
   glBindTexture(GL_TEXTURE_CUBE_MAP, prefilterMap);
   for (unsigned int i = 0; i < 6; ++i) {
-    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA16F, 128, 128, 0, GL_RGB, GL_FLOAT, nullptr);
+    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_R11F_G11F_B10F, 128, 128, 0, GL_RGB, GL_FLOAT, nullptr);
   }
   glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
@@ -374,8 +383,8 @@ Scene generateScene() {
   };
 }
 
-void renderSpheres(Scene scene) {
-  Shader shader = scene.shaders.pbr;
+void renderSpheres(Scene &scene) {
+  Shader &shader = scene.shaders.pbr;
   shader.use();
   shader.setFloat("ambientOcclusion", 1.0f);
   shader.setVec3("albedo", vec3(0.5f, 0.0f, 0.0f));
@@ -426,8 +435,8 @@ void renderSpheres(Scene scene) {
   }
 }
 
-void renderEnvironment(Scene scene) {
-  Shader shader = scene.shaders.background;
+void renderEnvironment(Scene &scene) {
+  Shader &shader = scene.shaders.background;
   shader.use();
   shader.setMat4("view", camera.getLookAt());
   shader.setMat4("projection", camera.getPerspective());
@@ -439,54 +448,11 @@ void renderEnvironment(Scene scene) {
 }
 
 
-void renderScene(Scene scene) {
+void renderScene(Scene &scene) {
   renderSpheres(scene);
   renderEnvironment(scene);
 }
 
-/*
-* Utility function for loading a 2D texture from a file
-*/
-unsigned int loadTexture(char const *path) {
-  unsigned int textureID;
-  glGenTextures(1, &textureID);
-  
-  int width, height, nrChannels;
-  std::string resourcePath = (std::string(RESOURCES_DIR) + path);
-  unsigned char *data = stbi_load(resourcePath.c_str(), &width, &height, &nrChannels, 0);
-
-  if (data) {
-    GLenum format;
-    if (nrChannels == 1)
-      format = GL_RED;
-    else if (nrChannels == 3)
-      format = GL_RGB;
-    else if (nrChannels == 4)
-      format = GL_RGBA;
-
-    // Bind and set the newly created texture
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    /*glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);*/
-    // Force to GL_SRGB
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // set the texture wrapping / filtering options
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // free the data
-    stbi_image_free(data);
-  } else {
-    std::cout << "Failed to load texture" << std::endl;
-    stbi_image_free(data);
-  }
-
-  return textureID;
-}
-
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
   /*glViewport(0, 0, width, height);*/
 }
@@ -1,20 +0,0 @@
-#version 330 core
-
-in vec3 localPos;
-out vec4 FragColor;
-uniform sampler2D equirectangularMap;
-
-const vec2 invAtan = vec2(0.1581, 0.3183);
-
-vec2 sampleSphericalMap(vec3 v) {
-  vec2 uv = vec2(atan(v.z, v.x), asin(v.y));
-  uv *= invAtan;
-  uv += 0.5;
-  return uv;
-}
-
-void main() {
-  vec2 uv = sampleSphericalMap(normalize(localPos));
-  vec3 color = texture(equirectangularMap, uv).rgb;
-  FragColor = vec4(color, 1.0);
-}
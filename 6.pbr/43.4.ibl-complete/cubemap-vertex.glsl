@@ -1,12 +0,0 @@
-#version 330 core
-layout (location = 0) in vec3 aPos;
-
-out vec3 localPos;
-
-uniform mat4 projection;
-uniform mat4 view;
-
-void main() {
-  gl_Position = projection * view * vec4(aPos, 1.0);
-  localPos = aPos;
-}
@@ -2,6 +2,10 @@
 #include <learnopengl/shader.h>
 #include <learnopengl/camera.h>
 #include <learnopengl/shapes.h>
+#include <learnopengl/texture_cache.h>
+#include <learnopengl/ibl_baker.h>
+#include <learnopengl/ibl_cache.h>
+#include <learnopengl/brdf_lut.h>
 #include <glad/glad.h> 
 #include <GLFW/glfw3.h>
 #include <stbi_image.h>
@@ -15,7 +19,6 @@ struct Shaders {
   Shader pbr;
   Shader background;
   Shader quad;
-  Shader brdf;
 };
 
 struct Shapes {
@@ -35,25 +38,58 @@ struct Textures {
 
 struct Environment {
   unsigned int texture;
-  unsigned int irradianceMap;
+  IrradianceSH irradiance;
   unsigned int prefilterMap;
   unsigned int brdfLUTTexture;
 };
 
+// Handles resolved once the programs are built, so a frame never looks a uniform up by name
+struct LightUniforms {
+  UniformHandle<vec3> position;
+  UniformHandle<vec3> colour;
+};
+
+struct PbrUniforms {
+  UniformHandle<float> ambientOcclusion;
+  UniformHandle<vec3> albedo;
+  UniformHandle<vec3> irradianceSH[9];
+  UniformHandle<int> prefilterMap;
+  UniformHandle<int> brdfLUT;
+  UniformHandle<vec3> camPos;
+  UniformHandle<mat4> view;
+  UniformHandle<mat4> projection;
+  UniformHandle<mat4> model;
+  UniformHandle<mat3> normalMatrix;
+  UniformHandle<float> metallic;
+  UniformHandle<float> roughness;
+  vector<LightUniforms> lights;
+};
+
+struct BackgroundUniforms {
+  UniformHandle<mat4> view;
+  UniformHandle<mat4> projection;
+  UniformHandle<int> environmentCubemap;
+};
+
+struct Uniforms {
+  PbrUniforms pbr;
+  BackgroundUniforms background;
+};
+
 struct Scene {
   vector<Light> lights;
   Shaders shaders;
   Shapes shapes;
   Textures textures;
   Environment environment;
+  Uniforms uniforms;
 };
 
 // Function Headers
 Scene generateScene();
-void renderScene(Scene scene);
+void renderScene(Scene &scene);
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow *window, float &deltaTime);
-unsigned int loadTexture(char const *path);
 void mouseCallback(GLFWwindow *window, double xPos, double yPos);
 void scrollCallback(GLFWwindow *window, double xPos, double yPos);
 
@@ -152,27 +188,17 @@ int main() {
 }
 
 Shaders generateShaders() {
-  Shader pbr = Shader(
-    (string(SHADER_DIR) + "/pbr-vertex.glsl").c_str(),
-    (string(SHADER_DIR) + "/pbr-fragment.glsl").c_str()
-  );
-  Shader background = Shader(
-    (string(SHADER_DIR) + "/background-vertex.glsl").c_str(),
-    (string(SHADER_DIR) + "/background-fragment.glsl").c_str()
-  );
-  Shader quad = Shader(
-    (string(SHADER_DIR) + "/quad-vertex.glsl").c_str(),
-    (string(SHADER_DIR) + "/quad-fragment.glsl").c_str()
-  );
-  Shader brdf = Shader(
-    (string(SHADER_DIR) + "/brdf-vertex.glsl").c_str(),
-    (string(SHADER_DIR) + "/brdf-fragment.glsl").c_str()
-  );
+  // compiled together so the driver can overlap them, or loaded from the program cache
+  vector<Shader> shaders = Shader::compileAll({
+    { string(SHADER_DIR) + "/pbr-vertex.glsl", string(SHADER_DIR) + "/pbr-fragment.glsl" },
+    { string(SHADER_DIR) + "/background-vertex.glsl", string(SHADER_DIR) + "/background-fragment.glsl" },
+    { string(SHADER_DIR) + "/quad-vertex.glsl", string(SHADER_DIR) + "/quad-fragment.glsl" },
+  });
+  ProgramCache::instance().printStats();
   return { 
-    .pbr = pbr,
-    .background = background,
-    .quad = quad,
-    .brdf = brdf,
+    .pbr = std::move(shaders[0]),
+    .background = std::move(shaders[1]),
+    .quad = std::move(shaders[2]),
   };
 }
 
@@ -189,11 +215,19 @@ Shapes generateShapes() {
 }
 
 Textures generateTextures() {
-  unsigned int albedo = loadTexture("/textures/rusted_iron/albedo.png");
-  unsigned int normal = loadTexture("/textures/rusted_iron/normal.png");
-  unsigned int metallic = loadTexture("/textures/rusted_iron/metallic.png");
-  unsigned int roughness = loadTexture("/textures/rusted_iron/roughness.png");
-  unsigned int ao = loadTexture("/textures/rusted_iron/ao.png");
+  // Decode all five maps in parallel through the shared texture cache
+  vector<unsigned int> ids = TextureCache::instance().acquireAll({
+    { string(RESOURCES_DIR) + "/textures/rusted_iron/albedo.png", { .srgb = true } },
+    { string(RESOURCES_DIR) + "/textures/rusted_iron/normal.png", { .srgb = true } },
+    { string(RESOURCES_DIR) + "/textures/rusted_iron/metallic.png", { .srgb = true } },
+    { string(RESOURCES_DIR) + "/textures/rusted_iron/roughness.png", { .srgb = true } },
+    { string(RESOURCES_DIR) + "/textures/rusted_iron/ao.png", { .srgb = true } },
+  });
+  unsigned int albedo = ids[0];
+  unsigned int normal = ids[1];
+  unsigned int metallic = ids[2];
+  unsigned int roughness = ids[3];
+  unsigned int ao = ids[4];
 
   return {
     .albedo = albedo,
@@ -205,207 +239,91 @@ Textures generateTextures() {
 }
 
 Environment generateEnvironment() {
-  // Shader
-  Shader cubemapShader = Shader(
-    (string(SHADER_DIR) + "/cubemap-vertex.glsl").c_str(),
-    (string(SHADER_DIR) + "/cubemap-fragment.glsl").c_str()
-  );
-  Shader irradianceShader = Shader(
-    (string(SHADER_DIR) + "/cubemap-vertex.glsl").c_str(),
-    (string(SHADER_DIR) + "/irradiance-convolution.glsl").c_str()
-  );
-  Shader prefilterShader = Shader(
-    (string(SHADER_DIR) + "/cubemap-vertex.glsl").c_str(),
-    (string(SHADER_DIR) + "/prefilter-convolution.glsl").c_str()
-  );
-  Shader brdfShader = Shader(
-    (string(SHADER_DIR) + "/brdf-vertex.glsl").c_str(),
-    (string(SHADER_DIR) + "/brdf-fragment.glsl").c_str()
-  );
+  double started = glfwGetTime();
+  IblBakeSettings settings;
+
+  // The BRDF LUT is embedded in the binary, see brdf_lut.h
+  unsigned int brdfLUTTexture = createBrdfLutTexture();
+
+  // Reuse the previous bake when the HDR has not changed
+  // ----------------------------------------------------
+  string resourcePath = (std::string(RESOURCES_DIR) + "/textures/hdr/newport_loft.hdr");
+  IblCache cache = IblCache(resourcePath, settings);
+  IblMaps maps;
+  if (cache.load(maps)) {
+    cout << "Loaded IBL from cache in " << glfwGetTime() - started << "s" << endl;
+    return {
+      .texture = maps.environment,
+      .irradiance = maps.irradiance,
+      .prefilterMap = maps.prefilter,
+      .brdfLUTTexture = brdfLUTTexture,
+    };
+  }
 
   // Load the HDR Environment Texture
   // --------------------------------
-  stbi_set_flip_vertically_on_load(true);
+  ImageLoader::setFlipVerticallyOnLoad(true);
   int width, height, nrComponents;
-  string resourcePath = (std::string(RESOURCES_DIR) + "/textures/hdr/newport_loft.hdr");
-  float *data = stbi_loadf(resourcePath.c_str(), &width, &height, &nrComponents, 0);
-  unsigned int hdrTexture;
-  if (data) {
-    glGenTextures(1, &hdrTexture);
-    glBindTexture(GL_TEXTURE_2D, hdrTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, data);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    stbi_image_free(data);
-  } else {
+  float *data = stbi_loadf(resourcePath.c_str(), &width, &height, &nrComponents, 3);
+  if (!data) {
     cout << "Failed to load HDR image at " << resourcePath << endl;
+    return {};
   }
 
-  // Setup a Framebuffer to Render the Cubemap to
-  // --------------------------------------------
-  unsigned int captureFBO, captureRBO;
-  glGenFramebuffers(1, &captureFBO);
-  glGenRenderbuffers(1, &captureRBO);
-  glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
-  glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
-  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 512, 512);
-  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, captureRBO);
-
-  unsigned int environmentCubemap;
-  glGenTextures(1, &environmentCubemap);
-  glBindTexture(GL_TEXTURE_CUBE_MAP, environmentCubemap);
-  for (unsigned int i = 0; i < 6; ++i) {
-    // store each face with 16 bit floating point values
-    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 512, 512, 0, GL_RGB, GL_FLOAT, nullptr);
-  }
-  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR); // enable pre-filter mipmap sampling
-  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-  // Capture to each side of the cubemap
-  // ----------------------------------
-  mat4 captureProjection = perspective(radians(90.0f), 1.0f, 0.1f, 10.0f);
-  mat4 captureViews[] =
-  {
-    lookAt(vec3(0.0f, 0.0f, 0.0f), vec3( 1.0f,  0.0f,  0.0f), vec3(0.0f, -1.0f,  0.0f)),
-    lookAt(vec3(0.0f, 0.0f, 0.0f), vec3(-1.0f,  0.0f,  0.0f), vec3(0.0f, -1.0f,  0.0f)),
-    lookAt(vec3(0.0f, 0.0f, 0.0f), vec3( 0.0f,  1.0f,  0.0f), vec3(0.0f,  0.0f,  1.0f)),
-    lookAt(vec3(0.0f, 0.0f, 0.0f), vec3( 0.0f, -1.0f,  0.0f), vec3(0.0f,  0.0f, -1.0f)),
-    lookAt(vec3(0.0f, 0.0f, 0.0f), vec3( 0.0f,  0.0f,  1.0f), vec3(0.0f, -1.0f,  0.0f)),
-    lookAt(vec3(0.0f, 0.0f, 0.0f), vec3( 0.0f,  0.0f, -1.0f), vec3(0.0f, -1.0f,  0.0f))
-  };
-  cubemapShader.use();
-  cubemapShader.setMat4("projection", captureProjection);
-  cubemapShader.setInt("equirectangularMap", 0);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, hdrTexture);
-  Cube cube = Cube();
-  glViewport(0, 0, 512, 512);
-  glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
-  for (unsigned int i = 0; i < 6; ++i) {
-    cubemapShader.setMat4("view", captureViews[i]);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, environmentCubemap, 0);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    cube.draw();
-  }
+  // Bake the cubemap, irradiance and prefilter maps on the CPU, on every core
+  // -------------------------------------------------------------------------
+  vector<FloatCubemap> environment = buildCubemapMips(equirectangularToCubemap(data, width, height, settings.environmentSize));
+  maps.irradiance = projectIrradianceSH(data, width, height);
+  stbi_image_free(data);
+  vector<FloatCubemap> prefilter = prefilterGGX(environment, settings.prefilterSize, settings.prefilterLevels, settings.prefilterSamples);
+  maps.environment = IblCache::createCubemap(settings.format, environment);
+  maps.prefilter = IblCache::createCubemap(settings.format, prefilter);
+  measureHdrError(environment[0].texels.data(), environment[0].texels.size(), settings.format).print("Environment");
+  measureHdrError(prefilter[0].texels.data(), prefilter[0].texels.size(), settings.format).print("Prefilter");
+
+  // Keep the bake for the next run
+  cache.save(maps);
+  cout << "Baked IBL in " << glfwGetTime() - started << "s" << endl;
 
-  // Let OpenGL generate mipmaps from the first mip face (combatting dots artifact)
-  glBindTexture(GL_TEXTURE_CUBE_MAP, environmentCubemap);
-  glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
-
-  // Pre-compute the irradiance diffuse map
-  // --------------------------------------
-  unsigned int irradianceMap;
-  glGenTextures(1, &irradianceMap);
-  glBindTexture(GL_TEXTURE_CUBE_MAP, irradianceMap);
-  for (unsigned int i = 0; i < 6; ++i) {
-    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA16F, 32, 32, 0, GL_RGB, GL_FLOAT, nullptr);
-  }
-  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-  irradianceShader.use();
-  irradianceShader.setInt("environmentMap", 0);
-  irradianceShader.setMat4("projection", captureProjection);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_CUBE_MAP, environmentCubemap);
-  glViewport(0, 0, 32, 32);
-  glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
-  glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
-  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 32, 32);
-  for (unsigned int i = 0; i < 6; ++i) {
-    irradianceShader.setMat4("view", captureViews[i]);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, irradianceMap, 0);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    cube.draw();
-  }
+  return {
+    .texture = maps.environment,
+    .irradiance = maps.irradiance,
+    .prefilterMap = maps.prefilter,
+    .brdfLUTTexture = brdfLUTTexture,
+  };
+}
 
-  // Pre-compute the prefilter map
-  // --------------------------------------
-  unsigned int prefilterMap;
-  glGenTextures(1, &prefilterMap);
-  glBindTexture(GL_TEXTURE_CUBE_MAP, prefilterMap);
-  for (unsigned int i = 0; i < 6; ++i) {
-    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA16F, 128, 128, 0, GL_RGB, GL_FLOAT, nullptr);
+Uniforms generateUniforms(const Shaders &shaders, size_t lightCount) {
+  const Shader &pbr = shaders.pbr;
+  PbrUniforms pbrUniforms = {
+    .ambientOcclusion = pbr.uniform<float>("ambientOcclusion"),
+    .albedo = pbr.uniform<vec3>("albedo"),
+    .prefilterMap = pbr.uniform<int>("prefilterMap"),
+    .brdfLUT = pbr.uniform<int>("brdfLUT"),
+    .camPos = pbr.uniform<vec3>("camPos"),
+    .view = pbr.uniform<mat4>("view"),
+    .projection = pbr.uniform<mat4>("projection"),
+    .model = pbr.uniform<mat4>("model"),
+    .normalMatrix = pbr.uniform<mat3>("normalMatrix"),
+    .metallic = pbr.uniform<float>("metallic"),
+    .roughness = pbr.uniform<float>("roughness"),
+  };
+  for (int i = 0; i < 9; ++i) {
+    pbrUniforms.irradianceSH[i] = pbr.uniform<vec3>("irradianceSH[" + to_string(i) + "]");
   }
-  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-  glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
-
-  prefilterShader.use();
-  prefilterShader.setInt("environmentMap", 0);
-  prefilterShader.setMat4("projection", captureProjection);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_CUBE_MAP, environmentCubemap);
-
-  glBindFramebuffer(GL_FRAMEBUFFER, captureFBO); // reuse the capture fbo
-  unsigned int maxMipLevels = 5;
-  for (unsigned int mip = 0; mip < maxMipLevels; ++mip) {
-    // resize the framebuffer according to the mip-level size
-    unsigned int mipWidth = 128 * pow(0.5, mip);
-    unsigned int mipHeight = 128 * pow(0.5, mip);
-    glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, mipWidth, mipHeight);
-    glViewport(0, 0, mipWidth, mipHeight);
-
-    // render the prefilter convolution to each side of the cube at varying roughnesses at different mipmap levels
-    float roughness = (float)mip / (maxMipLevels - 1);
-    prefilterShader.setFloat("roughness", roughness);
-    for (unsigned int i = 0; i < 6; ++i) {
-      prefilterShader.setMat4("view", captureViews[i]);
-      glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, prefilterMap, mip);
-      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-      cube.draw();
-    }
+  for (size_t i = 0; i < lightCount; ++i) {
+    string light = "lights[" + to_string(i) + "]";
+    pbrUniforms.lights.push_back({ pbr.uniform<vec3>(light + ".position"), pbr.uniform<vec3>(light + ".colour") });
   }
 
-  // Pre-compute the BRDF Map
-  // --------------------------------------
-  unsigned int brdfLUTTexture;
-  glGenTextures(1, &brdfLUTTexture);
-
-  // pre-allocate enough memory for the LUT texture
-  glBindTexture(GL_TEXTURE_2D, brdfLUTTexture);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, 512, 512, 0, GL_RGBA, GL_FLOAT, 0); // use GL_RGBA because old method was not fking working
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-  // run the shader over an NDC screen-space quad
-  glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
-  glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
-  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 512, 512);
-  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, brdfLUTTexture, 0);
-  glViewport(0, 0, 512, 512);
-  brdfShader.use();
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  Quad quad = Quad();
-  quad.draw();
-
-  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-    cout << "Framebuffer is not complete." << endl;
-
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
-  glBindRenderbuffer(GL_RENDERBUFFER, 0);
-  glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-  glBindTexture(GL_TEXTURE_2D, 0);
-
+  const Shader &background = shaders.background;
   return {
-    .texture = environmentCubemap,
-    .irradianceMap = irradianceMap,
-    .prefilterMap = prefilterMap,
-    .brdfLUTTexture = brdfLUTTexture,
+    .pbr = std::move(pbrUniforms),
+    .background = {
+      .view = background.uniform<mat4>("view"),
+      .projection = background.uniform<mat4>("projection"),
+      .environmentCubemap = background.uniform<int>("environmentCubemap"),
+    },
   };
 }
 
@@ -416,33 +334,36 @@ Scene generateScene() {
   lights.push_back({ vec3(-10.0f,-10.0f, 10.0f), vec3(300.0f, 300.0f, 300.0f) });
   lights.push_back({ vec3( 10.0f,-10.0f, 10.0f), vec3(300.0f, 300.0f, 300.0f) });
 
-  return {
+  Scene scene = {
     .lights = lights,
     .shaders = generateShaders(),
     .shapes = generateShapes(),
     .textures = generateTextures(),
     .environment = generateEnvironment(),
   };
+  scene.uniforms = generateUniforms(scene.shaders, scene.lights.size());
+  return scene;
 }
 
-void renderSpheres(Scene scene) {
-  Shader shader = scene.shaders.pbr;
+void renderSpheres(Scene &scene) {
+  Shader &shader = scene.shaders.pbr;
+  const PbrUniforms &uniforms = scene.uniforms.pbr;
   shader.use();
-  shader.setFloat("ambientOcclusion", 1.0f);
-  shader.setVec3("albedo", vec3(0.5f, 0.0f, 0.0f));
-  shader.setInt("irradianceMap", 0);
-  shader.setInt("prefilterMap", 1);
-  shader.setInt("brdfLUT", 2);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_CUBE_MAP, scene.environment.irradianceMap);
+  shader.set(uniforms.ambientOcclusion, 1.0f);
+  shader.set(uniforms.albedo, vec3(0.5f, 0.0f, 0.0f));
+  for (int i = 0; i < 9; ++i) {
+    shader.set(uniforms.irradianceSH[i], scene.environment.irradiance.coefficients[i]);
+  }
+  shader.set(uniforms.prefilterMap, 1);
+  shader.set(uniforms.brdfLUT, 2);
   glActiveTexture(GL_TEXTURE1);
   glBindTexture(GL_TEXTURE_CUBE_MAP, scene.environment.prefilterMap);
   glActiveTexture(GL_TEXTURE2);
   glBindTexture(GL_TEXTURE_2D, scene.environment.brdfLUTTexture);
 
-  shader.setVec3("camPos", camera.cameraPos);
-  shader.setMat4("view", camera.getLookAt());
-  shader.setMat4("projection", camera.getPerspective());
+  shader.set(uniforms.camPos, camera.cameraPos);
+  shader.set(uniforms.view, camera.getLookAt());
+  shader.set(uniforms.projection, camera.getPerspective());
 
   mat4 model = mat4(1.0f);
 
@@ -453,17 +374,17 @@ void renderSpheres(Scene scene) {
   const int COLS = 7;
   const float SPACING = 2.5;
   for (int row = 0; row < ROWS; ++row) {
-    shader.setFloat("metallic", (float)row / ROWS);
+    shader.set(uniforms.metallic, (float)row / ROWS);
     for (int col = 0; col < COLS; ++col) {
-      shader.setFloat("roughness", glm::clamp((float)col / COLS, 0.05f, 1.0f));
+      shader.set(uniforms.roughness, glm::clamp((float)col / COLS, 0.05f, 1.0f));
       model = mat4(1.0f);
       model = translate(model, vec3(
         (col - (COLS / 2.0f)) * SPACING,
         (row - (ROWS / 2.0f)) * SPACING,
         0.0
       ));
-      shader.setMat4("model", model);
-      shader.setMat3("normalMatrix", transpose(inverse(mat3(model))));
+      shader.set(uniforms.model, model);
+      shader.set(uniforms.normalMatrix, transpose(inverse(mat3(model))));
       scene.shapes.sphere.draw();
     }
   }
@@ -471,78 +392,36 @@ void renderSpheres(Scene scene) {
   // render lights
   for (int i = 0; i < scene.lights.size(); ++i) {
     vec3 newPos = scene.lights[i].position + vec3(sin(glfwGetTime() * 5.0) * 5.0, 0.0, 0.0);
-    shader.setVec3("lights[" + to_string(i) + "].position", newPos);
-    shader.setVec3("lights[" + to_string(i) + "].colour", scene.lights[i].colour);
+    shader.set(uniforms.lights[i].position, newPos);
+    shader.set(uniforms.lights[i].colour, scene.lights[i].colour);
 
     model = glm::mat4(1.0f);
     model = translate(model, newPos);
     model = scale(model, vec3(0.5f));
-    shader.setMat4("model", model);
-    shader.setMat3("normalMatrix", transpose(inverse(mat3(model))));
+    shader.set(uniforms.model, model);
+    shader.set(uniforms.normalMatrix, transpose(inverse(mat3(model))));
     scene.shapes.sphere.draw();
   }
 }
 
-void renderEnvironment(Scene scene) {
-  Shader shader = scene.shaders.background;
+void renderEnvironment(Scene &scene) {
+  Shader &shader = scene.shaders.background;
+  const BackgroundUniforms &uniforms = scene.uniforms.background;
   shader.use();
-  shader.setMat4("view", camera.getLookAt());
-  shader.setMat4("projection", camera.getPerspective());
-  shader.setInt("environmentCubemap", 0);
+  shader.set(uniforms.view, camera.getLookAt());
+  shader.set(uniforms.projection, camera.getPerspective());
+  shader.set(uniforms.environmentCubemap, 0);
   glActiveTexture(GL_TEXTURE0);
   glBindTexture(GL_TEXTURE_CUBE_MAP, scene.environment.texture);
   scene.shapes.cube.draw();
   glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
 }
 
-void renderScene(Scene scene) {
+void renderScene(Scene &scene) {
   renderSpheres(scene);
   renderEnvironment(scene);
 }
 
-/*
-* Utility function for loading a 2D texture from a file
-*/
-unsigned int loadTexture(char const *path) {
-  unsigned int textureID;
-  glGenTextures(1, &textureID);
-  
-  int width, height, nrChannels;
-  std::string resourcePath = (std::string(RESOURCES_DIR) + path);
-  unsigned char *data = stbi_load(resourcePath.c_str(), &width, &height, &nrChannels, 0);
-
-  if (data) {
-    GLenum format;
-    if (nrChannels == 1)
-      format = GL_RED;
-    else if (nrChannels == 3)
-      format = GL_RGB;
-    else if (nrChannels == 4)
-      format = GL_RGBA;
-
-    // Bind and set the newly created texture
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    /*glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);*/
-    // Force to GL_SRGB
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // set the texture wrapping / filtering options
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // free the data
-    stbi_image_free(data);
-  } else {
-    std::cout << "Failed to load texture" << std::endl;
-    stbi_image_free(data);
-  }
-
-  return textureID;
-}
-
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
   /*glViewport(0, 0, width, height);*/
 }
@@ -19,7 +19,8 @@ uniform float metallic;
 uniform float roughness;
 uniform float ambientOcclusion;
 
-uniform samplerCube irradianceMap;
+// irradiance / pi as SH9 with the basis constants folded in, see IrradianceSH
+uniform vec3 irradianceSH[9];
 uniform samplerCube prefilterMap;
 uniform sampler2D brdfLUT;
 
@@ -28,6 +29,13 @@ uniform Light lights[NUM_LIGHTS];
 
 const float PI = 3.14159265359;
 
+vec3 irradianceAt(vec3 n) {
+  return irradianceSH[0]
+    + irradianceSH[1] * n.y + irradianceSH[2] * n.z + irradianceSH[3] * n.x
+    + irradianceSH[4] * (n.x * n.y) + irradianceSH[5] * (n.y * n.z) + irradianceSH[6] * (3.0 * n.z * n.z - 1.0)
+    + irradianceSH[7] * (n.x * n.z) + irradianceSH[8] * (n.x * n.x - n.y * n.y);
+}
+
 vec3 fresnelSchlick(float cosTheta, vec3 F0) {
   return F0 + (1.0 - F0) * pow(1.0 - cosTheta, 5.0);
 }
@@ -114,7 +122,7 @@ void main() {
   kD *= 1.0 - metallic;
 
   // diffuse lighting
-  vec3 irradiance = texture(irradianceMap, N).rgb;
+  vec3 irradiance = max(irradianceAt(N), 0.0);
   vec3 diffuse = irradiance * albedo;
 
   // specular lighting
@@ -1,116 +0,0 @@
-#version 330 core
-
-in vec3 localPos;
-out vec4 FragColor;
-
-uniform samplerCube environmentMap;
-uniform float roughness;
-
-const float PI = 3.14159265359;
-
-float RadicalInverse_VdC(uint bits);
-vec2 Hammersley(uint i, uint N);
-vec3 ImportanceSampleGGX(vec2 Xi, vec3 N, float roughness);
-float DistributionGGX(vec3 N, vec3 H, float roughness);
-
-/**
- Prefilter the environment, based on some input roughness that variesover each mipmap level of the cubemap
- Generate a number of sample vectors using low-discrepancy sampling
- Bias them towards the specular lobe
- Sample the environment map and add up their colours
- Divide by the total weight
-*/
-void main() {
-  vec3 N = normalize(localPos);
-  vec3 R = N;
-  vec3 V = R;
-
-  const uint SAMPLE_COUNT = 1024u;
-  float totalWeight = 0.0;
-  vec3 prefilteredColour = vec3(0.0);
-  for (uint i = 0u; i < SAMPLE_COUNT; ++i) {
-    // low discrepancy sequencing: generate the sample vector based on the nth sample
-    vec2 Xi = Hammersley(i, SAMPLE_COUNT);
-
-    // importance sampling: bias the vector towards the specular lobe of some roughness
-    vec3 H = ImportanceSampleGGX(Xi, N, roughness);
-    vec3 L = normalize(2.0 * dot(V, H) * H - V);
-
-    float NdotL = max(dot(N, L), 0.0);
-
-    if (NdotL > 0.0) {
-      // Chetan Jag's method to reduce dot artifacts on brighter lights
-      float D = DistributionGGX(N, H, roughness);
-      float NdotH = max(dot(N, H), 0.0);
-      float HdotV = max(dot(H, V), 0.0);
-      float pdf = (D * NdotH / (4.0 * HdotV)) + 0.0001;
-
-      float resolution = 512.0; // resolution of the source cubemap (per face)
-      float saTexel = 4.0 * PI / (6.0 * resolution * resolution);
-      float saSample = 1.0 / (float(SAMPLE_COUNT) * pdf + 0.0001);
-
-      float mipLevel = roughness == 0.0 ? 0.0 : 0.5 * log2(saSample / saTexel);
-
-      prefilteredColour += textureLod(environmentMap, L, mipLevel).rgb * NdotL;
-      totalWeight += NdotL;
-    }
-
-  }
-  prefilteredColour = prefilteredColour / totalWeight;
-  FragColor = vec4(prefilteredColour, 1.0);
-}
-
-float DistributionGGX(vec3 N, vec3 H, float roughness) {
-  float a = roughness * roughness;
-  float a2 = a * a;
-  float NdotH = max(dot(N, H), 0.0);
-  float NdotH2 = NdotH * NdotH;
-
-  float numerator = a2;
-  float denominator = NdotH * (a2 - 1.0) + 1.0;
-  denominator = PI * denominator * denominator;
-  return numerator / denominator;
-}
-
-// =========== Low Discrepancy Sequencing =====================
-
-// Generates the Van Der Corpus sequence
-// http://holger.dammertz.org/stuff/notes_HammersleyOnHemisphere.html
-float RadicalInverse_VdC(uint bits) {
-   bits = (bits << 16u) | (bits >> 16u);
-   bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
-   bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
-   bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
-   bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
-   return float(bits) * 2.3283064365386963e-10; // / 0x100000000
-}
-
-// Generates the number of Hammersley samples for sample i over N total samples.
-vec2 Hammersley(uint i, uint N) {
-  return vec2(float(i) / float(N), RadicalInverse_VdC(i));
-}
-
-// =========== Importance Sampling of the Specular Lobe =====================
-
-// Orients and biases the sample vector towards the specualr lobe of some roughness
-vec3 ImportanceSampleGGX(vec2 Xi, vec3 N, float roughness) {
-  float a = roughness;
-  float phi = 2.0 * PI * Xi.x;
-  float cosTheta = sqrt((1.0 - Xi.y) / (1.0 + (a*a - 1.0) * Xi.y));
-  float sinTheta = sqrt(1.0 - cosTheta*cosTheta);
-
-  // from spherical coordinates to cartesian coordinates
-  vec3 H;
-  H.x = cos(phi) * sinTheta;
-  H.y = sin(phi) * sinTheta;
-  H.z = cosTheta;
-
-  // from tangent-space vector to world-space sample vector
-  vec3 up = abs(N.z) < 0.999 ? vec3(0.0, 0.0, 1.0) : vec3(1.0, 0.0, 0.0);
-  vec3 tangent = normalize(cross(up, N));
-  vec3 bitangent = cross(N, tangent);
-
-  vec3 sampleVec = tangent * H.x + bitangent * H.y + N * H.z;
-  return normalize(sampleVec);
-}
-
@@ -35,7 +35,7 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow *window, float &deltaTime);
 void mouseCallback(GLFWwindow *window, double xPos, double yPos);
 TextRenderer loadRenderer();
-void renderText(TextRenderer renderer, string text, float x, float y, float scale, vec3 colour);
+void renderText(TextRenderer &renderer, string text, float x, float y, float scale, vec3 colour);
 
 // Global Variables
 bool firstMouse = false;
@@ -201,7 +201,7 @@ TextRenderer loadRenderer() {
   );
 
   return {
-    .shader = textShader,
+    .shader = std::move(textShader),
     .characters = characters,
     .projection = projection,
     .VAO = VAO,
@@ -209,7 +209,7 @@ TextRenderer loadRenderer() {
   };
 }
 
-void renderText(TextRenderer renderer, string text, float x, float y, float scale, vec3 colour) {
+void renderText(TextRenderer &renderer, string text, float x, float y, float scale, vec3 colour) {
   renderer.shader.use();
   renderer.shader.setVec3("colour", colour);
   renderer.shader.setMat4("projection", renderer.projection);
@@ -0,0 +1,82 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+/*
+* Counts heap allocations by replacing the global operator new, so an example can check that
+* its steady frames allocate nothing
+*
+*   FrameAllocations allocations;
+*   while (...) {
+*     allocations.beginFrame();
+*     ...
+*     allocations.endFrame();
+*   }
+*   return allocations.steadyAllocations() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+*
+* The replacements cannot be inline, so include this from one translation unit only, which for
+* the examples is their main.cpp. Every thread is counted, a streaming thread included; over
+* aligned allocations are not.
+*/
+inline std::atomic<size_t> heapAllocationCount { 0 };
+
+void *operator new(size_t size) {
+  heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void *memory = std::malloc(size ? size : 1))
+    return memory;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+  std::free(memory);
+}
+
+class FrameAllocations {
+public:
+  // The first frames resolve material uniforms and fill driver caches, so they go unchecked
+  FrameAllocations(unsigned int warmUpFrames = 10) : remainingWarmUp(warmUpFrames) {}
+
+  void beginFrame() {
+    before = heapAllocationCount.load(std::memory_order_relaxed);
+  }
+
+  // Reports a checked frame that allocated and adds it to the steady count
+  void endFrame() {
+    size_t allocations = heapAllocationCount.load(std::memory_order_relaxed) - before;
+    frame++;
+    if (remainingWarmUp > 0) {
+      remainingWarmUp--;
+      return;
+    }
+    if (allocations == 0)
+      return;
+    std::cout << "ERROR::FRAME::HEAP_ALLOCATIONS " << allocations << " in frame " << frame << std::endl;
+    steady += allocations;
+  }
+
+  // Starts the warm up again, e.g. when a streamed model lands and is drawn for the first time
+  void warmUp(unsigned int frames = 10) {
+    remainingWarmUp = frames;
+  }
+
+  size_t steadyAllocations() const {
+    return steady;
+  }
+
+private:
+  unsigned int remainingWarmUp;
+  unsigned int frame = 0;
+  size_t before = 0;
+  size_t steady = 0;
+};
+
+#endif
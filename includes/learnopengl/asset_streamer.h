@@ -0,0 +1,121 @@
+#ifndef ASSET_STREAMER_H
+#define ASSET_STREAMER_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <iostream>
+#include <functional>
+#include <condition_variable>
+
+/*
+* Background asset loading on a shared GL context
+*
+* start() has to be called from the main thread once the window exists: GLFW only creates
+* windows there. It opens a hidden 1x1 window whose context shares objects with the main one and
+* hands it to a single worker thread, which runs the submitted jobs with that context current.
+*
+* Buffers and textures made on the worker are visible to the render thread once a fence the job
+* inserts has signalled. Vertex array objects are not shared between contexts, so anything built
+* on the worker leaves them for the render thread (see Mesh::setupVertexArray).
+*/
+class AssetStreamer {
+public:
+  static AssetStreamer &instance() {
+    static AssetStreamer streamer;
+    return streamer;
+  }
+
+  // True on the worker thread, where VAOs can't be created
+  static bool onUploadThread() {
+    return uploadThread();
+  }
+
+  bool start(GLFWwindow *mainWindow) {
+    if (context)
+      return true;
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    context = glfwCreateWindow(1, 1, "upload", NULL, mainWindow);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if (!context) {
+      std::cout << "ERROR::ASSET_STREAMER::FAILED_TO_CREATE_SHARED_CONTEXT" << std::endl;
+      return false;
+    }
+
+    worker = std::thread([this]() { work(); });
+    return true;
+  }
+
+  bool running() const {
+    return context != nullptr;
+  }
+
+  void submit(std::function<void()> job) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      queue.push_back(std::move(job));
+    }
+    available.notify_one();
+  }
+
+  // Joins the worker; call before glfwTerminate so the shared context goes first
+  void stop() {
+    if (!context)
+      return;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    available.notify_all();
+    worker.join();
+    glfwDestroyWindow(context);
+    context = nullptr;
+  }
+
+private:
+  GLFWwindow *context = nullptr;
+  std::thread worker;
+  std::deque<std::function<void()>> queue;
+  std::mutex mutex;
+  std::condition_variable available;
+  bool stopping = false;
+
+  AssetStreamer() {}
+
+  ~AssetStreamer() {
+    // a still running worker can't outlive the process safely, so just detach it here
+    if (worker.joinable())
+      worker.detach();
+  }
+
+  static bool &uploadThread() {
+    static thread_local bool upload = false;
+    return upload;
+  }
+
+  void work() {
+    glfwMakeContextCurrent(context);
+    uploadThread() = true;
+    while (true) {
+      std::function<void()> job;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        available.wait(lock, [this]() { return stopping || !queue.empty(); });
+        if (stopping && queue.empty())
+          break;
+        job = std::move(queue.front());
+        queue.pop_front();
+      }
+      job();
+    }
+    glfwMakeContextCurrent(NULL);
+  }
+};
+
+#endif
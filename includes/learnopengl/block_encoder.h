@@ -0,0 +1,509 @@
+#ifndef BLOCK_ENCODER_H
+#define BLOCK_ENCODER_H
+
+#include "learnopengl/texture_compression.h"
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <glm/glm.hpp>
+
+using std::vector;
+
+/*
+* CPU encoders for BC1, BC3, BC4, BC5 and BC7, plus matching decoders to measure the result
+*
+* Every encoder takes one 4x4 block of RGBA8 texels (row major) and writes blockBytes() bytes.
+* They aim for decent quality at offline speed rather than the best possible result:
+*
+*   BC1 / BC3 colour  principal axis endpoints, then two least squares refinements
+*   BC4 / BC5         min / max endpoints in 8 value mode
+*   BC7               mode 6 only (one subset, 7777.1 RGBA endpoints, 4 bit indices) with
+*                     every p-bit combination tried; good for colour, alpha and normal maps
+*
+* ETC2 is only loaded, not encoded.
+*/
+typedef uint8_t BlockTexels[16][4];
+
+namespace block_encoder {
+  // Principal axis of the first `channels` channels, by power iteration on the covariance
+  inline glm::vec4 principalAxis(const glm::vec4 *texels, unsigned int channels, glm::vec4 &mean) {
+    mean = glm::vec4(0.0f);
+    for (unsigned int i = 0; i < 16; ++i)
+      mean += texels[i];
+    mean /= 16.0f;
+
+    float covariance[4][4] = {};
+    for (unsigned int i = 0; i < 16; ++i) {
+      glm::vec4 d = texels[i] - mean;
+      for (unsigned int a = 0; a < channels; ++a)
+        for (unsigned int b = 0; b < channels; ++b)
+          covariance[a][b] += d[a] * d[b];
+    }
+
+    glm::vec4 axis(0.0f);
+    for (unsigned int a = 0; a < channels; ++a)
+      axis[a] = 1.0f;
+    for (unsigned int iteration = 0; iteration < 8; ++iteration) {
+      glm::vec4 next(0.0f);
+      for (unsigned int a = 0; a < channels; ++a)
+        for (unsigned int b = 0; b < channels; ++b)
+          next[a] += covariance[a][b] * axis[b];
+      float length = glm::length(next);
+      if (length < 1e-6f)
+        break;
+      axis = next / length;
+    }
+    return axis;
+  }
+
+  // Solves sum |a_i * e0 + b_i * e1 - x_i|^2 for the two endpoints, false if degenerate
+  inline bool leastSquaresEndpoints(const glm::vec4 *texels, const float *weights0, glm::vec4 &e0, glm::vec4 &e1) {
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    glm::vec4 ax(0.0f), bx(0.0f);
+    for (unsigned int i = 0; i < 16; ++i) {
+      float a = weights0[i];
+      float b = 1.0f - a;
+      aa += a * a;
+      ab += a * b;
+      bb += b * b;
+      ax += a * texels[i];
+      bx += b * texels[i];
+    }
+    float determinant = aa * bb - ab * ab;
+    if (std::fabs(determinant) < 1e-6f)
+      return false;
+    e0 = glm::clamp((ax * bb - bx * ab) / determinant, 0.0f, 255.0f);
+    e1 = glm::clamp((bx * aa - ax * ab) / determinant, 0.0f, 255.0f);
+    return true;
+  }
+
+  inline uint16_t packRgb565(glm::vec4 colour) {
+    unsigned int r = (unsigned int)std::lround(colour.r * 31.0f / 255.0f);
+    unsigned int g = (unsigned int)std::lround(colour.g * 63.0f / 255.0f);
+    unsigned int b = (unsigned int)std::lround(colour.b * 31.0f / 255.0f);
+    return (uint16_t)(r << 11 | g << 5 | b);
+  }
+
+  inline glm::vec4 unpackRgb565(uint16_t packed) {
+    unsigned int r = packed >> 11 & 31;
+    unsigned int g = packed >> 5 & 63;
+    unsigned int b = packed & 31;
+    return glm::vec4((float)(r << 3 | r >> 2), (float)(g << 2 | g >> 4), (float)(b << 3 | b >> 2), 255.0f);
+  }
+
+  inline void bc1Palette(uint16_t c0, uint16_t c1, bool fourColour, glm::vec4 palette[4]) {
+    palette[0] = unpackRgb565(c0);
+    palette[1] = unpackRgb565(c1);
+    if (fourColour) {
+      palette[2] = glm::floor((2.0f * palette[0] + palette[1]) / 3.0f);
+      palette[3] = glm::floor((palette[0] + 2.0f * palette[1]) / 3.0f);
+    } else {
+      palette[2] = glm::floor((palette[0] + palette[1]) * 0.5f);
+      palette[3] = glm::vec4(0.0f);
+    }
+  }
+
+  inline float rgbDistance(glm::vec4 a, glm::vec4 b) {
+    glm::vec3 d = glm::vec3(a) - glm::vec3(b);
+    return glm::dot(d, d);
+  }
+
+  // Colour half of BC1 / BC3. Always produces a four colour block (c0 > c1), as BC3 requires.
+  inline void encodeColourBlock(const BlockTexels &block, uint8_t *out) {
+    glm::vec4 texels[16];
+    for (unsigned int i = 0; i < 16; ++i)
+      texels[i] = glm::vec4(block[i][0], block[i][1], block[i][2], 0.0f);
+
+    // 1. Endpoints at the extremes along the principal axis
+    glm::vec4 mean;
+    glm::vec4 axis = principalAxis(texels, 3, mean);
+    float lowest = 1e9f, highest = -1e9f;
+    for (unsigned int i = 0; i < 16; ++i) {
+      float t = glm::dot(texels[i] - mean, axis);
+      lowest = std::min(lowest, t);
+      highest = std::max(highest, t);
+    }
+    glm::vec4 e0 = glm::clamp(mean + axis * highest, 0.0f, 255.0f);
+    glm::vec4 e1 = glm::clamp(mean + axis * lowest, 0.0f, 255.0f);
+
+    // 2. Quantize, pick indices, refit the endpoints to those indices and keep the best
+    static const float WEIGHTS[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+    uint16_t bestC0 = 0, bestC1 = 0;
+    uint32_t bestIndices = 0;
+    float bestError = 1e30f;
+    for (unsigned int iteration = 0; iteration < 3; ++iteration) {
+      uint16_t c0 = packRgb565(e0);
+      uint16_t c1 = packRgb565(e1);
+      if (c0 < c1)
+        std::swap(c0, c1);
+
+      glm::vec4 palette[4];
+      bc1Palette(c0, c1, true, palette);
+      uint32_t indices = 0;
+      float error = 0.0f;
+      float weights0[16];
+      for (unsigned int i = 0; i < 16; ++i) {
+        unsigned int best = 0;
+        float bestDistance = rgbDistance(texels[i], palette[0]);
+        for (unsigned int p = 1; p < 4; ++p) {
+          float distance = rgbDistance(texels[i], palette[p]);
+          if (distance < bestDistance) {
+            bestDistance = distance;
+            best = p;
+          }
+        }
+        if (c0 == c1)
+          best = 0;
+        indices |= best << (i * 2);
+        weights0[i] = WEIGHTS[best];
+        error += bestDistance;
+      }
+      if (error < bestError) {
+        bestError = error;
+        bestC0 = c0;
+        bestC1 = c1;
+        bestIndices = indices;
+      }
+      if (c0 == c1 || !leastSquaresEndpoints(texels, weights0, e0, e1))
+        break;
+    }
+
+    memcpy(out, &bestC0, 2);
+    memcpy(out + 2, &bestC1, 2);
+    memcpy(out + 4, &bestIndices, 4);
+  }
+
+  // One channel in BC4 layout, used for BC3 alpha, BC4 and both halves of BC5
+  inline void encodeChannelBlock(const BlockTexels &block, unsigned int channel, uint8_t *out) {
+    int lowest = 255, highest = 0;
+    for (unsigned int i = 0; i < 16; ++i) {
+      lowest = std::min(lowest, (int)block[i][channel]);
+      highest = std::max(highest, (int)block[i][channel]);
+    }
+
+    // e0 > e1 selects the 8 value mode; a flat block keeps every index at 0
+    int palette[8];
+    palette[0] = highest;
+    palette[1] = lowest;
+    for (int i = 2; i < 8; ++i)
+      palette[i] = ((8 - i) * highest + (i - 1) * lowest) / 7;
+
+    uint64_t bits = (uint64_t)highest | (uint64_t)lowest << 8;
+    if (highest != lowest) {
+      for (unsigned int i = 0; i < 16; ++i) {
+        int value = block[i][channel];
+        unsigned int best = 0;
+        for (unsigned int p = 1; p < 8; ++p)
+          if (std::abs(palette[p] - value) < std::abs(palette[best] - value))
+            best = p;
+        bits |= (uint64_t)best << (16 + i * 3);
+      }
+    }
+    memcpy(out, &bits, 8);
+  }
+
+  const int BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+  inline glm::vec4 bc7Interpolate(const glm::vec4 &e0, const glm::vec4 &e1, int weight) {
+    glm::vec4 value;
+    for (unsigned int c = 0; c < 4; ++c)
+      value[c] = (float)((((64 - weight) * (int)e0[c] + weight * (int)e1[c] + 32)) >> 6);
+    return value;
+  }
+
+  struct BitWriter {
+    uint64_t words[2] = { 0, 0 };
+    unsigned int position = 0;
+
+    void write(uint32_t value, unsigned int count) {
+      for (unsigned int i = 0; i < count; ++i, ++position)
+        if (value >> i & 1)
+          words[position / 64] |= (uint64_t)1 << (position % 64);
+    }
+  };
+
+  struct BitReader {
+    uint64_t words[2];
+    unsigned int position = 0;
+
+    explicit BitReader(const uint8_t *block) {
+      memcpy(words, block, 16);
+    }
+
+    uint32_t read(unsigned int count) {
+      uint32_t value = 0;
+      for (unsigned int i = 0; i < count; ++i, ++position)
+        value |= (uint32_t)(words[position / 64] >> (position % 64) & 1) << i;
+      return value;
+    }
+  };
+
+  inline void encodeBC7Block(const BlockTexels &block, uint8_t *out) {
+    glm::vec4 texels[16];
+    for (unsigned int i = 0; i < 16; ++i)
+      texels[i] = glm::vec4(block[i][0], block[i][1], block[i][2], block[i][3]);
+
+    glm::vec4 mean;
+    glm::vec4 axis = principalAxis(texels, 4, mean);
+    float lowest = 1e9f, highest = -1e9f;
+    for (unsigned int i = 0; i < 16; ++i) {
+      float t = glm::dot(texels[i] - mean, axis);
+      lowest = std::min(lowest, t);
+      highest = std::max(highest, t);
+    }
+    glm::vec4 e0 = glm::clamp(mean + axis * lowest, 0.0f, 255.0f);
+    glm::vec4 e1 = glm::clamp(mean + axis * highest, 0.0f, 255.0f);
+
+    glm::vec4 bestQ0, bestQ1;
+    unsigned int bestP0 = 0, bestP1 = 0;
+    unsigned int bestIndices[16] = {};
+    float bestError = 1e30f;
+    for (unsigned int iteration = 0; iteration < 2; ++iteration) {
+      float weights0[16];
+      float iterationError = 1e30f;
+      for (unsigned int pbits = 0; pbits < 4; ++pbits) {
+        // 1. 7 bit endpoints plus a shared low bit per endpoint
+        unsigned int p0 = pbits & 1, p1 = pbits >> 1;
+        glm::vec4 q0 = glm::clamp(glm::round((e0 - (float)p0) * 0.5f), 0.0f, 127.0f);
+        glm::vec4 q1 = glm::clamp(glm::round((e1 - (float)p1) * 0.5f), 0.0f, 127.0f);
+        glm::vec4 d0 = q0 * 2.0f + (float)p0;
+        glm::vec4 d1 = q1 * 2.0f + (float)p1;
+
+        // 2. Project onto the quantized segment, then check the neighbouring weights
+        glm::vec4 span = d1 - d0;
+        float spanLength = glm::dot(span, span);
+        unsigned int indices[16];
+        float error = 0.0f;
+        for (unsigned int i = 0; i < 16; ++i) {
+          float t = spanLength > 0.0f ? glm::dot(texels[i] - d0, span) / spanLength : 0.0f;
+          int guess = glm::clamp((int)std::lround(t * 15.0f), 0, 15);
+          float bestDistance = 1e30f;
+          for (int candidate = std::max(guess - 1, 0); candidate <= std::min(guess + 1, 15); ++candidate) {
+            glm::vec4 d = bc7Interpolate(d0, d1, BC7_WEIGHTS4[candidate]) - texels[i];
+            float distance = glm::dot(d, d);
+            if (distance < bestDistance) {
+              bestDistance = distance;
+              indices[i] = candidate;
+            }
+          }
+          error += bestDistance;
+        }
+
+        if (error < iterationError) {
+          iterationError = error;
+          for (unsigned int i = 0; i < 16; ++i)
+            weights0[i] = 1.0f - BC7_WEIGHTS4[indices[i]] / 64.0f;
+        }
+        if (error < bestError) {
+          bestError = error;
+          bestQ0 = q0;
+          bestQ1 = q1;
+          bestP0 = p0;
+          bestP1 = p1;
+          memcpy(bestIndices, indices, sizeof(indices));
+        }
+      }
+      if (!leastSquaresEndpoints(texels, weights0, e0, e1))
+        break;
+    }
+
+    // 3. The anchor (first) index is stored without its top bit, so flip the block if it's set
+    if (bestIndices[0] & 8) {
+      std::swap(bestQ0, bestQ1);
+      std::swap(bestP0, bestP1);
+      for (unsigned int &index : bestIndices)
+        index = 15 - index;
+    }
+
+    BitWriter writer;
+    writer.write(1 << 6, 7);
+    for (unsigned int c = 0; c < 4; ++c) {
+      writer.write((uint32_t)bestQ0[c], 7);
+      writer.write((uint32_t)bestQ1[c], 7);
+    }
+    writer.write(bestP0, 1);
+    writer.write(bestP1, 1);
+    writer.write(bestIndices[0], 3);
+    for (unsigned int i = 1; i < 16; ++i)
+      writer.write(bestIndices[i], 4);
+    memcpy(out, writer.words, 16);
+  }
+
+  inline void decodeColourBlock(const uint8_t *in, bool allowThreeColour, BlockTexels &block) {
+    uint16_t c0, c1;
+    uint32_t indices;
+    memcpy(&c0, in, 2);
+    memcpy(&c1, in + 2, 2);
+    memcpy(&indices, in + 4, 4);
+    glm::vec4 palette[4];
+    bc1Palette(c0, c1, !allowThreeColour || c0 > c1, palette);
+    for (unsigned int i = 0; i < 16; ++i) {
+      glm::vec4 colour = palette[indices >> (i * 2) & 3];
+      block[i][0] = (uint8_t)colour.r;
+      block[i][1] = (uint8_t)colour.g;
+      block[i][2] = (uint8_t)colour.b;
+    }
+  }
+
+  inline void decodeChannelBlock(const uint8_t *in, unsigned int channel, BlockTexels &block) {
+    uint64_t bits;
+    memcpy(&bits, in, 8);
+    int e0 = (int)(bits & 0xff), e1 = (int)(bits >> 8 & 0xff);
+    int palette[8] = { e0, e1 };
+    if (e0 > e1) {
+      for (int i = 2; i < 8; ++i)
+        palette[i] = ((8 - i) * e0 + (i - 1) * e1) / 7;
+    } else {
+      for (int i = 2; i < 6; ++i)
+        palette[i] = ((6 - i) * e0 + (i - 1) * e1) / 5;
+      palette[6] = 0;
+      palette[7] = 255;
+    }
+    for (unsigned int i = 0; i < 16; ++i)
+      block[i][channel] = (uint8_t)palette[bits >> (16 + i * 3) & 7];
+  }
+
+  // Mode 6 only, which is all encodeBC7Block writes; other modes decode as magenta
+  inline void decodeBC7Block(const uint8_t *in, BlockTexels &block) {
+    BitReader reader(in);
+    if (reader.read(7) != 1 << 6) {
+      for (unsigned int i = 0; i < 16; ++i) {
+        block[i][0] = 255; block[i][1] = 0; block[i][2] = 255; block[i][3] = 255;
+      }
+      return;
+    }
+    glm::vec4 q0, q1;
+    for (unsigned int c = 0; c < 4; ++c) {
+      q0[c] = (float)reader.read(7);
+      q1[c] = (float)reader.read(7);
+    }
+    float p0 = (float)reader.read(1), p1 = (float)reader.read(1);
+    glm::vec4 e0 = q0 * 2.0f + p0, e1 = q1 * 2.0f + p1;
+    for (unsigned int i = 0; i < 16; ++i) {
+      glm::vec4 value = bc7Interpolate(e0, e1, BC7_WEIGHTS4[reader.read(i == 0 ? 3 : 4)]);
+      for (unsigned int c = 0; c < 4; ++c)
+        block[i][c] = (uint8_t)value[c];
+    }
+  }
+}
+
+inline void encodeBlock(BlockFormat format, const BlockTexels &block, uint8_t *out) {
+  switch (format) {
+    case BlockFormat::BC1:
+      block_encoder::encodeColourBlock(block, out);
+      break;
+    case BlockFormat::BC3:
+      block_encoder::encodeChannelBlock(block, 3, out);
+      block_encoder::encodeColourBlock(block, out + 8);
+      break;
+    case BlockFormat::BC4:
+      block_encoder::encodeChannelBlock(block, 0, out);
+      break;
+    case BlockFormat::BC5:
+      block_encoder::encodeChannelBlock(block, 0, out);
+      block_encoder::encodeChannelBlock(block, 1, out + 8);
+      break;
+    case BlockFormat::BC7:
+      block_encoder::encodeBC7Block(block, out);
+      break;
+    default:
+      memset(out, 0, blockBytes(format));
+      break;
+  }
+}
+
+// Channels a format does not store come back as 0, alpha as 255
+inline void decodeBlock(BlockFormat format, const uint8_t *in, BlockTexels &block) {
+  for (unsigned int i = 0; i < 16; ++i) {
+    block[i][0] = block[i][1] = block[i][2] = 0;
+    block[i][3] = 255;
+  }
+  switch (format) {
+    case BlockFormat::BC1:
+      block_encoder::decodeColourBlock(in, true, block);
+      break;
+    case BlockFormat::BC3:
+      block_encoder::decodeChannelBlock(in, 3, block);
+      block_encoder::decodeColourBlock(in + 8, false, block);
+      break;
+    case BlockFormat::BC4:
+      block_encoder::decodeChannelBlock(in, 0, block);
+      break;
+    case BlockFormat::BC5:
+      block_encoder::decodeChannelBlock(in, 0, block);
+      block_encoder::decodeChannelBlock(in + 8, 1, block);
+      break;
+    case BlockFormat::BC7:
+      block_encoder::decodeBC7Block(in, block);
+      break;
+    default:
+      break;
+  }
+}
+
+// Copies the 4x4 block at (blockX, blockY) out of an RGBA8 image, clamping at the right and bottom edges
+inline void extractBlock(const uint8_t *rgba, unsigned int width, unsigned int height, unsigned int blockX, unsigned int blockY, BlockTexels &block) {
+  for (unsigned int y = 0; y < 4; ++y) {
+    unsigned int row = std::min(blockY * 4 + y, height - 1);
+    for (unsigned int x = 0; x < 4; ++x) {
+      unsigned int column = std::min(blockX * 4 + x, width - 1);
+      memcpy(block[y * 4 + x], rgba + ((size_t)row * width + column) * 4, 4);
+    }
+  }
+}
+
+// Encodes block rows [firstRow, lastRow) of an RGBA8 image into `out`, which holds the whole level
+inline void encodeBlockRows(BlockFormat format, const uint8_t *rgba, unsigned int width, unsigned int height,
+    unsigned int firstRow, unsigned int lastRow, uint8_t *out) {
+  unsigned int blocksWide = (width + 3) / 4;
+  size_t size = blockBytes(format);
+  BlockTexels block;
+  for (unsigned int blockY = firstRow; blockY < lastRow; ++blockY) {
+    for (unsigned int blockX = 0; blockX < blocksWide; ++blockX) {
+      extractBlock(rgba, width, height, blockX, blockY, block);
+      encodeBlock(format, block, out + ((size_t)blockY * blocksWide + blockX) * size);
+    }
+  }
+}
+
+inline unsigned int formatChannels(BlockFormat format) {
+  switch (format) {
+    case BlockFormat::BC1: return 3;
+    case BlockFormat::BC4: return 1;
+    case BlockFormat::BC5: return 2;
+    default: return 4;
+  }
+}
+
+// Peak signal to noise ratio of an encoded level against its RGBA8 source, over the stored channels
+inline double blockPSNR(BlockFormat format, const uint8_t *rgba, unsigned int width, unsigned int height, const uint8_t *encoded) {
+  unsigned int blocksWide = (width + 3) / 4;
+  unsigned int blocksHigh = (height + 3) / 4;
+  unsigned int channels = formatChannels(format);
+  size_t size = blockBytes(format);
+  double squaredError = 0.0;
+  BlockTexels decoded;
+  for (unsigned int blockY = 0; blockY < blocksHigh; ++blockY) {
+    for (unsigned int blockX = 0; blockX < blocksWide; ++blockX) {
+      decodeBlock(format, encoded + ((size_t)blockY * blocksWide + blockX) * size, decoded);
+      for (unsigned int i = 0; i < 16; ++i) {
+        unsigned int x = blockX * 4 + i % 4, y = blockY * 4 + i / 4;
+        if (x >= width || y >= height)
+          continue;
+        const uint8_t *source = rgba + ((size_t)y * width + x) * 4;
+        for (unsigned int c = 0; c < channels; ++c) {
+          double d = (double)source[c] - decoded[i][c];
+          squaredError += d * d;
+        }
+      }
+    }
+  }
+  double mse = squaredError / ((double)width * height * channels);
+  if (mse <= 0.0)
+    return 99.0;
+  return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+#endif
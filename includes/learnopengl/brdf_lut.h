@@ -0,0 +1,100 @@
+#ifndef BRDF_LUT_H
+#define BRDF_LUT_H
+
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "learnopengl/ibl_baker.h"
+#include "learnopengl/brdf_lut_table.h"
+
+using std::vector;
+
+/*
+* Split sum BRDF integration LUT
+*
+* The LUT only depends on NdotV and roughness, so instead of rendering it every launch it is
+* integrated once by tools/brdf-lut-generator (the same maths as brdf-fragment.glsl) and
+* embedded as brdf_lut_table.h: BRDF_LUT_SIZE^2 texels of (scale, bias) as 16 bit unorm,
+* row by row from roughness 0, sampled at texel centres like the fragment shader was.
+*
+*   createBrdfLutTexture()  uploads the table as an RG16 texture, no render pass
+*   brdfLut()               bilinear lookup of the same table for CPU side shading
+*/
+
+// Scale and bias applied to F0 for one NdotV / roughness pair, IBL variant of Schlick-GGX (k = a^2 / 2)
+inline glm::vec2 integrateBRDF(float nDotV, float roughness, unsigned int sampleCount) {
+  glm::vec3 v(std::sqrt(1.0f - nDotV * nDotV), 0.0f, nDotV);
+  float k = roughness * roughness * 0.5f;
+  auto geometry = [k](float nDotX) { return nDotX / (nDotX * (1.0f - k) + k); };
+
+  float a = 0.0f, b = 0.0f;
+  for (unsigned int i = 0; i < sampleCount; ++i) {
+    float pdf;
+    glm::vec3 h = ibl_baker::importanceSampleGGX(ibl_baker::hammersley(i, sampleCount), roughness, pdf);
+    glm::vec3 l = glm::normalize(2.0f * glm::dot(v, h) * h - v);
+    float nDotL = std::max(l.z, 0.0f);
+    float nDotH = std::max(h.z, 0.0f);
+    float vDotH = std::max(glm::dot(v, h), 0.0f);
+    if (nDotL <= 0.0f)
+      continue;
+
+    float visibility = geometry(nDotV) * geometry(nDotL) * vDotH / (nDotH * nDotV);
+    float fresnel = std::pow(1.0f - vDotH, 5.0f);
+    a += (1.0f - fresnel) * visibility;
+    b += fresnel * visibility;
+  }
+  return glm::vec2(a, b) / (float)sampleCount;
+}
+
+// size x size texels of interleaved (scale, bias) as 16 bit unorm, integrated on every core
+inline vector<uint16_t> buildBrdfLut(unsigned int size, unsigned int sampleCount) {
+  vector<uint16_t> table((size_t)size * size * 2);
+  ImageLoader::instance().parallelFor(size, [&](size_t y) {
+    float roughness = (y + 0.5f) / size;
+    for (unsigned int x = 0; x < size; ++x) {
+      glm::vec2 value = glm::clamp(integrateBRDF((x + 0.5f) / size, roughness, sampleCount), 0.0f, 1.0f);
+      table[(y * size + x) * 2 + 0] = (uint16_t)std::lround(value.x * 65535.0f);
+      table[(y * size + x) * 2 + 1] = (uint16_t)std::lround(value.y * 65535.0f);
+    }
+  });
+  return table;
+}
+
+// Bilinear, clamped to the texel centres at the edges like GL_CLAMP_TO_EDGE
+inline glm::vec2 brdfLut(float nDotV, float roughness) {
+  const int size = (int)BRDF_LUT_SIZE;
+  float x = glm::clamp(nDotV * size - 0.5f, 0.0f, size - 1.0f);
+  float y = glm::clamp(roughness * size - 0.5f, 0.0f, size - 1.0f);
+  int x0 = (int)x, y0 = (int)y;
+  int x1 = std::min(x0 + 1, size - 1), y1 = std::min(y0 + 1, size - 1);
+  float fx = x - x0, fy = y - y0;
+  auto texel = [size](int tx, int ty) {
+    const uint16_t *p = BRDF_LUT + (ty * size + tx) * 2;
+    return glm::vec2(p[0], p[1]) / 65535.0f;
+  };
+  return glm::mix(glm::mix(texel(x0, y0), texel(x1, y0), fx), glm::mix(texel(x0, y1), texel(x1, y1), fx), fy);
+}
+
+inline unsigned int createBrdfLutTexture() {
+  GLint alignment;
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+  unsigned int texture;
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16, BRDF_LUT_SIZE, BRDF_LUT_SIZE, 0, GL_RG, GL_UNSIGNED_SHORT, BRDF_LUT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+  return texture;
+}
+
+#endif
@@ -0,0 +1,524 @@
+#ifndef BRDF_LUT_TABLE_H
+#define BRDF_LUT_TABLE_H
+
+#include <cstdint>
+
+// Generated by tools/brdf-lut-generator, do not edit: split sum BRDF (scale, bias) as 16 bit unorm
+inline constexpr unsigned int BRDF_LUT_SIZE = 64;
+inline constexpr unsigned int BRDF_LUT_SAMPLES = 1024;
+inline constexpr uint16_t BRDF_LUT[8192] = {
+  2501, 62530, 7310, 58059, 11820, 53616, 16047, 49419, 20004, 45479, 23702, 41790, 27157, 38342, 30380, 35125,
+  33382, 32127, 36176, 29336, 38772, 26743, 41181, 24336, 43413, 22106, 45479, 20042, 47387, 18135, 49147, 16376,
+  50767, 14756, 52258, 13267, 53624, 11901, 54876, 10649, 56022, 9505, 57066, 8462, 58015, 7512, 58879, 6650,
+  59660, 5868, 60367, 5162, 61003, 4526, 61575, 3954, 62088, 3441, 62547, 2983, 62955, 2575, 63318, 2213,
+  63639, 1893, 63920, 1611, 64168, 1364, 64384, 1148, 64572, 960, 64735, 798, 64875, 658, 64994, 539,
+  65095, 437, 65180, 352, 65252, 280, 65312, 221, 65362, 172, 65402, 132, 65434, 100, 65459, 75,
+  65479, 55, 65495, 39, 65507, 27, 65515, 19, 65522, 12, 65527, 8, 65530, 5, 65531, 3,
+  65534, 1, 65534, 1, 65535, 0, 65535, 0, 65535, 0, 65535, 0, 65535, 0, 65535, 0,
+  2397, 58721, 7178, 56865, 11690, 52976, 15920, 49003, 19881, 45185, 23585, 41573, 27045, 38176, 30272, 34995,
+  33279, 32024, 36078, 29254, 38678, 26676, 41091, 24281, 43328, 22061, 45398, 20005, 47310, 18104, 49073, 16350,
+  50698, 14735, 52191, 13249, 53562, 11886, 54817, 10637, 55964, 9495, 57011, 8454, 57964, 7505, 58830, 6644,
+  59614, 5864, 60323, 5158, 60962, 4523, 61537, 3951, 62052, 3439, 62512, 2981, 62923, 2574, 63287, 2212,
+  63609, 1892, 63893, 1610, 64142, 1363, 64360, 1147, 64549, 960, 64713, 797, 64854, 658, 64975, 539,
+  65077, 437, 65164, 352, 65237, 280, 65298, 221, 65347, 172, 65388, 132, 65422, 100, 65448, 75,
+  65469, 55, 65486, 39, 65498, 27, 65508, 19, 65515, 12, 65520, 8, 65524, 5, 65527, 3,
+  65529, 1, 65530, 1, 65531, 0, 65532, 0, 65533, 0, 65534, 0, 65534, 0, 65535, 0,
+  2372, 51923, 6985, 54520, 11469, 51683, 15690, 48143, 19652, 44582, 23363, 41131, 26829, 37839, 30064, 34732,
+  33080, 31814, 35886, 29085, 38495, 26540, 40916, 24170, 43160, 21970, 45237, 19930, 47157, 18042, 48928, 16299,
+  50559, 14693, 52059, 13214, 53436, 11857, 54698, 10613, 55851, 9475, 56904, 8437, 57862, 7492, 58733, 6633,
+  59522, 5854, 60236, 5151, 60879, 4516, 61459, 3946, 61978, 3435, 62442, 2978, 62856, 2571, 63224, 2210,
+  63550, 1890, 63837, 1609, 64089, 1362, 64310, 1146, 64502, 959, 64669, 797, 64813, 658, 64936, 538,
+  65041, 437, 65130, 352, 65205, 280, 65268, 221, 65320, 172, 65363, 132, 65398, 100, 65427, 75,
+  65449, 55, 65467, 39, 65482, 27, 65493, 19, 65502, 12, 65508, 8, 65513, 5, 65518, 3,
+  65521, 1, 65523, 1, 65526, 0, 65528, 0, 65530, 0, 65531, 0, 65533, 0, 65534, 0,
+  2663, 44608, 6834, 51101, 11217, 49697, 15401, 46836, 19357, 43674, 23061, 40441, 26528, 37302, 29766, 34305,
+  32786, 31470, 35609, 28825, 38228, 26329, 40659, 23999, 42914, 21830, 45001, 19815, 46931, 17948, 48712, 16221,
+  50353, 14628, 51863, 13161, 53249, 11813, 54519, 10577, 55681, 9446, 56742, 8413, 57708, 7472, 58587, 6617,
+  59383, 5841, 60104, 5140, 60755, 4508, 61340, 3939, 61866, 3429, 62336, 2974, 62756, 2568, 63130, 2207,
+  63460, 1888, 63753, 1607, 64010, 1361, 64235, 1146, 64432, 958, 64603, 797, 64751, 657, 64878, 538,
+  64987, 437, 65079, 352, 65158, 280, 65224, 221, 65279, 172, 65325, 132, 65363, 100, 65394, 75,
+  65419, 55, 65440, 39, 65457, 27, 65470, 19, 65481, 12, 65490, 8, 65497, 5, 65503, 3,
+  65509, 1, 65513, 1, 65517, 0, 65521, 0, 65524, 0, 65528, 0, 65531, 0, 65534, 0,
+  3413, 39381, 6839, 46886, 11011, 47094, 15112, 45084, 19016, 42367, 22702, 39474, 26174, 36598, 29415, 33757,
+  32440, 31035, 35260, 28455, 37885, 26025, 40324, 23747, 42587, 21620, 44683, 19640, 46633, 17813, 48428, 16114,
+  50081, 14540, 51603, 13089, 53000, 11754, 54282, 10529, 55455, 9406, 56527, 8381, 57503, 7446, 58392, 6596,
+  59198, 5825, 59929, 5127, 60588, 4497, 61182, 3931, 61716, 3423, 62195, 2969, 62622, 2564, 63003, 2205,
+  63341, 1887, 63640, 1606, 63903, 1360, 64135, 1145, 64338, 958, 64514, 797, 64667, 658, 64800, 539,
+  64914, 437, 65011, 352, 65094, 281, 65165, 221, 65224, 172, 65274, 133, 65316, 100, 65351, 75,
+  65379, 55, 65403, 39, 65423, 28, 65440, 19, 65454, 12, 65466, 8, 65476, 5, 65484, 3,
+  65492, 1, 65499, 1, 65506, 0, 65512, 0, 65517, 0, 65523, 0, 65528, 0, 65533, 0,
+  4603, 36329, 7095, 42492, 10921, 43970, 14862, 42870, 18696, 40800, 22338, 38285, 25769, 35621, 28996, 32987,
+  32020, 30426, 34858, 27995, 37492, 25657, 39941, 23449, 42215, 21376, 44323, 19440, 46274, 17637, 48077, 15964,
+  49741, 14414, 51273, 12983, 52681, 11665, 53973, 10454, 55157, 9344, 56254, 8338, 57246, 7413, 58147, 6570,
+  58966, 5805, 59708, 5111, 60378, 4486, 60983, 3922, 61528, 3417, 62016, 2964, 62453, 2561, 62843, 2203,
+  63190, 1886, 63498, 1606, 63769, 1360, 64009, 1146, 64219, 959, 64403, 798, 64563, 659, 64702, 540,
+  64822, 439, 64925, 353, 65014, 282, 65090, 222, 65155, 173, 65210, 133, 65256, 101, 65296, 75,
+  65329, 55, 65357, 40, 65381, 28, 65402, 19, 65420, 13, 65435, 8, 65449, 5, 65461, 3,
+  65472, 2, 65482, 1, 65491, 0, 65500, 0, 65508, 0, 65517, 0, 65524, 0, 65532, 0,
+  6141, 34604, 7650, 38455, 11012, 40629, 14716, 40342, 18408, 38847, 21977, 36800, 25370, 34484, 28573, 32091,
+  31579, 29699, 34387, 27359, 37023, 25145, 39476, 23032, 41773, 21057, 43899, 19188, 45865, 17433, 47682, 15797,
+  49360, 14278, 50906, 12872, 52329, 11575, 53636, 10381, 54834, 9285, 55930, 8281, 56931, 7364, 57844, 6529,
+  58673, 5771, 59426, 5084, 60107, 4463, 60723, 3904, 61287, 3405, 61797, 2959, 62247, 2559, 62649, 2202,
+  63007, 1886, 63325, 1607, 63606, 1362, 63855, 1148, 64075, 961, 64267, 800, 64436, 661, 64583, 542,
+  64711, 441, 64821, 355, 64917, 283, 65000, 224, 65071, 175, 65132, 134, 65185, 102, 65230, 76,
+  65268, 56, 65302, 40, 65331, 28, 65356, 19, 65378, 13, 65398, 8, 65416, 5, 65432, 3,
+  65447, 2, 65461, 1, 65474, 0, 65486, 0, 65498, 0, 65509, 0, 65520, 0, 65530, 0,
+  7923, 33479, 8508, 35140, 11324, 37320, 14715, 37637, 18215, 36678, 21655, 35047, 24971, 33091, 28135, 30996,
+  31118, 28825, 33913, 26657, 36546, 24579, 38992, 22557, 41268, 20632, 43397, 18835, 45370, 17140, 47201, 15559,
+  48907, 14099, 50478, 12734, 51919, 11465, 53243, 10293, 54458, 9215, 55570, 8225, 56588, 7321, 57516, 6496,
+  58361, 5745, 59128, 5064, 59824, 4449, 60454, 3894, 61022, 3395, 61534, 2948, 61993, 2550, 62405, 2195,
+  62773, 1880, 63100, 1603, 63391, 1359, 63649, 1146, 63890, 962, 64103, 803, 64283, 665, 64441, 545,
+  64578, 444, 64698, 358, 64802, 286, 64893, 226, 64972, 177, 65040, 136, 65100, 104, 65151, 78,
+  65197, 57, 65236, 41, 65271, 29, 65302, 20, 65329, 13, 65354, 9, 65377, 5, 65398, 3,
+  65417, 2, 65435, 1, 65453, 0, 65469, 0, 65485, 0, 65500, 0, 65514, 0, 65528, 0,
+  9869, 32549, 9635, 32491, 11877, 34243, 14889, 34858, 18150, 34390, 21429, 33172, 24637, 31562, 27711, 29709,
+  30640, 27765, 33422, 25823, 36036, 23892, 38469, 21985, 40755, 20180, 42891, 18465, 44865, 16829, 46694, 15291,
+  48390, 13858, 49971, 12534, 51422, 11298, 52759, 10156, 53994, 9106, 55148, 8153, 56188, 7267, 57136, 6455,
+  57999, 5715, 58784, 5043, 59497, 4434, 60144, 3884, 60728, 3389, 61255, 2946, 61729, 2549, 62155, 2196,
+  62537, 1883, 62878, 1607, 63182, 1363, 63452, 1150, 63692, 965, 63904, 804, 64092, 665, 64257, 546,
+  64402, 444, 64529, 359, 64641, 287, 64739, 227, 64843, 179, 64928, 139, 64998, 106, 65059, 80,
+  65112, 59, 65159, 43, 65201, 30, 65238, 21, 65272, 14, 65303, 9, 65332, 6, 65358, 3,
+  65383, 2, 65406, 1, 65428, 1, 65449, 0, 65469, 0, 65489, 0, 65507, 0, 65525, 0,
+  11925, 31627, 10990, 30384, 12671, 31554, 15268, 32198, 18234, 32025, 21313, 31179, 24374, 29880, 27350, 28316,
+  30207, 26606, 32927, 24841, 35496, 23057, 37932, 21331, 40214, 19645, 42336, 18011, 44308, 16449, 46154, 14989,
+  47876, 13623, 49458, 12333, 50917, 11129, 52260, 10012, 53503, 8985, 54655, 8045, 55706, 7177, 56664, 6380,
+  57547, 5657, 58358, 5001, 59110, 4410, 59782, 3871, 60387, 3382, 60933, 2943, 61425, 2550, 61868, 2200,
+  62265, 1888, 62622, 1613, 62941, 1370, 63225, 1157, 63479, 972, 63704, 810, 63904, 671, 64081, 552,
+  64238, 450, 64377, 364, 64499, 291, 64607, 231, 64702, 181, 64787, 140, 64861, 107, 64927, 80,
+  64986, 59, 65039, 43, 65087, 30, 65149, 22, 65200, 15, 65241, 10, 65277, 7, 65310, 4,
+  65341, 2, 65371, 1, 65399, 1, 65425, 0, 65450, 0, 65475, 0, 65498, 0, 65520, 0,
+  14049, 30640, 12530, 28652, 13684, 29234, 15857, 29752, 18494, 29708, 21332, 29132, 24215, 28117, 27071, 26843,
+  29824, 25343, 32477, 23780, 34993, 22161, 37380, 20559, 39630, 18987, 41744, 17470, 43730, 16020, 45587, 14642,
+  47299, 13323, 48882, 12078, 50360, 10927, 51740, 9863, 53001, 8867, 54158, 7943, 55218, 7092, 56189, 6311,
+  57082, 5599, 57908, 4955, 58661, 4369, 59341, 3836, 59956, 3354, 60518, 2922, 61037, 2538, 61514, 2196,
+  61945, 1892, 62324, 1619, 62662, 1378, 62964, 1166, 63234, 981, 63475, 820, 63690, 680, 63881, 560,
+  64051, 458, 64202, 371, 64336, 298, 64456, 236, 64562, 186, 64657, 144, 64742, 110, 64817, 83,
+  64886, 62, 64947, 45, 65003, 32, 65054, 22, 65100, 15, 65143, 10, 65183, 6, 65221, 4,
+  65256, 2, 65317, 2, 65359, 1, 65394, 1, 65426, 0, 65457, 0, 65485, 0, 65512, 0,
+  16207, 29557, 14210, 27162, 14884, 27232, 16643, 27549, 18940, 27534, 21503, 27105, 24180, 26323, 26869, 25259,
+  29518, 24018, 32073, 22629, 34524, 21188, 36866, 19741, 39073, 18285, 41155, 16868, 43122, 15511, 44951, 14197,
+  46678, 12967, 48287, 11802, 49783, 10706, 51157, 9671, 52421, 8703, 53593, 7811, 54685, 6995, 55694, 6244,
+  56609, 5550, 57443, 4914, 58204, 4334, 58896, 3809, 59526, 3333, 60110, 2909, 60645, 2530, 61125, 2189,
+  61556, 1884, 61943, 1613, 62290, 1373, 62614, 1165, 62918, 985, 63186, 826, 63432, 690, 63644, 570,
+  63832, 468, 63999, 380, 64149, 306, 64282, 244, 64401, 192, 64508, 150, 64604, 115, 64691, 87,
+  64769, 65, 64841, 48, 64906, 34, 64966, 24, 65021, 17, 65072, 11, 65120, 7, 65165, 4,
+  65207, 3, 65247, 1, 65285, 1, 65321, 0, 65355, 0, 65420, 0, 65463, 0, 65495, 0,
+  18365, 28394, 15992, 25819, 16235, 25483, 17601, 25566, 19559, 25515, 21838, 25174, 24282, 24544, 26787, 23669,
+  29288, 22613, 31738, 21427, 34116, 20172, 36377, 18845, 38537, 17525, 40594, 16234, 42527, 14963, 44336, 13731,
+  46048, 12570, 47641, 11459, 49124, 10410, 50520, 9436, 51812, 8523, 53017, 7676, 54117, 6882, 55124, 6146,
+  56046, 5467, 56906, 4853, 57704, 4296, 58433, 3788, 59091, 3323, 59687, 2903, 60228, 2524, 60718, 2185,
+  61162, 1882, 61568, 1615, 61941, 1379, 62287, 1173, 62591, 990, 62862, 830, 63105, 692, 63323, 572,
+  63518, 469, 63719, 384, 63895, 312, 64046, 250, 64199, 199, 64327, 157, 64439, 122, 64541, 93,
+  64632, 70, 64716, 52, 64792, 38, 64862, 27, 64927, 19, 64988, 13, 65044, 8, 65097, 5,
+  65147, 3, 65195, 2, 65239, 1, 65281, 1, 65320, 0, 65354, 0, 65366, 0, 65397, 0,
+  20497, 27168, 17837, 24570, 17702, 23935, 18706, 23809, 20338, 23693, 22328, 23364, 24527, 22832, 26829, 22100,
+  29165, 21205, 31481, 20180, 33743, 19062, 35940, 17911, 38047, 16732, 40040, 15532, 41936, 14363, 43736, 13237,
+  45428, 12148, 47002, 11096, 48482, 10106, 49868, 9176, 51151, 8297, 52349, 7482, 53472, 6730, 54502, 6028,
+  55469, 5387, 56353, 4793, 57156, 4245, 57887, 3743, 58557, 3288, 59183, 2881, 59762, 2516, 60290, 2187,
+  60762, 1890, 61188, 1624, 61573, 1388, 61921, 1180, 62235, 997, 62519, 837, 62786, 700, 63028, 581,
+  63254, 480, 63451, 392, 63627, 318, 63785, 255, 63928, 202, 64057, 158, 64186, 124, 64318, 96,
+  64431, 73, 64529, 55, 64637, 41, 64727, 30, 64806, 21, 64879, 15, 64947, 10, 65009, 7,
+  65068, 4, 65121, 3, 65169, 2, 65203, 1, 65197, 1, 65249, 0, 65299, 0, 65347, 0,
+  22582, 25902, 19713, 23377, 19252, 22540, 19926, 22231, 21245, 22003, 22961, 21701, 24909, 21215, 26995, 20577,
+  29147, 19804, 31317, 18924, 33456, 17946, 35546, 16914, 37569, 15857, 39520, 14798, 41376, 13737, 43124, 12682,
+  44783, 11669, 46356, 10703, 47834, 9780, 49206, 8894, 50485, 8060, 51691, 7287, 52807, 6562, 53834, 5884,
+  54796, 5262, 55694, 4693, 56524, 4170, 57292, 3692, 58000, 3256, 58645, 2859, 59231, 2497, 59763, 2171,
+  60248, 1878, 60706, 1621, 61126, 1392, 61515, 1190, 61859, 1010, 62167, 851, 62446, 713, 62698, 592,
+  62925, 489, 63131, 400, 63322, 325, 63504, 262, 63673, 210, 63828, 167, 63964, 130, 64087, 100,
+  64198, 76, 64301, 57, 64394, 42, 64498, 31, 64590, 22, 64686, 16, 64763, 11, 64837, 8,
+  64887, 6, 64926, 4, 64998, 3, 65066, 2, 65130, 1, 65191, 1, 65251, 0, 65307, 0,
+  24601, 24619, 21592, 22222, 20856, 21267, 21237, 20818, 22269, 20501, 23715, 20162, 25424, 19717, 27294, 19150,
+  29257, 18467, 31259, 17689, 33265, 16836, 35241, 15923, 37173, 14981, 39033, 14012, 40831, 13056, 42552, 12113,
+  44183, 11183, 45713, 10273, 47160, 9404, 48528, 8582, 49819, 7809, 51023, 7076, 52134, 6382, 53169, 5736,
+  54145, 5144, 55045, 4594, 55865, 4082, 56633, 3617, 57348, 3195, 58014, 2812, 58630, 2466, 59205, 2155,
+  59722, 1872, 60189, 1616, 60611, 1388, 61004, 1186, 61359, 1008, 61701, 854, 62014, 720, 62304, 603,
+  62562, 500, 62792, 412, 63000, 336, 63188, 271, 63359, 217, 63514, 172, 63656, 134, 63800, 105,
+  63926, 80, 64054, 61, 64161, 46, 64250, 34, 64314, 24, 64352, 17, 64441, 12, 64540, 8,
+  64631, 6, 64719, 4, 64814, 3, 64895, 2, 64994, 1, 65076, 1, 65149, 0, 65217, 0,
+  26544, 23338, 23453, 21102, 22486, 20079, 22606, 19518, 23379, 19129, 24573, 18753, 26050, 18331, 27706, 17804,
+  29477, 17195, 31312, 16505, 33167, 15743, 35019, 14934, 36847, 14098, 38624, 13233, 40344, 12361, 41992, 11490,
+  43582, 10649, 45096, 9827, 46531, 9031, 47870, 8255, 49133, 7521, 50324, 6830, 51451, 6186, 52503, 5581,
+  53480, 5014, 54381, 4485, 55216, 3996, 56008, 3553, 56735, 3144, 57397, 2768, 58005, 2426, 58586, 2123,
+  59115, 1847, 59599, 1599, 60066, 1382, 60500, 1189, 60885, 1015, 61231, 860, 61544, 724, 61828, 604,
+  62085, 501, 62348, 416, 62594, 342, 62817, 280, 63017, 226, 63194, 181, 63349, 142, 63483, 111,
+  63588, 85, 63655, 65, 63780, 48, 63912, 36, 64029, 26, 64154, 19, 64263, 14, 64362, 9,
+  64455, 6, 64542, 4, 64628, 3, 64729, 2, 64813, 1, 64908, 1, 64998, 0, 65110, 0,
+  28401, 22074, 25276, 20013, 24121, 18962, 24016, 18335, 24555, 17887, 25517, 17475, 26769, 17040, 28228, 16570,
+  29809, 16006, 31473, 15385, 33183, 14713, 34899, 13983, 36609, 13230, 38293, 12459, 39932, 11673, 41522, 10892,
+  43046, 10113, 44503, 9350, 45903, 8620, 47234, 7915, 48498, 7242, 49671, 6589, 50780, 5977, 51815, 5399,
+  52797, 4865, 53722, 4371, 54584, 3911, 55377, 3482, 56111, 3088, 56788, 2725, 57435, 2401, 58023, 2104,
+  58562, 1833, 59052, 1589, 59517, 1373, 59953, 1182, 60349, 1011, 60716, 860, 61065, 729, 61387, 615,
+  61677, 514, 61939, 426, 62171, 350, 62373, 285, 62546, 230, 62682, 185, 62880, 148, 63066, 117,
+  63244, 92, 63411, 71, 63561, 54, 63699, 40, 63827, 29, 63946, 21, 64065, 15, 64185, 11,
+  64302, 8, 64415, 5, 64515, 3, 64608, 2, 64694, 1, 64792, 1, 64883, 1, 64958, 0,
+  30168, 20838, 27048, 18952, 25744, 17906, 25444, 17239, 25771, 16739, 26524, 16306, 27573, 15874, 28826, 15399,
+  30236, 14904, 31730, 14331, 33284, 13718, 34874, 13078, 36460, 12395, 38036, 11697, 39582, 10986, 41095, 10278,
+  42557, 9571, 43973, 8883, 45320, 8204, 46606, 7547, 47841, 6924, 49009, 6326, 50118, 5762, 51151, 5220,
+  52125, 4713, 53035, 4239, 53885, 3797, 54698, 3395, 55456, 3023, 56163, 2681, 56811, 2365, 57413, 2077,
+  57964, 1815, 58494, 1583, 58974, 1372, 59413, 1182, 59812, 1012, 60184, 863, 60532, 733, 60843, 617,
+  61123, 518, 61361, 432, 61597, 358, 61860, 294, 62101, 240, 62319, 193, 62519, 153, 62708, 121,
+  62896, 95, 63087, 74, 63262, 57, 63427, 44, 63581, 33, 63720, 24, 63848, 17, 63968, 12,
+  64092, 8, 64213, 6, 64334, 4, 64453, 3, 64561, 2, 64644, 1, 64710, 1, 64827, 0,
+  31841, 19639, 28757, 17922, 27337, 16900, 26871, 16216, 27014, 15688, 27577, 15238, 28434, 14794, 29507, 14343,
+  30729, 13850, 32072, 13350, 33475, 12788, 34919, 12196, 36392, 11593, 37857, 10960, 39307, 10317, 40735, 9675,
+  42127, 9036, 43472, 8400, 44771, 7781, 46026, 7184, 47218, 6603, 48352, 6045, 49440, 5520, 50470, 5021,
+  51449, 4553, 52359, 4107, 53208, 3688, 54011, 3302, 54753, 2941, 55453, 2612, 56127, 2316, 56749, 2043,
+  57330, 1795, 57860, 1567, 58350, 1363, 58792, 1178, 59208, 1015, 59576, 870, 59873, 739, 60199, 625,
+  60528, 524, 60847, 439, 61137, 364, 61400, 299, 61668, 245, 61924, 200, 62160, 162, 62371, 129,
+  62570, 101, 62757, 79, 62927, 60, 63091, 46, 63253, 34, 63424, 26, 63577, 19, 63735, 14,
+  63872, 10, 63993, 7, 64096, 5, 64179, 3, 64305, 2, 64429, 1, 64569, 1, 64666, 1,
+  33418, 18482, 30394, 16926, 28888, 15943, 28283, 15255, 28264, 14714, 28653, 14241, 29339, 13804, 30239, 13358,
+  31301, 12900, 32475, 12411, 33741, 11915, 35051, 11376, 36389, 10815, 37748, 10252, 39102, 9673, 40438, 9087,
+  41751, 8505, 43029, 7927, 44276, 7365, 45471, 6811, 46619, 6274, 47728, 5765, 48783, 5274, 49781, 4805,
+  50740, 4367, 51653, 3957, 52512, 3570, 53322, 3209, 54064, 2866, 54769, 2554, 55423, 2265, 56026, 1999,
+  56586, 1757, 57116, 1542, 57590, 1346, 58003, 1170, 58447, 1011, 58886, 869, 59288, 742, 59672, 631,
+  60037, 535, 60366, 448, 60665, 372, 60947, 307, 61230, 253, 61490, 207, 61725, 166, 61949, 133,
+  62174, 106, 62399, 85, 62598, 66, 62777, 51, 62939, 38, 63096, 28, 63245, 21, 63381, 15,
+  63536, 11, 63685, 8, 63836, 6, 63969, 4, 64094, 3, 64210, 2, 64319, 1, 64432, 1,
+  34897, 17374, 31953, 15967, 30387, 15031, 29666, 14351, 29506, 13803, 29743, 13328, 30270, 12888, 31013, 12450,
+  31920, 12012, 32947, 11557, 34062, 11083, 35248, 10604, 36465, 10093, 37701, 9568, 38953, 9046, 40203, 8521,
+  41432, 7990, 42639, 7464, 43817, 6948, 44961, 6443, 46069, 5955, 47129, 5480, 48145, 5025, 49118, 4592,
+  50043, 4180, 50920, 3790, 51759, 3428, 52563, 3093, 53308, 2776, 54021, 2487, 54665, 2213, 55244, 1959,
+  55769, 1729, 56287, 1518, 56822, 1327, 57328, 1155, 57815, 1003, 58264, 865, 58693, 743, 59095, 634,
+  59472, 539, 59817, 453, 60146, 380, 60463, 317, 60750, 261, 61011, 213, 61257, 172, 61507, 139,
+  61745, 112, 61956, 88, 62149, 69, 62338, 54, 62523, 42, 62721, 32, 62900, 24, 63063, 17,
+  63212, 12, 63367, 9, 63528, 6, 63683, 5, 63804, 3, 63941, 2, 64041, 1, 64141, 1,
+  36280, 16315, 33428, 15045, 31825, 14162, 31010, 13496, 30729, 12955, 30831, 12481, 31214, 12038, 31815, 11619,
+  32575, 11191, 33464, 10763, 34444, 10320, 35493, 9866, 36598, 9413, 37727, 8937, 38867, 8451, 40012, 7964,
+  41163, 7490, 42293, 7011, 43402, 6540, 44486, 6080, 45536, 5630, 46555, 5197, 47533, 4779, 48469, 4378,
+  49364, 3996, 50213, 3634, 51014, 3292, 51763, 2970, 52467, 2671, 53127, 2397, 53722, 2143, 54392, 1909,
+  55029, 1694, 55612, 1492, 56163, 1309, 56682, 1144, 57166, 993, 57623, 859, 58061, 740, 58478, 634,
+  58867, 541, 59225, 457, 59578, 386, 59911, 323, 60212, 268, 60500, 221, 60773, 181, 61020, 147,
+  61234, 118, 61451, 93, 61678, 73, 61899, 57, 62101, 44, 62291, 34, 62482, 25, 62673, 19,
+  62836, 14, 62986, 10, 63132, 7, 63279, 5, 63415, 3, 63555, 2, 63721, 1, 63884, 1,
+  37566, 15308, 34817, 14161, 33195, 13333, 32305, 12689, 31921, 12159, 31903, 11689, 32160, 11257, 32627, 10841,
+  33258, 10437, 34012, 10024, 34866, 9611, 35791, 9188, 36771, 8759, 37796, 8335, 38841, 7898, 39890, 7452,
+  40938, 7006, 41986, 6571, 43024, 6144, 44038, 5721, 45029, 5310, 45991, 4913, 46918, 4528, 47813, 4161,
+  48663, 3808, 49471, 3473, 50228, 3156, 50926, 2858, 51595, 2576, 52311, 2313, 52987, 2067, 53643, 1844,
+  54280, 1641, 54880, 1454, 55456, 1284, 55992, 1127, 56487, 983, 56959, 853, 57402, 737, 57811, 632,
+  58207, 540, 58587, 460, 58943, 389, 59275, 327, 59574, 273, 59863, 226, 60166, 187, 60447, 152,
+  60722, 124, 60979, 100, 61219, 79, 61434, 62, 61634, 48, 61832, 37, 62003, 28, 62176, 21,
+  62354, 15, 62544, 11, 62718, 8, 62862, 6, 63029, 4, 63206, 2, 63382, 2, 63558, 1,
+  38756, 14354, 36117, 13318, 34493, 12544, 33545, 11926, 33074, 11413, 32952, 10954, 33095, 10531, 33442, 10126,
+  33951, 9737, 34584, 9344, 35315, 8951, 36124, 8559, 36990, 8159, 37898, 7757, 38845, 7365, 39807, 6965,
+  40768, 6559, 41726, 6155, 42678, 5759, 43623, 5377, 44541, 4998, 45438, 4633, 46303, 4280, 47133, 3941,
+  47916, 3614, 48656, 3308, 49377, 3012, 50159, 2735, 50906, 2475, 51623, 2231, 52300, 2002, 52946, 1790,
+  53551, 1591, 54132, 1410, 54686, 1245, 55229, 1098, 55746, 964, 56237, 843, 56691, 732, 57114, 631,
+  57515, 542, 57877, 462, 58220, 391, 58572, 330, 58912, 277, 59236, 231, 59538, 191, 59818, 156,
+  60092, 127, 60352, 103, 60579, 82, 60816, 66, 61053, 52, 61286, 40, 61500, 30, 61710, 23,
+  61911, 17, 62080, 12, 62281, 9, 62485, 6, 62694, 5, 62864, 3, 63002, 2, 63132, 1,
+  39853, 13452, 37327, 12515, 35714, 11793, 34723, 11208, 34179, 10710, 33967, 10266, 34007, 9853, 34247, 9464,
+  34642, 9083, 35166, 8718, 35783, 8343, 36480, 7971, 37238, 7601, 38040, 7227, 38875, 6855, 39743, 6494,
+  40621, 6130, 41495, 5761, 42367, 5400, 43224, 5043, 44067, 4698, 44891, 4366, 45673, 4038, 46418, 3725,
+  47144, 3426, 47956, 3141, 48736, 2868, 49495, 2612, 50217, 2368, 50912, 2140, 51579, 1926, 52223, 1729,
+  52829, 1544, 53406, 1374, 53950, 1216, 54463, 1071, 54956, 940, 55418, 822, 55867, 717, 56305, 624,
+  56734, 538, 57135, 461, 57517, 394, 57879, 334, 58207, 280, 58514, 233, 58824, 194, 59111, 160,
+  59392, 131, 59679, 106, 59955, 85, 60225, 68, 60477, 54, 60717, 42, 60944, 33, 61156, 25,
+  61386, 19, 61609, 14, 61833, 10, 62034, 7, 62219, 5, 62412, 3, 62572, 2, 62732, 1,
+  40859, 12600, 38447, 11753, 36855, 11083, 35835, 10530, 35230, 10049, 34940, 9623, 34892, 9226, 35034, 8848,
+  35327, 8482, 35743, 8128, 36260, 7783, 36850, 7431, 37504, 7083, 38204, 6736, 38938, 6388, 39699, 6045,
+  40486, 5716, 41276, 5384, 42064, 5056, 42837, 4730, 43590, 4411, 44314, 4100, 45001, 3804, 45802, 3518,
+  46590, 3240, 47358, 2974, 48108, 2723, 48837, 2486, 49535, 2260, 50213, 2050, 50858, 1850, 51476, 1663,
+  52066, 1490, 52635, 1331, 53173, 1184, 53677, 1048, 54148, 922, 54621, 807, 55076, 704, 55504, 611,
+  55912, 528, 56319, 456, 56713, 391, 57083, 333, 57432, 282, 57765, 237, 58105, 198, 58418, 163,
+  58728, 134, 59034, 110, 59321, 89, 59589, 71, 59827, 56, 60100, 44, 60366, 35, 60617, 27,
+  60874, 20, 61102, 15, 61310, 11, 61516, 8, 61694, 6, 61851, 4, 62055, 2, 62247, 1,
+  41776, 11799, 39479, 11031, 37916, 10411, 36876, 9889, 36223, 9428, 35866, 9019, 35738, 8638, 35792, 8274,
+  35994, 7927, 36311, 7585, 36728, 7256, 37224, 6930, 37777, 6603, 38380, 6280, 39019, 5960, 39680, 5637,
+  40359, 5322, 41055, 5019, 41751, 4721, 42436, 4428, 43088, 4135, 43780, 3852, 44552, 3576, 45311, 3311,
+  46060, 3058, 46787, 2814, 47495, 2581, 48181, 2360, 48841, 2149, 49490, 1954, 50108, 1768, 50706, 1597,
+  51265, 1433, 51798, 1283, 52322, 1143, 52848, 1016, 53342, 899, 53818, 791, 54279, 693, 54719, 603,
+  55145, 523, 55548, 451, 55924, 387, 56323, 331, 56708, 282, 57074, 239, 57424, 200, 57757, 167,
+  58078, 139, 58364, 113, 58631, 91, 58929, 74, 59216, 59, 59490, 47, 59739, 36, 59984, 28,
+  60224, 21, 60450, 16, 60665, 12, 60871, 9, 61079, 6, 61303, 4, 61488, 2, 61695, 1,
+  42606, 11045, 40422, 10349, 38896, 9775, 37846, 9283, 37154, 8846, 36738, 8452, 36541, 8088, 36518, 7743,
+  36633, 7409, 36863, 7085, 37186, 6768, 37587, 6462, 38048, 6157, 38555, 5854, 39100, 5556, 39670, 5262,
+  40254, 4969, 40837, 4677, 41425, 4400, 42002, 4133, 42700, 3869, 43424, 3609, 44142, 3358, 44845, 3113,
+  45537, 2877, 46217, 2653, 46884, 2440, 47525, 2234, 48150, 2041, 48752, 1858, 49319, 1683, 49869, 1522,
+  50430, 1371, 50984, 1233, 51516, 1102, 52040, 981, 52538, 869, 53034, 770, 53503, 678, 53942, 594,
+  54379, 518, 54796, 447, 55196, 385, 55588, 330, 55958, 281, 56315, 238, 56666, 202, 56990, 169,
+  57308, 140, 57633, 116, 57955, 95, 58257, 77, 58534, 61, 58810, 49, 59074, 39, 59315, 30,
+  59541, 23, 59757, 17, 59979, 12, 60219, 9, 60452, 6, 60649, 4, 60910, 3, 61121, 2,
+  43353, 10338, 41279, 9706, 39794, 9175, 38742, 8712, 38020, 8301, 37555, 7921, 37296, 7575, 37202, 7245,
+  37240, 6926, 37389, 6620, 37625, 6318, 37935, 6025, 38308, 5743, 38723, 5459, 39173, 5179, 39648, 4906,
+  40138, 4638, 40626, 4373, 41107, 4107, 41756, 3852, 42420, 3610, 43084, 3375, 43745, 3146, 44394, 2922,
+  45033, 2706, 45655, 2497, 46261, 2298, 46852, 2109, 47430, 1930, 47978, 1759, 48552, 1600, 49125, 1451,
+  49681, 1309, 50223, 1178, 50749, 1057, 51264, 946, 51746, 841, 52209, 745, 52670, 656, 53132, 577,
+  53582, 506, 54006, 441, 54419, 382, 54803, 329, 55164, 281, 55507, 239, 55858, 201, 56206, 169,
+  56554, 142, 56892, 118, 57200, 97, 57501, 79, 57795, 64, 58074, 51, 58331, 40, 58585, 31,
+  58845, 24, 59098, 18, 59330, 14, 59557, 10, 59780, 7, 60042, 5, 60256, 3, 60464, 2,
+  44019, 9676, 42053, 9100, 40611, 8609, 39563, 8174, 38819, 7787, 38313, 7426, 37999, 7093, 37841, 6779,
+  37810, 6479, 37881, 6185, 38040, 5903, 38264, 5623, 38547, 5352, 38877, 5093, 39235, 4831, 39613, 4574,
+  40003, 4325, 40428, 4081, 41005, 3841, 41583, 3601, 42167, 3370, 42756, 3148, 43352, 2939, 43942, 2735,
+  44519, 2535, 45094, 2346, 45651, 2163, 46185, 1988, 46748, 1822, 47323, 1666, 47882, 1517, 48426, 1377,
+  48956, 1247, 49475, 1126, 49966, 1011, 50452, 905, 50945, 808, 51433, 720, 51895, 637, 52342, 562,
+  52759, 491, 53168, 429, 53570, 374, 53953, 324, 54355, 279, 54737, 239, 55095, 203, 55439, 171,
+  55763, 143, 56075, 118, 56395, 98, 56705, 81, 56986, 65, 57261, 53, 57540, 42, 57805, 33,
+  58062, 25, 58324, 19, 58594, 15, 58864, 11, 59112, 8, 59332, 5, 59521, 3, 59728, 2,
+  44608, 9055, 42745, 8530, 41350, 8076, 40311, 7670, 39550, 7303, 39010, 6962, 38648, 6642, 38433, 6345,
+  38336, 6059, 38338, 5782, 38420, 5513, 38569, 5252, 38766, 4993, 39006, 4745, 39279, 4506, 39563, 4266,
+  39898, 4031, 40391, 3804, 40901, 3583, 41420, 3368, 41937, 3152, 42455, 2943, 42981, 2745, 43505, 2555,
+  44027, 2374, 44535, 2200, 45066, 2031, 45625, 1872, 46172, 1719, 46706, 1573, 47231, 1436, 47750, 1309,
+  48243, 1186, 48738, 1072, 49236, 966, 49727, 869, 50197, 777, 50654, 692, 51094, 614, 51530, 545,
+  51938, 480, 52334, 420, 52734, 366, 53121, 317, 53504, 274, 53873, 236, 54242, 202, 54599, 171,
+  54929, 144, 55245, 121, 55537, 100, 55816, 82, 56099, 67, 56388, 54, 56682, 43, 56956, 34,
+  57227, 27, 57509, 20, 57769, 15, 58033, 11, 58282, 8, 58496, 6, 58749, 4, 58999, 2,
+  45123, 8475, 43359, 7995, 42011, 7574, 40985, 7195, 40213, 6849, 39645, 6528, 39241, 6223, 38973, 5938,
+  38818, 5666, 38755, 5405, 38766, 5149, 38840, 4903, 38961, 4663, 39114, 4425, 39295, 4198, 39531, 3978,
+  39934, 3759, 40356, 3545, 40795, 3339, 41247, 3139, 41712, 2946, 42174, 2755, 42632, 2569, 43087, 2391,
+  43555, 2222, 44076, 2061, 44602, 1909, 45116, 1761, 45626, 1621, 46124, 1488, 46609, 1361, 47093, 1241,
+  47584, 1128, 48070, 1023, 48533, 923, 48986, 830, 49431, 745, 49862, 666, 50271, 592, 50670, 525,
+  51086, 463, 51499, 408, 51891, 358, 52275, 312, 52643, 269, 52996, 231, 53342, 198, 53673, 169,
+  53994, 144, 54306, 121, 54609, 101, 54916, 83, 55213, 68, 55490, 55, 55767, 44, 56067, 35,
+  56356, 27, 56628, 21, 56894, 16, 57126, 12, 57357, 8, 57636, 6, 57898, 4, 58147, 2,
+  45567, 7932, 43897, 7493, 42597, 7103, 41587, 6750, 40809, 6423, 40217, 6120, 39778, 5831, 39463, 5558,
+  39254, 5300, 39130, 5052, 39077, 4812, 39077, 4577, 39124, 4352, 39200, 4131, 39308, 3912, 39622, 3705,
+  39962, 3504, 40318, 3304, 40695, 3112, 41086, 2926, 41483, 2747, 41885, 2574, 42290, 2405, 42736, 2241,
+  43206, 2083, 43680, 1934, 44150, 1791, 44617, 1655, 45080, 1527, 45534, 1402, 46012, 1286, 46481, 1176,
+  46936, 1070, 47384, 972, 47821, 880, 48247, 795, 48650, 714, 49040, 638, 49456, 570, 49858, 506,
+  50248, 448, 50633, 394, 51007, 346, 51379, 303, 51732, 263, 52072, 228, 52380, 195, 52689, 167,
+  53009, 141, 53325, 119, 53650, 100, 53965, 84, 54267, 69, 54584, 56, 54879, 45, 55157, 36,
+  55439, 28, 55711, 22, 55960, 17, 56226, 12, 56493, 9, 56769, 6, 57010, 4, 57265, 2,
+  45943, 7426, 44362, 7023, 43110, 6661, 42119, 6331, 41338, 6022, 40728, 5737, 40257, 5466, 39901, 5205,
+  39642, 4959, 39462, 4723, 39347, 4496, 39282, 4274, 39255, 4060, 39256, 3853, 39454, 3650, 39702, 3451,
+  39982, 3263, 40285, 3082, 40598, 2902, 40919, 2728, 41247, 2560, 41609, 2401, 42023, 2248, 42450, 2100,
+  42870, 1954, 43287, 1814, 43703, 1681, 44116, 1554, 44552, 1434, 44995, 1321, 45425, 1212, 45850, 1109,
+  46271, 1013, 46679, 922, 47071, 836, 47452, 755, 47863, 681, 48263, 612, 48657, 548, 49039, 487,
+  49416, 433, 49781, 382, 50129, 336, 50460, 294, 50780, 256, 51114, 223, 51443, 192, 51764, 165,
+  52079, 140, 52379, 118, 52676, 99, 52999, 83, 53313, 69, 53620, 56, 53933, 46, 54230, 37,
+  54491, 29, 54747, 23, 55035, 17, 55317, 13, 55593, 9, 55840, 7, 56078, 4, 56316, 3,
+  46256, 6953, 44759, 6583, 43554, 6247, 42583, 5938, 41802, 5649, 41177, 5379, 40680, 5123, 40288, 4876,
+  39983, 4641, 39752, 4416, 39579, 4200, 39452, 3993, 39357, 3788, 39414, 3592, 39580, 3403, 39778, 3220,
+  39996, 3041, 40234, 2871, 40486, 2706, 40754, 2545, 41053, 2389, 41409, 2239, 41775, 2097, 42147, 1961,
+  42524, 1831, 42892, 1702, 43268, 1578, 43665, 1460, 44060, 1348, 44452, 1242, 44841, 1141, 45228, 1048,
+  45597, 957, 45960, 872, 46340, 793, 46724, 719, 47109, 649, 47484, 584, 47852, 524, 48210, 468,
+  48559, 417, 48887, 369, 49213, 326, 49537, 286, 49863, 250, 50172, 218, 50497, 188, 50816, 162,
+  51133, 139, 51462, 119, 51765, 99, 52074, 83, 52376, 69, 52669, 57, 52943, 46, 53199, 37,
+  53490, 30, 53778, 23, 54055, 18, 54322, 13, 54550, 10, 54809, 7, 55068, 5, 55309, 3,
+  46507, 6511, 45090, 6170, 43931, 5858, 42982, 5569, 42203, 5298, 41566, 5042, 41045, 4801, 40622, 4568,
+  40277, 4345, 39998, 4131, 39772, 3926, 39587, 3728, 39495, 3538, 39574, 3352, 39690, 3175, 39832, 3004,
+  39992, 2836, 40169, 2674, 40375, 2522, 40621, 2376, 40917, 2232, 41220, 2093, 41529, 1958, 41845, 1831,
+  42165, 1709, 42515, 1594, 42871, 1481, 43224, 1372, 43571, 1268, 43916, 1169, 44254, 1075, 44582, 986,
+  44919, 903, 45276, 825, 45634, 750, 45991, 681, 46345, 617, 46689, 556, 47023, 500, 47342, 448,
+  47664, 400, 47975, 356, 48296, 315, 48601, 277, 48922, 243, 49228, 212, 49534, 184, 49855, 159,
+  50174, 136, 50496, 117, 50813, 99, 51113, 84, 51387, 69, 51645, 57, 51905, 46, 52196, 38,
+  52476, 30, 52745, 24, 53004, 18, 53229, 14, 53495, 10, 53746, 7, 53989, 5, 54260, 3,
+  46700, 6099, 45358, 5785, 44244, 5494, 43317, 5224, 42543, 4969, 41897, 4727, 41357, 4499, 40905, 4281,
+  40524, 4069, 40202, 3866, 39928, 3670, 39691, 3484, 39676, 3304, 39712, 3131, 39776, 2963, 39862, 2802,
+  39973, 2647, 40110, 2496, 40288, 2353, 40524, 2217, 40772, 2086, 41025, 1957, 41282, 1832, 41543, 1712,
+  41840, 1596, 42145, 1488, 42453, 1385, 42762, 1287, 43062, 1191, 43356, 1099, 43643, 1012, 43957, 929,
+  44286, 851, 44613, 778, 44941, 710, 45254, 645, 45558, 584, 45860, 528, 46164, 476, 46456, 427,
+  46766, 382, 47064, 341, 47364, 303, 47660, 267, 47956, 235, 48274, 206, 48590, 179, 48898, 155,
+  49195, 134, 49479, 114, 49765, 97, 50035, 82, 50305, 69, 50589, 57, 50859, 47, 51123, 38,
+  51382, 30, 51630, 24, 51877, 18, 52154, 14, 52413, 10, 52662, 7, 52922, 5, 53153, 3,
+  46838, 5715, 45566, 5425, 44495, 5154, 43591, 4900, 42824, 4661, 42171, 4433, 41614, 4217, 41137, 4010,
+  40724, 3810, 40364, 3617, 40047, 3433, 39870, 3256, 39829, 3089, 39820, 2927, 39835, 2768, 39876, 2617,
+  39948, 2472, 40060, 2334, 40230, 2199, 40413, 2070, 40608, 1947, 40813, 1829, 41028, 1714, 41272, 1602,
+  41523, 1496, 41771, 1392, 42023, 1294, 42276, 1202, 42530, 1115, 42783, 1031, 43078, 951, 43372, 875,
+  43662, 802, 43947, 734, 44221, 670, 44498, 610, 44776, 554, 45041, 501, 45312, 451, 45586, 406,
+  45855, 364, 46132, 325, 46414, 289, 46719, 256, 47019, 226, 47315, 198, 47604, 173, 47893, 150,
+  48168, 130, 48426, 112, 48667, 95, 48922, 80, 49197, 67, 49476, 56, 49754, 47, 50005, 38,
+  50249, 31, 50505, 24, 50776, 19, 51033, 14, 51271, 11, 51520, 7, 51759, 5, 52005, 3,
+  46924, 5357, 45718, 5088, 44689, 4835, 43807, 4597, 43048, 4372, 42391, 4157, 41820, 3952, 41321, 3757,
+  40880, 3568, 40486, 3386, 40144, 3213, 40027, 3046, 39946, 2888, 39894, 2735, 39869, 2589, 39874, 2447,
+  39918, 2313, 40026, 2182, 40150, 2057, 40283, 1935, 40425, 1818, 40587, 1706, 40785, 1602, 40985, 1499,
+  41184, 1399, 41386, 1304, 41585, 1212, 41781, 1124, 42008, 1042, 42267, 966, 42520, 892, 42769, 821,
+  43017, 755, 43261, 692, 43509, 633, 43749, 577, 43981, 524, 44232, 475, 44465, 429, 44717, 386,
+  44971, 346, 45245, 310, 45522, 276, 45800, 244, 46076, 216, 46352, 191, 46612, 167, 46859, 145,
+  47097, 126, 47353, 109, 47614, 93, 47875, 79, 48119, 66, 48365, 55, 48596, 45, 48847, 37,
+  49112, 30, 49375, 24, 49611, 19, 49845, 14, 50086, 11, 50319, 8, 50558, 5, 50794, 3,
+  46961, 5023, 45816, 4773, 44827, 4537, 43967, 4314, 43217, 4102, 42559, 3900, 41976, 3704, 41458, 3520,
+  40992, 3342, 40569, 3171, 40295, 3007, 40145, 2851, 40026, 2700, 39938, 2558, 39876, 2421, 39860, 2290,
+  39898, 2163, 39965, 2041, 40043, 1924, 40130, 1810, 40236, 1700, 40374, 1594, 40517, 1494, 40669, 1399,
+  40822, 1308, 40973, 1218, 41128, 1134, 41325, 1054, 41528, 976, 41733, 902, 41943, 834, 42150, 770,
+  42359, 708, 42567, 650, 42769, 595, 42980, 543, 43192, 495, 43411, 449, 43638, 407, 43880, 367,
+  44136, 330, 44395, 295, 44654, 264, 44906, 235, 45145, 207, 45378, 183, 45605, 161, 45835, 141,
+  46071, 122, 46308, 105, 46552, 90, 46802, 77, 47036, 65, 47257, 55, 47483, 45, 47725, 37,
+  47962, 30, 48205, 24, 48425, 19, 48662, 15, 48875, 11, 49113, 8, 49345, 5, 49569, 3,
+  46951, 4712, 45863, 4479, 44912, 4258, 44075, 4049, 43334, 3849, 42675, 3658, 42083, 3473, 41548, 3298,
+  41062, 3131, 40619, 2970, 40405, 2816, 40223, 2668, 40073, 2528, 39945, 2392, 39869, 2265, 39840, 2143,
+  39849, 2023, 39871, 1908, 39906, 1799, 39959, 1692, 40046, 1590, 40137, 1491, 40233, 1396, 40334, 1306,
+  40442, 1221, 40555, 1141, 40714, 1061, 40878, 987, 41042, 915, 41203, 847, 41367, 782, 41534, 721,
+  41703, 665, 41865, 610, 42044, 559, 42222, 511, 42420, 467, 42618, 424, 42852, 385, 43091, 348,
+  43329, 314, 43557, 282, 43778, 252, 43989, 224, 44193, 199, 44395, 176, 44598, 155, 44816, 135,
+  45049, 118, 45279, 103, 45497, 88, 45694, 75, 45902, 64, 46142, 54, 46385, 45, 46605, 37,
+  46814, 30, 46999, 24, 47223, 19, 47427, 15, 47665, 11, 47877, 8, 48090, 5, 48293, 3,
+  46897, 4421, 45862, 4204, 44947, 3998, 44132, 3801, 43402, 3612, 42743, 3432, 42144, 3258, 41596, 3092,
+  41090, 2934, 40712, 2783, 40472, 2638, 40264, 2499, 40081, 2367, 39937, 2239, 39837, 2119, 39795, 2004,
+  39767, 1894, 39748, 1785, 39747, 1682, 39784, 1583, 39828, 1487, 39877, 1395, 39930, 1306, 39987, 1222,
+  40056, 1142, 40176, 1066, 40302, 995, 40424, 925, 40543, 859, 40673, 796, 40797, 735, 40916, 678,
+  41043, 624, 41187, 574, 41335, 527, 41493, 481, 41679, 439, 41888, 400, 42093, 363, 42295, 329,
+  42492, 297, 42679, 267, 42860, 240, 43035, 214, 43207, 190, 43402, 169, 43606, 149, 43812, 130,
+  44009, 114, 44194, 99, 44384, 86, 44596, 73, 44810, 62, 45007, 52, 45207, 44, 45401, 36,
+  45599, 30, 45799, 24, 45990, 19, 46206, 15, 46406, 11, 46602, 8, 46798, 6, 46992, 4,
+  46801, 4150, 45816, 3948, 44934, 3754, 44140, 3569, 43421, 3391, 42764, 3220, 42160, 3056, 41601, 2899,
+  41078, 2749, 40761, 2608, 40499, 2472, 40264, 2341, 40058, 2216, 39896, 2098, 39794, 1983, 39715, 1875,
+  39650, 1772, 39594, 1671, 39582, 1573, 39578, 1480, 39580, 1390, 39589, 1305, 39602, 1223, 39630, 1143,
+  39704, 1068, 39782, 997, 39860, 930, 39946, 867, 40035, 805, 40119, 747, 40200, 691, 40300, 638,
+  40402, 587, 40516, 540, 40644, 495, 40820, 454, 40993, 415, 41160, 378, 41322, 343, 41478, 311,
+  41626, 281, 41776, 253, 41927, 228, 42088, 204, 42255, 182, 42439, 162, 42608, 142, 42773, 125,
+  42934, 110, 43100, 95, 43286, 82, 43475, 71, 43664, 60, 43842, 51, 43997, 43, 44173, 35,
+  44360, 29, 44549, 24, 44757, 19, 44933, 15, 45110, 11, 45294, 8, 45488, 6, 45675, 4,
+  46665, 3898, 45726, 3708, 44876, 3526, 44103, 3352, 43395, 3184, 42741, 3022, 42133, 2867, 41565, 2719,
+  41078, 2577, 40766, 2444, 40484, 2317, 40224, 2194, 40009, 2078, 39841, 1966, 39715, 1859, 39600, 1754,
+  39497, 1656, 39433, 1563, 39383, 1472, 39339, 1383, 39306, 1300, 39275, 1220, 39264, 1144, 39297, 1071,
+  39330, 1000, 39362, 933, 39404, 870, 39450, 810, 39492, 753, 39538, 700, 39607, 647, 39676, 600,
+  39761, 553, 39877, 509, 40013, 467, 40144, 427, 40277, 391, 40406, 357, 40525, 325, 40637, 294,
+  40761, 267, 40875, 240, 41001, 216, 41150, 193, 41301, 173, 41446, 154, 41582, 136, 41719, 120,
+  41874, 105, 42039, 92, 42198, 79, 42348, 68, 42495, 58, 42644, 50, 42825, 42, 42984, 35,
+  43149, 28, 43324, 23, 43487, 18, 43653, 14, 43821, 11, 43991, 8, 44151, 6, 44317, 4,
+  46492, 3662, 45595, 3485, 44776, 3314, 44022, 3149, 43324, 2990, 42674, 2837, 42065, 2691, 41489, 2551,
+  41059, 2418, 40731, 2292, 40428, 2172, 40156, 2058, 39923, 1948, 39753, 1843, 39596, 1741, 39448, 1643,
+  39328, 1549, 39235, 1460, 39152, 1376, 39076, 1294, 39000, 1214, 38946, 1140, 38939, 1070, 38933, 1002,
+  38927, 937, 38928, 874, 38927, 813, 38928, 757, 38937, 704, 38967, 654, 38998, 606, 39052, 560,
+  39153, 518, 39258, 478, 39357, 439, 39451, 403, 39536, 368, 39620, 336, 39706, 306, 39790, 278,
+  39873, 252, 39978, 227, 40099, 205, 40207, 183, 40313, 164, 40432, 146, 40553, 130, 40691, 115,
+  40830, 101, 40964, 88, 41102, 76, 41226, 66, 41362, 57, 41502, 48, 41641, 40, 41798, 34,
+  41952, 28, 42078, 23, 42210, 18, 42356, 14, 42515, 11, 42659, 8, 42810, 6, 42975, 4,
+  46283, 3442, 45426, 3276, 44634, 3115, 43900, 2959, 43213, 2809, 42567, 2664, 41956, 2526, 41375, 2394,
+  40996, 2269, 40654, 2151, 40331, 2037, 40053, 1930, 39822, 1827, 39625, 1727, 39438, 1631, 39267, 1539,
+  39132, 1449, 39007, 1365, 38890, 1286, 38778, 1210, 38681, 1136, 38628, 1066, 38581, 999, 38535, 936,
+  38500, 876, 38467, 818, 38428, 762, 38399, 708, 38387, 658, 38382, 611, 38410, 566, 38479, 525,
+  38544, 484, 38606, 447, 38665, 412, 38719, 378, 38770, 346, 38824, 316, 38869, 288, 38930, 262,
+  39015, 238, 39099, 215, 39180, 193, 39271, 174, 39357, 156, 39450, 139, 39556, 123, 39672, 109,
+  39787, 96, 39894, 84, 39990, 73, 40112, 63, 40229, 55, 40348, 47, 40473, 39, 40591, 33,
+  40704, 27, 40838, 22, 40959, 18, 41084, 14, 41208, 11, 41330, 8, 41472, 6, 41592, 4,
+  46041, 3237, 45220, 3081, 44454, 2929, 43737, 2782, 43061, 2640, 42420, 2503, 41809, 2373, 41271, 2249,
+  40892, 2131, 40535, 2019, 40205, 1912, 39913, 1810, 39681, 1713, 39459, 1619, 39243, 1528, 39067, 1441,
+  38904, 1358, 38748, 1278, 38597, 1202, 38462, 1131, 38366, 1063, 38279, 997, 38191, 933, 38119, 873,
+  38047, 817, 37974, 763, 37913, 712, 37866, 663, 37830, 616, 37830, 571, 37860, 530, 37886, 490,
+  37912, 453, 37933, 418, 37953, 385, 37975, 354, 37996, 325, 38011, 297, 38049, 271, 38106, 247,
+  38166, 224, 38219, 203, 38279, 183, 38328, 164, 38406, 147, 38491, 132, 38574, 117, 38652, 104,
+  38729, 91, 38807, 80, 38903, 70, 38995, 61, 39085, 52, 39190, 45, 39281, 38, 39360, 32,
+  39460, 26, 39559, 22, 39683, 18, 39786, 14, 39886, 11, 40005, 8, 40109, 6, 40227, 4,
+  45767, 3046, 44979, 2898, 44238, 2755, 43538, 2616, 42872, 2481, 42236, 2353, 41625, 2229, 41136, 2113,
+  40748, 2002, 40377, 1895, 40044, 1794, 39755, 1698, 39500, 1606, 39253, 1518, 39029, 1432, 38832, 1350,
+  38643, 1272, 38457, 1197, 38283, 1126, 38141, 1059, 38021, 995, 37900, 933, 37791, 873, 37680, 816,
+  37570, 763, 37473, 713, 37395, 665, 37333, 620, 37307, 577, 37301, 535, 37293, 496, 37282, 459,
+  37269, 424, 37251, 391, 37237, 360, 37217, 331, 37207, 304, 37226, 279, 37257, 255, 37281, 232,
+  37308, 211, 37335, 191, 37363, 173, 37413, 156, 37468, 139, 37523, 124, 37579, 111, 37625, 99,
+  37679, 87, 37738, 76, 37797, 67, 37872, 58, 37941, 50, 37998, 43, 38066, 37, 38153, 31,
+  38226, 26, 38310, 21, 38380, 17, 38472, 13, 38576, 10, 38653, 8, 38752, 6, 38838, 4,
+  45463, 2867, 44705, 2728, 43987, 2592, 43303, 2460, 42647, 2333, 42016, 2211, 41407, 2095, 40961, 1985,
+  40565, 1880, 40186, 1779, 39844, 1685, 39558, 1594, 39281, 1506, 39011, 1422, 38783, 1342, 38563, 1265,
+  38347, 1192, 38137, 1122, 37951, 1055, 37797, 991, 37644, 930, 37503, 873, 37362, 818, 37217, 765,
+  37084, 714, 36974, 666, 36878, 622, 36822, 580, 36789, 541, 36750, 502, 36706, 465, 36660, 431,
+  36608, 398, 36562, 367, 36508, 338, 36470, 311, 36456, 285, 36454, 261, 36446, 239, 36446, 218,
+  36441, 198, 36447, 180, 36476, 163, 36512, 147, 36542, 132, 36567, 118, 36577, 105, 36613, 94,
+  36648, 83, 36683, 73, 36722, 64, 36759, 56, 36797, 48, 36844, 41, 36893, 35, 36944, 30,
+  37023, 25, 37087, 20, 37141, 17, 37199, 13, 37262, 10, 37338, 8, 37405, 6, 37482, 4,
+  45131, 2700, 44401, 2568, 43704, 2440, 43034, 2315, 42388, 2194, 41762, 2080, 41170, 1970, 40749, 1866,
+  40343, 1767, 39964, 1672, 39624, 1582, 39322, 1495, 39025, 1412, 38752, 1333, 38503, 1258, 38259, 1186,
+  38019, 1117, 37792, 1051, 37606, 988, 37422, 927, 37248, 871, 37076, 817, 36905, 766, 36744, 718,
+  36603, 670, 36472, 625, 36383, 583, 36315, 543, 36243, 506, 36173, 471, 36097, 437, 36015, 405,
+  35937, 374, 35858, 346, 35794, 318, 35757, 293, 35719, 269, 35678, 245, 35644, 224, 35606, 205,
+  35594, 186, 35604, 169, 35609, 153, 35611, 138, 35606, 125, 35589, 112, 35599, 100, 35602, 89,
+  35610, 79, 35622, 69, 35636, 61, 35649, 53, 35673, 46, 35707, 40, 35750, 34, 35793, 29,
+  35819, 24, 35850, 20, 35901, 16, 35942, 13, 35980, 10, 36025, 8, 36070, 5, 36112, 4,
+  44772, 2544, 44067, 2419, 43389, 2297, 42733, 2179, 42096, 2065, 41475, 1956, 40925, 1853, 40500, 1755,
+  40085, 1660, 39705, 1572, 39370, 1486, 39050, 1404, 38735, 1325, 38460, 1250, 38191, 1180, 37925, 1112,
+  37667, 1047, 37440, 985, 37230, 926, 37025, 870, 36823, 815, 36623, 765, 36430, 717, 36264, 673,
+  36105, 629, 35984, 587, 35884, 547, 35780, 509, 35677, 474, 35569, 440, 35460, 409, 35356, 380,
+  35246, 351, 35158, 324, 35097, 299, 35028, 275, 34968, 253, 34907, 232, 34841, 212, 34808, 193,
+  34786, 176, 34763, 159, 34730, 144, 34688, 130, 34656, 118, 34640, 106, 34615, 95, 34594, 84,
+  34580, 75, 34568, 66, 34563, 58, 34566, 50, 34576, 44, 34588, 38, 34606, 32, 34610, 28,
+  34619, 23, 34629, 19, 34643, 15, 34669, 12, 34696, 10, 34714, 7, 34741, 5, 34778, 4,
+  44388, 2398, 43707, 2280, 43046, 2164, 42403, 2052, 41774, 1944, 41158, 1841, 40646, 1743, 40216, 1650,
+  39801, 1561, 39418, 1477, 39079, 1396, 38744, 1318, 38428, 1244, 38136, 1173, 37845, 1107, 37559, 1043,
+  37294, 983, 37059, 924, 36826, 868, 36599, 815, 36371, 764, 36149, 716, 35952, 672, 35760, 630,
+  35612, 590, 35486, 551, 35356, 513, 35224, 478, 35086, 444, 34946, 413, 34810, 383, 34675, 355,
+  34564, 329, 34471, 304, 34375, 280, 34294, 258, 34205, 238, 34118, 218, 34070, 199, 34022, 182,
+  33965, 165, 33903, 150, 33831, 136, 33772, 123, 33723, 111, 33670, 100, 33631, 89, 33604, 80,
+  33569, 71, 33540, 63, 33523, 55, 33507, 48, 33497, 42, 33483, 36, 33448, 31, 33430, 26,
+  33423, 22, 33418, 18, 33414, 15, 33413, 12, 33418, 9, 33433, 7, 33435, 5, 33439, 4,
+  43980, 2261, 43320, 2149, 42675, 2040, 42044, 1932, 41423, 1830, 40811, 1733, 40334, 1640, 39900, 1552,
+  39485, 1469, 39108, 1389, 38756, 1312, 38405, 1238, 38090, 1169, 37779, 1102, 37470, 1039, 37170, 978,
+  36906, 921, 36648, 867, 36398, 815, 36146, 765, 35900, 717, 35669, 672, 35447, 629, 35262, 589,
+  35111, 551, 34960, 516, 34803, 482, 34638, 448, 34472, 417, 34308, 387, 34144, 359, 34005, 332,
+  33885, 308, 33769, 284, 33658, 262, 33538, 242, 33436, 222, 33367, 204, 33294, 187, 33214, 171,
+  33121, 156, 33017, 141, 32940, 128, 32864, 116, 32789, 105, 32723, 94, 32662, 84, 32609, 75,
+  32564, 67, 32528, 59, 32484, 52, 32448, 46, 32408, 40, 32351, 35, 32315, 30, 32282, 25,
+  32257, 21, 32233, 18, 32219, 15, 32197, 12, 32176, 9, 32151, 7, 32145, 5, 32139, 4,
+  43550, 2133, 42909, 2027, 42279, 1923, 41658, 1821, 41044, 1724, 40437, 1632, 39992, 1544, 39551, 1461,
+  39137, 1382, 38764, 1306, 38400, 1234, 38047, 1164, 37720, 1098, 37393, 1036, 37068, 975, 36766, 918,
+  36488, 864, 36213, 813, 35941, 764, 35673, 718, 35412, 673, 35168, 630, 34946, 590, 34766, 552,
+  34588, 516, 34407, 482, 34220, 451, 34030, 420, 33839, 390, 33651, 362, 33486, 336, 33339, 311,
+  33200, 288, 33063, 266, 32918, 246, 32798, 226, 32699, 208, 32600, 191, 32493, 175, 32377, 160,
+  32256, 147, 32158, 133, 32052, 121, 31956, 109, 31871, 99, 31787, 89, 31714, 79, 31637, 71,
+  31570, 63, 31507, 56, 31456, 49, 31391, 44, 31310, 38, 31255, 33, 31213, 28, 31168, 24,
+  31110, 20, 31071, 17, 31033, 14, 30996, 11, 30953, 9, 30915, 7, 30881, 5, 30847, 3,
+  43100, 2014, 42476, 1913, 41859, 1813, 41247, 1717, 40640, 1624, 40066, 1537, 39619, 1454, 39178, 1375,
+  38765, 1300, 38390, 1228, 38013, 1160, 37662, 1095, 37319, 1032, 36976, 973, 36640, 916, 36340, 862,
+  36043, 811, 35751, 762, 35462, 717, 35173, 673, 34910, 632, 34658, 592, 34448, 553, 34246, 517,
+  34040, 483, 33828, 451, 33615, 421, 33403, 393, 33193, 366, 33003, 339, 32835, 315, 32672, 291,
+  32507, 269, 32339, 249, 32200, 230, 32081, 212, 31955, 195, 31819, 178, 31676, 164, 31533, 150,
+  31415, 137, 31292, 125, 31176, 114, 31069, 103, 30968, 93, 30875, 84, 30779, 75, 30693, 67,
+  30601, 60, 30516, 53, 30422, 47, 30327, 41, 30254, 36, 30182, 31, 30110, 27, 30045, 23,
+  29994, 19, 29930, 16, 29857, 13, 29790, 11, 29742, 9, 29690, 7, 29639, 5, 29593, 3,
+  42630, 1902, 42021, 1806, 41416, 1711, 40813, 1619, 40211, 1531, 39668, 1448, 39219, 1370, 38779, 1295,
+  38371, 1224, 37986, 1156, 37603, 1091, 37248, 1029, 36891, 970, 36535, 914, 36201, 861, 35886, 809,
+  35575, 761, 35266, 715, 34959, 673, 34669, 632, 34388, 593, 34150, 556, 33928, 519, 33700, 485,
+  33466, 452, 33227, 422, 32992, 394, 32762, 367, 32550, 342, 32363, 318, 32178, 295, 31990, 273,
+  31803, 252, 31644, 233, 31502, 215, 31354, 198, 31197, 183, 31029, 168, 30861, 154, 30716, 141,
+  30569, 128, 30435, 117, 30315, 107, 30201, 97, 30080, 88, 29965, 79, 29857, 71, 29748, 63,
+  29643, 57, 29524, 50, 29404, 44, 29308, 39, 29218, 34, 29134, 30, 29046, 26, 28962, 22,
+  28876, 18, 28792, 16, 28707, 13, 28625, 10, 28558, 8, 28491, 6, 28423, 5, 28359, 3,
+  42142, 1797, 41547, 1705, 40952, 1615, 40357, 1527, 39760, 1444, 39244, 1365, 38792, 1290, 38354, 1219,
+  37950, 1152, 37555, 1087, 37174, 1026, 36806, 968, 36436, 912, 36071, 859, 35739, 808, 35409, 760,
+  35082, 714, 34759, 671, 34441, 631, 34138, 592, 33866, 556, 33627, 521, 33382, 487, 33129, 455,
+  32868, 424, 32612, 395, 32362, 368, 32124, 343, 31917, 320, 31713, 298, 31507, 277, 31304, 256,
+  31126, 237, 30962, 219, 30789, 202, 30606, 186, 30416, 171, 30232, 158, 30067, 145, 29899, 132,
+  29744, 120, 29600, 110, 29464, 100, 29324, 91, 29195, 82, 29062, 74, 28933, 67, 28806, 60,
+  28665, 53, 28536, 47, 28425, 42, 28312, 37, 28208, 32, 28104, 28, 28007, 24, 27901, 21,
+  27784, 18, 27680, 15, 27597, 12, 27514, 10, 27418, 8, 27331, 6, 27245, 5, 27165, 3,
+  41638, 1699, 41054, 1611, 40469, 1525, 39880, 1441, 39289, 1362, 38797, 1287, 38342, 1216, 37904, 1149,
+  37504, 1085, 37100, 1023, 36719, 965, 36339, 910, 35958, 857, 35595, 807, 35250, 759, 34910, 714,
+  34570, 671, 34228, 630, 33909, 592, 33602, 555, 33340, 521, 33079, 488, 32812, 457, 32536, 427,
+  32261, 398, 31990, 370, 31728, 345, 31497, 321, 31272, 299, 31050, 278, 30831, 259, 30635, 241,
+  30452, 223, 30260, 206, 30058, 190, 29845, 175, 29642, 161, 29455, 148, 29270, 136, 29100, 124,
+  28937, 113, 28778, 103, 28615, 94, 28465, 85, 28312, 77, 28171, 70, 28021, 63, 27861, 56,
+  27717, 50, 27590, 45, 27466, 40, 27345, 35, 27217, 31, 27092, 27, 26967, 23, 26840, 20,
+  26724, 17, 26623, 14, 26516, 12, 26412, 10, 26305, 8, 26197, 6, 26095, 4, 25996, 3,
+  41118, 1607, 40545, 1523, 39968, 1440, 39385, 1361, 38798, 1285, 38328, 1214, 37872, 1146, 37440, 1082,
+  37034, 1021, 36625, 963, 36240, 908, 35849, 856, 35461, 806, 35098, 758, 34743, 713, 34389, 671,
+  34036, 630, 33691, 591, 33357, 555, 33067, 520, 32792, 488, 32510, 457, 32220, 428, 31930, 400,
+  31643, 374, 31361, 348, 31105, 323, 30859, 301, 30620, 280, 30381, 260, 30165, 242, 29967, 226,
+  29758, 209, 29538, 194, 29306, 179, 29086, 165, 28881, 151, 28680, 139, 28490, 128, 28311, 117,
+  28136, 107, 27956, 97, 27785, 88, 27613, 80, 27450, 72, 27282, 66, 27110, 59, 26951, 53,
+  26803, 47, 26664, 42, 26525, 37, 26383, 33, 26242, 29, 26096, 25, 25945, 22, 25817, 19,
+  25705, 16, 25580, 14, 25454, 11, 25319, 9, 25201, 7, 25088, 6, 24974, 4, 24865, 3,
+  40584, 1520, 40021, 1440, 39450, 1361, 38873, 1285, 38293, 1213, 37838, 1145, 37384, 1081, 36956, 1020,
+  36542, 962, 36135, 907, 35739, 854, 35337, 805, 34947, 758, 34580, 713, 34216, 670, 33851, 630,
+  33483, 592, 33135, 555, 32807, 521, 32518, 488, 32223, 457, 31920, 428, 31613, 401, 31310, 375,
+  31012, 351, 30737, 327, 30473, 304, 30217, 282, 29960, 262, 29722, 244, 29503, 227, 29277, 211,
+  29041, 196, 28793, 181, 28558, 168, 28335, 154, 28118, 142, 27910, 130, 27717, 120, 27525, 110,
+  27329, 100, 27145, 91, 26956, 83, 26776, 75, 26587, 68, 26396, 62, 26223, 55, 26068, 50,
+  25915, 45, 25750, 40, 25588, 35, 25430, 31, 25274, 27, 25113, 24, 24972, 21, 24835, 18,
+  24692, 15, 24555, 13, 24407, 11, 24273, 9, 24141, 7, 24016, 5, 23892, 4, 23768, 3,
+  40037, 1439, 39482, 1362, 38918, 1287, 38345, 1214, 37786, 1146, 37330, 1081, 36876, 1020, 36451, 962,
+  36030, 907, 35623, 854, 35218, 804, 34810, 757, 34422, 712, 34046, 670, 33669, 630, 33292, 592,
+  32925, 556, 32569, 522, 32256, 489, 31949, 458, 31635, 429, 31312, 401, 30994, 376, 30680, 351,
+  30383, 328, 30105, 307, 29838, 286, 29566, 265, 29303, 246, 29068, 229, 28825, 212, 28569, 197,
+  28304, 183, 28053, 169, 27816, 157, 27584, 145, 27360, 133, 27153, 122, 26943, 112, 26735, 103,
+  26537, 94, 26333, 86, 26136, 78, 25931, 71, 25727, 64, 25542, 58, 25368, 52, 25196, 47,
+  25023, 42, 24846, 38, 24668, 33, 24495, 29, 24321, 26, 24169, 23, 24025, 20, 23866, 17,
+  23710, 14, 23546, 12, 23409, 10, 23267, 8, 23128, 7, 22983, 5, 22844, 4, 22710, 3,
+  39479, 1363, 38930, 1289, 38371, 1217, 37802, 1148, 37263, 1082, 36804, 1020, 36351, 962, 35928, 907,
+  35500, 854, 35093, 805, 34679, 757, 34265, 712, 33878, 670, 33493, 630, 33108, 592, 32719, 557,
+  32348, 523, 32003, 490, 31687, 459, 31363, 430, 31029, 402, 30693, 376, 30366, 352, 30044, 329,
+  29753, 307, 29472, 287, 29189, 268, 28908, 249, 28658, 231, 28398, 214, 28127, 199, 27846, 184,
+  27575, 171, 27321, 158, 27073, 146, 26840, 135, 26619, 125, 26397, 114, 26174, 105, 25958, 96,
+  25738, 88, 25529, 80, 25311, 73, 25097, 67, 24897, 60, 24710, 54, 24525, 49, 24332, 44,
+  24137, 39, 23953, 35, 23771, 32, 23583, 28, 23416, 24, 23255, 21, 23086, 19, 22921, 16,
+  22748, 14, 22587, 12, 22430, 10, 22289, 8, 22134, 6, 21978, 5, 21831, 4, 21685, 3,
+  38910, 1291, 38367, 1221, 37812, 1151, 37246, 1085, 36725, 1023, 36262, 963, 35813, 908, 35388, 856,
+  34961, 806, 34546, 758, 34123, 713, 33713, 671, 33319, 631, 32925, 593, 32529, 557, 32140, 523,
+  31764, 491, 31432, 461, 31101, 432, 30759, 404, 30409, 377, 30068, 352, 29729, 329, 29417, 308,
+  29121, 288, 28827, 269, 28530, 251, 28266, 234, 27994, 218, 27710, 201, 27415, 186, 27126, 172,
+  26858, 159, 26593, 147, 26346, 136, 26110, 126, 25876, 116, 25641, 107, 25411, 98, 25179, 90,
+  24953, 82, 24721, 75, 24498, 69, 24292, 62, 24094, 57, 23892, 51, 23684, 46, 23475, 41,
+  23278, 37, 23080, 33, 22886, 30, 22710, 26, 22537, 23, 22352, 20, 22168, 17, 21988, 15,
+  21821, 13, 21660, 11, 21493, 9, 21320, 8, 21158, 6, 21004, 5, 20848, 4, 20696, 3,
+};
+
+#endif
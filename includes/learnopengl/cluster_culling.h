@@ -0,0 +1,127 @@
+#ifndef CLUSTER_CULLING_H
+#define CLUSTER_CULLING_H
+
+#include "learnopengl/model.h"
+#include "learnopengl/gl_state.h"
+#include <vector>
+#include <iostream>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+using std::vector;
+
+/*
+* CPU culling of Mesh clusters
+*
+* Every cluster is tested against the view frustum (bounding sphere) and for being entirely
+* back facing (normal cone). Both tests run in object space: the frustum planes come straight
+* out of projection * view * model and the eye is moved into the model's space, so nothing
+* is transformed per cluster. Surviving clusters are merged into runs and drawn with a single
+* glMultiDrawElements per mesh.
+*
+* Meshes without clusters (Model loaded without ModelOptions::clusters) are drawn whole.
+*/
+class ClusterCuller {
+public:
+  struct Stats {
+    unsigned int clusters = 0;
+    unsigned int clustersDrawn = 0;
+    unsigned int triangles = 0;
+    unsigned int trianglesFrustumCulled = 0;
+    unsigned int trianglesBackfaceCulled = 0;
+  };
+
+  // cone culling assumes back faces are invisible, so turn it off for open or two sided meshes
+  bool cullBackfaces = true;
+
+  void draw(Model &model, Shader &shader, const glm::mat4 &modelMatrix, const glm::mat4 &view, const glm::mat4 &projection) {
+    // 1. Object space frustum planes (Gribb / Hartmann) and eye position
+    glm::mat4 clip = projection * view * modelMatrix;
+    glm::vec4 planes[6];
+    for (unsigned int i = 0; i < 3; ++i) {
+      planes[i * 2] = row(clip, 3) + row(clip, i);
+      planes[i * 2 + 1] = row(clip, 3) - row(clip, i);
+    }
+    for (glm::vec4 &plane : planes)
+      plane /= glm::length(vec3(plane));
+    vec3 eye = vec3(glm::inverse(view * modelMatrix) * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
+    for (Mesh &mesh : model.meshes) {
+      if (mesh.clusters.empty()) {
+        frame.triangles += mesh.lod(0).indexCount / 3;
+        mesh.draw(shader);
+        continue;
+      }
+
+      // 2. Cull, merging neighbouring survivors into one range
+      counts.clear();
+      offsets.clear();
+      unsigned int runEnd = 0xffffffffu;
+      for (const MeshCluster &cluster : mesh.clusters) {
+        unsigned int triangles = cluster.indexCount / 3;
+        frame.clusters++;
+        frame.triangles += triangles;
+        if (outsideFrustum(cluster, planes)) {
+          frame.trianglesFrustumCulled += triangles;
+          continue;
+        }
+        if (cullBackfaces && glm::dot(glm::normalize(cluster.coneApex - eye), cluster.coneAxis) >= cluster.coneCutoff) {
+          frame.trianglesBackfaceCulled += triangles;
+          continue;
+        }
+        frame.clustersDrawn++;
+        if (cluster.indexOffset == runEnd) {
+          counts.back() += cluster.indexCount;
+        } else {
+          counts.push_back(cluster.indexCount);
+          offsets.push_back((const void*)(cluster.indexOffset * mesh.indexSize()));
+        }
+        runEnd = cluster.indexOffset + cluster.indexCount;
+      }
+      if (counts.empty())
+        continue;
+
+      // 3. Submit the surviving ranges
+      mesh.setMaterial(shader);
+      GLState &state = GLState::instance();
+      state.bindVertexArray(mesh.VAO);
+      glMultiDrawElements(GL_TRIANGLES, counts.data(), mesh.indexType, offsets.data(), (GLsizei)counts.size());
+      state.releaseVertexArray();
+    }
+  }
+
+  // Counters since the last endFrame()
+  const Stats &stats() const {
+    return frame;
+  }
+
+  Stats endFrame() {
+    Stats finished = frame;
+    frame = Stats();
+    return finished;
+  }
+
+  static void printStats(const Stats &stats) {
+    std::cout << "Clusters: " << stats.clustersDrawn << " / " << stats.clusters << " drawn, triangles culled "
+      << stats.trianglesFrustumCulled << " frustum + " << stats.trianglesBackfaceCulled << " backface of "
+      << stats.triangles << std::endl;
+  }
+
+private:
+  Stats frame;
+  vector<GLsizei> counts;
+  vector<const void*> offsets;
+
+  static glm::vec4 row(const glm::mat4 &m, unsigned int i) {
+    return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+  }
+
+  static bool outsideFrustum(const MeshCluster &cluster, const glm::vec4 *planes) {
+    for (unsigned int i = 0; i < 6; ++i)
+      if (glm::dot(vec3(planes[i]), cluster.center) + planes[i].w < -cluster.radius)
+        return true;
+    return false;
+  }
+};
+
+#endif
@@ -0,0 +1,200 @@
+#ifndef DRAW_QUEUE_H
+#define DRAW_QUEUE_H
+
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include "learnopengl/shader.h"
+#include "learnopengl/model.h"
+#include "learnopengl/mesh.h"
+#include "learnopengl/gl_state.h"
+
+using std::vector;
+
+/*
+* Draw submission queue sorted by packed 64 bit keys
+*
+* Draws are submitted in any order, sorted once a frame and then executed, so consecutive
+* draws share as much state as possible. Each key packs, most significant first:
+*
+*   opaque        [pass 2][program 12][material 16][mesh 16][depth 18, front to back]
+*   transparent   [pass 2][depth 24, back to front][program 12][material 16][mesh 10]
+*
+* Opaque draws group by program, then material (first texture or texture array), then mesh
+* (VAO), and only use depth to order draws that share all three, which still gets some early
+* depth rejection. Transparent draws have to blend in depth order, so depth comes first and
+* state only breaks ties. Passes run in DrawPass order.
+*
+* IDs wider than their field are folded into it, which can only make grouping a little worse,
+* never the result wrong. Keys are sorted with an LSD radix sort, 8 bits a pass, skipping
+* the bytes every key has in common; the buffers are kept between frames.
+*/
+enum class DrawPass : uint8_t {
+  Opaque = 0,
+  Transparent = 1,
+};
+
+struct DrawItem {
+  Shader *shader;
+  Mesh *mesh;
+  unsigned int lod;
+  glm::mat4 transform;
+};
+
+namespace draw_queue {
+  inline uint64_t field(uint64_t value, unsigned int bits) {
+    uint64_t mask = (1ull << bits) - 1;
+    return (value ^ (value >> bits)) & mask;
+  }
+
+  inline uint64_t quantize(float value01, unsigned int bits) {
+    float clamped = std::min(std::max(value01, 0.0f), 1.0f);
+    return (uint64_t)(clamped * (float)((1ull << bits) - 1));
+  }
+
+  inline uint64_t packKey(DrawPass pass, unsigned int program, unsigned int material, unsigned int mesh, float depth01) {
+    uint64_t key = (uint64_t)pass << 62;
+    if (pass == DrawPass::Transparent) {
+      key |= (((1ull << 24) - 1) - quantize(depth01, 24)) << 38;
+      key |= field(program, 12) << 26;
+      key |= field(material, 16) << 10;
+      key |= field(mesh, 10);
+      return key;
+    }
+    key |= field(program, 12) << 50;
+    key |= field(material, 16) << 34;
+    key |= field(mesh, 16) << 18;
+    key |= quantize(depth01, 18);
+    return key;
+  }
+
+  // Sorts (key, index) pairs by key, stable, using scratch as the second buffer
+  inline void radixSort(vector<std::pair<uint64_t, uint32_t>> &entries, vector<std::pair<uint64_t, uint32_t>> &scratch) {
+    if (entries.size() < 2)
+      return;
+    scratch.resize(entries.size());
+    uint64_t same = ~0ull;
+    for (const auto &entry : entries)
+      same &= ~(entry.first ^ entries[0].first);
+
+    for (unsigned int shift = 0; shift < 64; shift += 8) {
+      if (((same >> shift) & 0xff) == 0xff)
+        continue; // every key has the same byte here
+      size_t counts[256] = {};
+      for (const auto &entry : entries)
+        counts[(entry.first >> shift) & 0xff]++;
+      size_t offset = 0;
+      for (size_t &count : counts) {
+        size_t bucket = count;
+        count = offset;
+        offset += bucket;
+      }
+      for (const auto &entry : entries)
+        scratch[counts[(entry.first >> shift) & 0xff]++] = entry;
+      entries.swap(scratch);
+    }
+  }
+}
+
+class DrawQueue {
+public:
+  struct Stats {
+    unsigned int draws = 0;
+    unsigned int programChanges = 0;
+    unsigned int materialChanges = 0;
+  };
+
+  // Depth keys are the distance from eye over farPlane
+  void setView(const glm::vec3 &eye, float farPlane) {
+    this->eye = eye;
+    this->farPlane = farPlane;
+  }
+
+  void submit(DrawPass pass, Shader &shader, Mesh &mesh, const glm::mat4 &transform, unsigned int lod = 0) {
+    glm::vec3 centre = glm::vec3(transform * glm::vec4((mesh.boundsMin + mesh.boundsMax) * 0.5f, 1.0f));
+    float depth = glm::length(centre - eye) / farPlane;
+    keys.push_back({ draw_queue::packKey(pass, shader.ID, mesh.materialKey(), mesh.VAO, depth), (uint32_t)items.size() });
+    items.push_back({ &shader, &mesh, lod, transform });
+  }
+
+  // Every mesh of the model, nothing while it is still streaming in
+  void submit(DrawPass pass, Shader &shader, Model &model, const glm::mat4 &transform, unsigned int lod = 0) {
+    if (!model.ready())
+      return;
+    for (Mesh &mesh : model.meshes)
+      submit(pass, shader, mesh, transform, lod);
+  }
+
+  void sort() {
+    draw_queue::radixSort(keys, scratch);
+  }
+
+  /*
+  * Draws in key order, setting "model" to each transform. Program and texture binds go through
+  * GLState, so they are only issued when they change inside a GLState frame. The "model" location
+  * is resolved by name once per program and kept across frames.
+  */
+  Stats execute() {
+    Stats stats;
+    Shader *program = nullptr;
+    unsigned int material = ~0u;
+    UniformHandle<glm::mat4> modelUniform;
+    for (const auto &key : keys) {
+      DrawItem &item = items[key.second];
+      if (item.shader != program) {
+        program = item.shader;
+        program->use();
+        modelUniform = modelUniformOf(*program);
+        stats.programChanges++;
+      }
+      if (item.mesh->materialKey() != material) {
+        material = item.mesh->materialKey();
+        stats.materialChanges++;
+      }
+      program->set(modelUniform, item.transform);
+      item.mesh->draw(*program, item.lod);
+      stats.draws++;
+    }
+    last = stats;
+    return stats;
+  }
+
+  // Keeps the capacity, so a steady frame submits without allocating
+  void clear() {
+    keys.clear();
+    items.clear();
+  }
+
+  size_t size() const {
+    return items.size();
+  }
+
+  void printStats() const {
+    std::cout << "Draw queue: " << last.draws << " draws, " << last.programChanges << " program changes, "
+      << last.materialChanges << " material changes" << std::endl;
+  }
+
+private:
+  glm::vec3 eye = glm::vec3(0.0f);
+  float farPlane = 100.0f;
+  vector<std::pair<uint64_t, uint32_t>> keys;
+  vector<std::pair<uint64_t, uint32_t>> scratch;
+  vector<DrawItem> items;
+  vector<std::pair<unsigned int, UniformHandle<glm::mat4>>> modelUniforms; // by program ID
+  Stats last;
+
+  // A handful of programs at most, so a linear scan beats hashing
+  UniformHandle<glm::mat4> modelUniformOf(const Shader &shader) {
+    for (const auto &known : modelUniforms) {
+      if (known.first == shader.ID)
+        return known.second;
+    }
+    UniformHandle<glm::mat4> handle = shader.uniform<glm::mat4>("model");
+    modelUniforms.push_back({ shader.ID, handle });
+    return handle;
+  }
+};
+
+#endif
@@ -0,0 +1,392 @@
+#ifndef GEOMETRY_BUFFER_H
+#define GEOMETRY_BUFFER_H
+
+#include <map>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include "learnopengl/shader.h"
+#include "learnopengl/model.h"
+#include "learnopengl/mesh.h"
+#include "learnopengl/gl_state.h"
+#include "learnopengl/draw_queue.h"
+
+using std::vector;
+
+// ARB_draw_indirect, ARB_base_instance and ARB_multi_draw_indirect (core in 4.0 to 4.3), glad is only generated for 3.3
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
+typedef void (APIENTRYP PFNMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void *indirect, GLsizei drawcount, GLsizei stride);
+
+// Layout glMultiDrawElementsIndirect reads from GL_DRAW_INDIRECT_BUFFER
+struct DrawElementsIndirectCommand {
+  GLuint count;
+  GLuint instanceCount;
+  GLuint firstIndex; // in indices, not bytes
+  GLint baseVertex;
+  GLuint baseInstance;
+};
+
+// One row per draw, read as instanced attributes so baseInstance picks the row
+struct GeometryDrawData {
+  glm::mat4 model;          // locations 3-6
+  glm::vec3 positionOffset; // location 8, packed meshes only
+  glm::vec3 positionScale;  // location 9
+};
+
+const unsigned int DRAW_MODEL_ATTRIBUTE = 3;
+const unsigned int DRAW_POSITION_OFFSET_ATTRIBUTE = 8;
+const unsigned int DRAW_POSITION_SCALE_ATTRIBUTE = 9;
+
+/*
+* Static geometry shared by many meshes in a few large buffers
+*
+* Every Mesh added is copied (GPU to GPU) into a pool holding one vertex format and index type,
+* so meshes of a pool share one VAO, VBO and EBO and only differ by base vertex and first index.
+* Pools start at the given capacity and double when full.
+*
+* Each frame, submit() every Model to draw and then draw() them. Draws are sorted by pool and
+* material; every run sharing both goes out as one glMultiDrawElementsIndirect, with the
+* transform (and the packed position bounds) of each draw in a per draw buffer selected by
+* baseInstance. Shaders read them instead of uniforms, e.g. with a MULTI_DRAW define:
+*
+*   layout (location = 3) in mat4 aModel;
+*   layout (location = 8) in vec3 aPositionOffset;
+*   layout (location = 9) in vec3 aPositionScale;
+*
+* Without ARB_multi_draw_indirect and ARB_base_instance each draw re-points the per draw
+* attributes and issues a glDrawElementsBaseVertex, which still never switches VAOs.
+*
+* Meshes keep their own buffers, so a Model can still be drawn on its own. Models have to
+* outlive the GeometryBuffer they were submitted to.
+*/
+class GeometryBuffer {
+public:
+  struct Stats {
+    unsigned int draws = 0;
+    unsigned int batches = 0;
+    unsigned int calls = 0; // draw calls issued to GL
+  };
+
+  // Capacity of each pool when it is created, in vertices and indices
+  GeometryBuffer(size_t vertexCapacity = 1 << 18, size_t indexCapacity = 1 << 20)
+    : vertexCapacity(vertexCapacity), indexCapacity(indexCapacity) {
+    if (glfwExtensionSupported("GL_ARB_multi_draw_indirect") && glfwExtensionSupported("GL_ARB_base_instance"))
+      glMultiDrawElementsIndirectProc = (PFNMULTIDRAWELEMENTSINDIRECTPROC)glfwGetProcAddress("glMultiDrawElementsIndirect");
+    glGenBuffers(1, &drawDataBuffer);
+    if (multiDraw())
+      glGenBuffers(1, &indirectBuffer);
+  }
+
+  // The pools have a single owner, so the buffer can not be copied
+  GeometryBuffer(const GeometryBuffer&) = delete;
+  GeometryBuffer &operator=(const GeometryBuffer&) = delete;
+
+  ~GeometryBuffer() {
+    if (!glfwGetCurrentContext())
+      return;
+    for (GeometryPool &pool : pools) {
+      glDeleteVertexArrays(1, &pool.VAO);
+      glDeleteBuffers(1, &pool.VBO);
+      glDeleteBuffers(1, &pool.EBO);
+    }
+    glDeleteBuffers(1, &drawDataBuffer);
+    if (indirectBuffer)
+      glDeleteBuffers(1, &indirectBuffer);
+  }
+
+  bool multiDraw() const {
+    return glMultiDrawElementsIndirectProc != nullptr;
+  }
+
+  // Copies every mesh of the model into the pools, false while it is still streaming in
+  bool add(Model &model) {
+    if (models.count(&model) != 0)
+      return true;
+    if (!model.ready())
+      return false;
+
+    vector<unsigned int> meshRanges;
+    for (Mesh &mesh : model.meshes)
+      meshRanges.push_back(add(mesh));
+    models[&model] = std::move(meshRanges);
+    return true;
+  }
+
+  // Every mesh of the model, added on first use
+  void submit(Model &model, const glm::mat4 &transform, unsigned int lod = 0) {
+    if (!add(model))
+      return;
+    for (unsigned int range : models[&model])
+      submissions.push_back({ range, lod, transform });
+  }
+
+  // Keeps the capacity, so a steady frame submits without allocating
+  void clear() {
+    submissions.clear();
+  }
+
+  Stats draw(Shader &shader) {
+    Stats stats;
+    if (submissions.empty())
+      return last = stats;
+
+    // 1. Group by pool and material, keeping the submission order inside a group
+    keys.clear();
+    for (uint32_t i = 0; i < submissions.size(); ++i) {
+      const GeometryRange &range = ranges[submissions[i].range];
+      keys.push_back({ ((uint64_t)range.pool << 32) | range.material, i });
+    }
+    draw_queue::radixSort(keys, scratch);
+
+    // 2. One command and one row of draw data per draw, rows in draw order
+    commands.clear();
+    drawData.clear();
+    for (const auto &key : keys) {
+      const Submission &submission = submissions[key.second];
+      const GeometryRange &range = ranges[submission.range];
+      const MeshLod &lod = range.mesh->lod(submission.lod);
+      GLuint row = (GLuint)drawData.size();
+      commands.push_back({ lod.indexCount, 1, range.firstIndex + lod.indexOffset, range.baseVertex, row });
+      bool packed = range.mesh->format == VertexFormat::Packed;
+      drawData.push_back({
+        submission.transform,
+        packed ? range.mesh->boundsMin : glm::vec3(0.0f),
+        packed ? quantizationScale(range.mesh->boundsMin, range.mesh->boundsMax) : glm::vec3(1.0f),
+      });
+    }
+
+    // 3. Orphan and refill the per draw buffers
+    glBindBuffer(GL_ARRAY_BUFFER, drawDataBuffer);
+    glBufferData(GL_ARRAY_BUFFER, drawData.size() * sizeof(GeometryDrawData), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, drawData.size() * sizeof(GeometryDrawData), drawData.data());
+    if (multiDraw()) {
+      glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+      glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW);
+      glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data());
+    }
+
+    // 4. One batch per run of draws sharing a pool and material
+    GLState &state = GLState::instance();
+    size_t first = 0;
+    while (first < keys.size()) {
+      size_t end = first + 1;
+      while (end < keys.size() && keys[end].first == keys[first].first)
+        end++;
+
+      const GeometryRange &range = ranges[submissions[keys[first].second].range];
+      const GeometryPool &pool = pools[range.pool];
+      range.mesh->setMaterial(shader);
+      state.bindVertexArray(pool.VAO);
+      if (multiDraw()) {
+        const void *offset = (const void*)(first * sizeof(DrawElementsIndirectCommand));
+        glMultiDrawElementsIndirectProc(GL_TRIANGLES, pool.indexType, offset, (GLsizei)(end - first), 0);
+        stats.calls++;
+      } else {
+        glBindBuffer(GL_ARRAY_BUFFER, drawDataBuffer);
+        for (size_t i = first; i < end; ++i) {
+          const DrawElementsIndirectCommand &command = commands[i];
+          setDrawDataAttributes(command.baseInstance * sizeof(GeometryDrawData));
+          const void *offset = (const void*)(command.firstIndex * indexSize(pool.indexType));
+          glDrawElementsBaseVertex(GL_TRIANGLES, command.count, pool.indexType, offset, command.baseVertex);
+          stats.calls++;
+        }
+      }
+      stats.batches++;
+      stats.draws += (unsigned int)(end - first);
+      first = end;
+    }
+    state.releaseVertexArray();
+    if (multiDraw())
+      glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    return last = stats;
+  }
+
+  size_t gpuBytes() const {
+    size_t bytes = 0;
+    for (const GeometryPool &pool : pools)
+      bytes += pool.vertexCapacity * vertexStride(pool.format) + pool.indexCapacity * indexSize(pool.indexType);
+    return bytes;
+  }
+
+  void printStats() const {
+    std::cout << "Geometry buffer: " << last.draws << " draws in " << last.batches << " batches, " << last.calls
+      << " draw calls (" << (multiDraw() ? "multi draw indirect" : "one per draw") << "), " << ranges.size()
+      << " meshes in " << pools.size() << " pools, " << gpuBytes() / (1024 * 1024) << " MiB" << std::endl;
+  }
+
+private:
+  // One vertex format and index type, suballocated front to back
+  struct GeometryPool {
+    VertexFormat format;
+    GLenum indexType;
+    unsigned int VAO = 0, VBO = 0, EBO = 0;
+    size_t vertexCapacity = 0, indexCapacity = 0;
+    size_t vertexCount = 0, indexCount = 0;
+  };
+
+  // Where a mesh lives in its pool; LOD offsets stay relative to firstIndex
+  struct GeometryRange {
+    unsigned int pool;
+    GLint baseVertex;
+    GLuint firstIndex;
+    unsigned int material;
+    Mesh *mesh;
+  };
+
+  struct Submission {
+    unsigned int range;
+    unsigned int lod;
+    glm::mat4 transform;
+  };
+
+  size_t vertexCapacity;
+  size_t indexCapacity;
+  PFNMULTIDRAWELEMENTSINDIRECTPROC glMultiDrawElementsIndirectProc = nullptr;
+  unsigned int drawDataBuffer = 0;
+  unsigned int indirectBuffer = 0;
+  vector<GeometryPool> pools;
+  vector<GeometryRange> ranges;
+  std::unordered_map<const Model*, vector<unsigned int>> models;
+  std::map<vector<unsigned int>, unsigned int> materials; // textures (and layers) to material id
+  vector<Submission> submissions;
+  vector<std::pair<uint64_t, uint32_t>> keys;
+  vector<std::pair<uint64_t, uint32_t>> scratch;
+  vector<DrawElementsIndirectCommand> commands;
+  vector<GeometryDrawData> drawData;
+  Stats last;
+
+  static size_t indexSize(GLenum indexType) {
+    return indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+  }
+
+  unsigned int add(Mesh &mesh) {
+    // 1. Find or create the pool for this layout and make room
+    unsigned int poolIndex = 0;
+    while (poolIndex < pools.size() && (pools[poolIndex].format != mesh.format || pools[poolIndex].indexType != mesh.indexType))
+      poolIndex++;
+    if (poolIndex == pools.size()) {
+      GeometryPool pool;
+      pool.format = mesh.format;
+      pool.indexType = mesh.indexType;
+      pools.push_back(pool);
+    }
+    GeometryPool &pool = pools[poolIndex];
+    reserve(pool, pool.vertexCount + mesh.vertexCount, pool.indexCount + mesh.indexCount);
+
+    // 2. Copy the mesh's buffers in, without touching any VAO's element binding
+    size_t stride = vertexStride(pool.format);
+    size_t indexBytes = indexSize(pool.indexType);
+    glBindBuffer(GL_COPY_READ_BUFFER, mesh.VBO);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, pool.VBO);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, pool.vertexCount * stride, (size_t)mesh.vertexCount * stride);
+    glBindBuffer(GL_COPY_READ_BUFFER, mesh.EBO);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, pool.EBO);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, pool.indexCount * indexBytes, (size_t)mesh.indexCount * indexBytes);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    // 3. Meshes with the same textures (and layers) share a material, and so a batch
+    vector<unsigned int> signature;
+    for (const Texture &texture : mesh.textures)
+      signature.push_back(texture.id);
+    for (const TextureLayer &layer : mesh.textureLayers) {
+      signature.push_back(layer.array);
+      signature.push_back(layer.layer);
+    }
+    auto material = materials.emplace(signature, (unsigned int)materials.size()).first;
+
+    GeometryRange range = { poolIndex, (GLint)pool.vertexCount, (GLuint)pool.indexCount, material->second, &mesh };
+    pool.vertexCount += mesh.vertexCount;
+    pool.indexCount += mesh.indexCount;
+    ranges.push_back(range);
+    return (unsigned int)ranges.size() - 1;
+  }
+
+  void reserve(GeometryPool &pool, size_t vertices, size_t indices) {
+    bool grown = false;
+    if (vertices > pool.vertexCapacity) {
+      size_t capacity = std::max(pool.vertexCapacity, vertexCapacity);
+      while (capacity < vertices)
+        capacity *= 2;
+      size_t stride = vertexStride(pool.format);
+      growBuffer(pool.VBO, pool.vertexCount * stride, capacity * stride);
+      pool.vertexCapacity = capacity;
+      grown = true;
+    }
+    if (indices > pool.indexCapacity) {
+      size_t capacity = std::max(pool.indexCapacity, indexCapacity);
+      while (capacity < indices)
+        capacity *= 2;
+      size_t indexBytes = indexSize(pool.indexType);
+      growBuffer(pool.EBO, pool.indexCount * indexBytes, capacity * indexBytes);
+      pool.indexCapacity = capacity;
+      grown = true;
+    }
+    if (grown)
+      setupVertexArray(pool);
+  }
+
+  // Moves the used bytes into a larger buffer, the old one is deleted
+  static void growBuffer(unsigned int &buffer, size_t usedBytes, size_t capacityBytes) {
+    unsigned int larger = 0;
+    glGenBuffers(1, &larger);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, larger);
+    glBufferData(GL_COPY_WRITE_BUFFER, capacityBytes, nullptr, GL_STATIC_DRAW);
+    if (buffer && usedBytes > 0) {
+      glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+      glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, usedBytes);
+      glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    if (buffer)
+      glDeleteBuffers(1, &buffer);
+    buffer = larger;
+  }
+
+  // Through GLState, as models streamed in get added in the middle of a frame
+  void setupVertexArray(GeometryPool &pool) {
+    GLState &state = GLState::instance();
+    if (!pool.VAO)
+      glGenVertexArrays(1, &pool.VAO);
+    state.bindVertexArray(pool.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, pool.VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.EBO);
+    setupVertexAttributes(pool.format);
+
+    glBindBuffer(GL_ARRAY_BUFFER, drawDataBuffer);
+    for (unsigned int i = 0; i < 4; ++i) {
+      glEnableVertexAttribArray(DRAW_MODEL_ATTRIBUTE + i);
+      glVertexAttribDivisor(DRAW_MODEL_ATTRIBUTE + i, 1);
+    }
+    glEnableVertexAttribArray(DRAW_POSITION_OFFSET_ATTRIBUTE);
+    glVertexAttribDivisor(DRAW_POSITION_OFFSET_ATTRIBUTE, 1);
+    glEnableVertexAttribArray(DRAW_POSITION_SCALE_ATTRIBUTE);
+    glVertexAttribDivisor(DRAW_POSITION_SCALE_ATTRIBUTE, 1);
+    setDrawDataAttributes(0);
+
+    state.bindVertexArray(0);
+  }
+
+  // Points the per draw attributes of the bound VAO at the row starting at offset
+  static void setDrawDataAttributes(size_t offset) {
+    for (unsigned int i = 0; i < 4; ++i) {
+      size_t column = offset + offsetof(GeometryDrawData, model) + i * sizeof(glm::vec4);
+      glVertexAttribPointer(DRAW_MODEL_ATTRIBUTE + i, 4, GL_FLOAT, GL_FALSE, sizeof(GeometryDrawData), (void*)column);
+    }
+    glVertexAttribPointer(DRAW_POSITION_OFFSET_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, sizeof(GeometryDrawData),
+      (void*)(offset + offsetof(GeometryDrawData, positionOffset)));
+    glVertexAttribPointer(DRAW_POSITION_SCALE_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, sizeof(GeometryDrawData),
+      (void*)(offset + offsetof(GeometryDrawData, positionScale)));
+  }
+};
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <array>
+#include <iostream>
+#include <glad/glad.h>
+
+/*
+* Cache of the GL bindings the examples touch most, so binding what is already bound costs no
+* driver call
+*
+*   programs, vertex arrays, draw and read framebuffers, textures per unit
+*
+* Capabilities, blend, depth and viewport state are left to raw GL: the examples only toggle
+* them once per pass, where there is nothing to filter.
+*
+* Filtering only happens between beginFrame() and endFrame(). Outside a frame every call goes
+* straight to GL, so examples that mix these calls with raw GL keep working unchanged. An
+* example that calls beginFrame() promises every one of these binds in the frame goes through here,
+* or calls invalidate() after the code that did not.
+*
+* Each frame counts the calls that were issued and the ones that were filtered out.
+*/
+class GLState {
+public:
+  struct Stats {
+    unsigned int issued = 0;
+    unsigned int filtered = 0;
+  };
+
+  static const unsigned int MAX_TEXTURE_UNITS = 32;
+
+  static GLState &instance() {
+    static GLState state;
+    return state;
+  }
+
+  void beginFrame() {
+    invalidate();
+    tracking = true;
+    frame = {};
+  }
+
+  Stats endFrame() {
+    tracking = false;
+    last = frame;
+    return last;
+  }
+
+  // Forgets everything, for after code that changed state behind the tracker's back
+  void invalidate() {
+    program = vertexArray = UNKNOWN;
+    drawFramebuffer = readFramebuffer = UNKNOWN;
+    activeUnit = UNKNOWN;
+    for (auto &unit : textures)
+      unit.fill(UNKNOWN);
+  }
+
+  bool active() const {
+    return tracking;
+  }
+
+  void useProgram(unsigned int id) {
+    if (filter(program == id))
+      return;
+    program = id;
+    glUseProgram(id);
+  }
+
+  void bindVertexArray(unsigned int id) {
+    if (filter(vertexArray == id))
+      return;
+    vertexArray = id;
+    glBindVertexArray(id);
+  }
+
+  // Only unbinds outside a frame, where untracked code could otherwise edit the last VAO
+  void releaseVertexArray() {
+    if (!tracking)
+      bindVertexArray(0);
+  }
+
+  // Back to unit 0 outside a frame, which untracked code expects to be active
+  void releaseTextureUnit() {
+    if (!tracking)
+      activeTexture(0);
+  }
+
+  // GL_FRAMEBUFFER sets both the draw and the read binding
+  void bindFramebuffer(GLenum target, unsigned int id) {
+    bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+    bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+    if (filter((!draw || drawFramebuffer == id) && (!read || readFramebuffer == id)))
+      return;
+    if (draw)
+      drawFramebuffer = id;
+    if (read)
+      readFramebuffer = id;
+    glBindFramebuffer(target, id);
+  }
+
+  // Leaves unit active, like glActiveTexture + glBindTexture would
+  void bindTexture(unsigned int unit, GLenum target, unsigned int id) {
+    int slot = targetSlot(target);
+    if (slot < 0 || unit >= MAX_TEXTURE_UNITS) {
+      activeTexture(unit);
+      frame.issued++;
+      glBindTexture(target, id);
+      return;
+    }
+    if (filter(textures[unit][slot] == id))
+      return;
+    activeTexture(unit);
+    textures[unit][slot] = id;
+    glBindTexture(target, id);
+  }
+
+  // Counts of the last finished frame
+  Stats lastFrame() const {
+    return last;
+  }
+
+  void printStats() const {
+    unsigned int total = last.issued + last.filtered;
+    std::cout << "GL state: " << last.issued << " calls issued, " << last.filtered << " filtered ("
+      << (total > 0 ? last.filtered * 100 / total : 0) << "%) last frame" << std::endl;
+  }
+
+private:
+  static const unsigned int UNKNOWN = 0xffffffffu;
+
+  bool tracking = false;
+  Stats frame;
+  Stats last;
+  unsigned int program = UNKNOWN;
+  unsigned int vertexArray = UNKNOWN;
+  unsigned int drawFramebuffer = UNKNOWN;
+  unsigned int readFramebuffer = UNKNOWN;
+  unsigned int activeUnit = UNKNOWN;
+  std::array<std::array<unsigned int, 4>, MAX_TEXTURE_UNITS> textures;
+
+  GLState() {
+    invalidate();
+  }
+
+  // Counts the call, true when it can be skipped
+  bool filter(bool unchanged) {
+    if (tracking && unchanged) {
+      frame.filtered++;
+      return true;
+    }
+    frame.issued++;
+    return false;
+  }
+
+  void activeTexture(unsigned int unit) {
+    if (tracking && activeUnit == unit)
+      return;
+    activeUnit = unit;
+    glActiveTexture(GL_TEXTURE0 + unit);
+  }
+
+  static int targetSlot(GLenum target) {
+    switch (target) {
+      case GL_TEXTURE_2D: return 0;
+      case GL_TEXTURE_2D_ARRAY: return 1;
+      case GL_TEXTURE_CUBE_MAP: return 2;
+      case GL_TEXTURE_2D_MULTISAMPLE: return 3;
+      default: return -1;
+    }
+  }
+};
+
+#endif
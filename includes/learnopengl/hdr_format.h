@@ -0,0 +1,204 @@
+#ifndef HDR_FORMAT_H
+#define HDR_FORMAT_H
+
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+using std::vector;
+
+/*
+* Packed HDR texel formats
+*
+*   RGB16F       48 bits, three halves; drivers usually pad it to RGBA16F, 64 bits
+*   RGB9E5       32 bits, 9 bit mantissas sharing a 5 bit exponent. Sampleable, not renderable
+*   R11G11B10F   32 bits, unsigned floats with 6/6/5 bit mantissas. Sampleable and renderable
+*
+* Both 32 bit formats only hold positive values, which is all radiance ever is. RGB9E5 keeps
+* more precision in the brightest channel, so it suits CPU baked environments; R11G11B10F is
+* the one to render HDR colour into. The pack functions round to nearest like GL does, and
+* measureHdrError() reports what a format loses against the float source.
+*/
+enum class HdrFormat {
+  RGB16F,
+  RGB9E5,
+  R11G11B10F,
+};
+
+struct HdrFormatGL {
+  GLenum internalFormat;
+  GLenum format;
+  GLenum type;
+  unsigned int texelBytes; // as uploaded, GL_UNPACK_ALIGNMENT 1 for RGB16F
+};
+
+inline HdrFormatGL hdrFormatGL(HdrFormat format) {
+  switch (format) {
+    case HdrFormat::RGB9E5: return { GL_RGB9_E5, GL_RGB, GL_UNSIGNED_INT_5_9_9_9_REV, 4 };
+    case HdrFormat::R11G11B10F: return { GL_R11F_G11F_B10F, GL_RGB, GL_UNSIGNED_INT_10F_11F_11F_REV, 4 };
+    default: return { GL_RGB16F, GL_RGB, GL_HALF_FLOAT, 6 };
+  }
+}
+
+inline const char *hdrFormatName(HdrFormat format) {
+  switch (format) {
+    case HdrFormat::RGB9E5: return "RGB9E5";
+    case HdrFormat::R11G11B10F: return "R11G11B10F";
+    default: return "RGB16F";
+  }
+}
+
+namespace hdr_format {
+  const int RGB9E5_MANTISSA_BITS = 9;
+  const int RGB9E5_EXPONENT_BIAS = 15;
+  const float RGB9E5_MAX = 65408.0f; // (2^9 - 1) / 2^9 * 2^16
+
+  // Positive float to an unsigned float with a 5 bit exponent (bias 15) and mantissaBits mantissa
+  inline uint32_t packUnsignedFloat(float value, int mantissaBits) {
+    const uint32_t maxFinite = (30u << mantissaBits) | ((1u << mantissaBits) - 1);
+    if (!(value > 0.0f))
+      return 0; // zero, negatives and NaN
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    int exponent = (int)((bits >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffff;
+    if (exponent >= 31)
+      return maxFinite;
+
+    int shift = 23 - mantissaBits;
+    if (exponent <= 0) {
+      // denormal: make the implicit one explicit and shift it into place
+      shift += 1 - exponent;
+      if (shift > 24)
+        return 0;
+      mantissa |= 0x800000;
+      exponent = 0;
+    }
+    uint32_t packed = ((uint32_t)exponent << mantissaBits) + (mantissa >> shift);
+    if (mantissa & (1u << (shift - 1)))
+      packed++; // a carry out of the mantissa correctly bumps the exponent
+    return std::min(packed, maxFinite);
+  }
+
+  inline float unpackUnsignedFloat(uint32_t packed, int mantissaBits) {
+    uint32_t exponent = packed >> mantissaBits;
+    float mantissa = (float)(packed & ((1u << mantissaBits) - 1)) / (float)(1u << mantissaBits);
+    if (exponent == 0)
+      return std::ldexp(mantissa, -14);
+    return std::ldexp(1.0f + mantissa, (int)exponent - 15);
+  }
+}
+
+// EXT_texture_shared_exponent: the largest channel picks the exponent, all three share it
+inline uint32_t packRGB9E5(const glm::vec3 &colour) {
+  using namespace hdr_format;
+  glm::vec3 c = glm::clamp(colour, 0.0f, RGB9E5_MAX);
+  c = glm::vec3(std::isnan(colour.r) ? 0.0f : c.r, std::isnan(colour.g) ? 0.0f : c.g, std::isnan(colour.b) ? 0.0f : c.b);
+  float largest = std::max(c.r, std::max(c.g, c.b));
+  if (largest <= 0.0f)
+    return 0;
+
+  int exponent = std::max(-RGB9E5_EXPONENT_BIAS - 1, (int)std::floor(std::log2(largest))) + 1 + RGB9E5_EXPONENT_BIAS;
+  float scale = std::ldexp(1.0f, exponent - RGB9E5_EXPONENT_BIAS - RGB9E5_MANTISSA_BITS);
+  if ((int)std::floor(largest / scale + 0.5f) == (1 << RGB9E5_MANTISSA_BITS)) {
+    exponent++;
+    scale *= 2.0f;
+  }
+  uint32_t r = (uint32_t)std::floor(c.r / scale + 0.5f);
+  uint32_t g = (uint32_t)std::floor(c.g / scale + 0.5f);
+  uint32_t b = (uint32_t)std::floor(c.b / scale + 0.5f);
+  return r | (g << 9) | (b << 18) | ((uint32_t)exponent << 27);
+}
+
+inline glm::vec3 unpackRGB9E5(uint32_t packed) {
+  using namespace hdr_format;
+  float scale = std::ldexp(1.0f, (int)(packed >> 27) - RGB9E5_EXPONENT_BIAS - RGB9E5_MANTISSA_BITS);
+  return glm::vec3(packed & 0x1ff, (packed >> 9) & 0x1ff, (packed >> 18) & 0x1ff) * scale;
+}
+
+// Red in the low 11 bits, then green, then blue in the top 10 (GL_UNSIGNED_INT_10F_11F_11F_REV)
+inline uint32_t packR11G11B10F(const glm::vec3 &colour) {
+  return hdr_format::packUnsignedFloat(colour.r, 6)
+    | (hdr_format::packUnsignedFloat(colour.g, 6) << 11)
+    | (hdr_format::packUnsignedFloat(colour.b, 5) << 22);
+}
+
+inline glm::vec3 unpackR11G11B10F(uint32_t packed) {
+  return glm::vec3(
+    hdr_format::unpackUnsignedFloat(packed & 0x7ff, 6),
+    hdr_format::unpackUnsignedFloat((packed >> 11) & 0x7ff, 6),
+    hdr_format::unpackUnsignedFloat(packed >> 22, 5));
+}
+
+// Texels laid out for glTexImage2D with hdrFormatGL(format)
+inline vector<uint8_t> packHdr(const glm::vec3 *texels, size_t count, HdrFormat format) {
+  vector<uint8_t> packed(count * hdrFormatGL(format).texelBytes);
+  for (size_t i = 0; i < count; ++i) {
+    if (format == HdrFormat::RGB16F) {
+      uint16_t halves[3] = { glm::packHalf1x16(texels[i].r), glm::packHalf1x16(texels[i].g), glm::packHalf1x16(texels[i].b) };
+      std::memcpy(&packed[i * 6], halves, sizeof(halves));
+      continue;
+    }
+    uint32_t value = format == HdrFormat::RGB9E5 ? packRGB9E5(texels[i]) : packR11G11B10F(texels[i]);
+    std::memcpy(&packed[i * 4], &value, sizeof(value));
+  }
+  return packed;
+}
+
+inline glm::vec3 unpackHdr(const uint8_t *texel, HdrFormat format) {
+  if (format == HdrFormat::RGB16F) {
+    uint16_t halves[3];
+    std::memcpy(halves, texel, sizeof(halves));
+    return glm::vec3(glm::unpackHalf1x16(halves[0]), glm::unpackHalf1x16(halves[1]), glm::unpackHalf1x16(halves[2]));
+  }
+  uint32_t value;
+  std::memcpy(&value, texel, sizeof(value));
+  return format == HdrFormat::RGB9E5 ? unpackRGB9E5(value) : unpackR11G11B10F(value);
+}
+
+/*
+* Error of a packed copy against its float source, relative to the brightest channel of each
+* texel so dark texels are not dominated by the rounding of their dimmest channel
+*/
+struct HdrError {
+  HdrFormat format = HdrFormat::RGB16F;
+  size_t texels = 0;
+  double meanRelative = 0.0;
+  double maxRelative = 0.0;
+
+  void print(const char *name) const {
+    std::cout << name << " as " << hdrFormatName(format) << ": " << std::fixed << std::setprecision(3)
+      << meanRelative * 100.0 << "% mean, " << maxRelative * 100.0 << "% max relative error over "
+      << texels << " texels" << std::defaultfloat << std::endl;
+  }
+};
+
+inline HdrError measureHdrError(const glm::vec3 *source, size_t count, HdrFormat format) {
+  HdrError error;
+  error.format = format;
+  error.texels = count;
+  vector<uint8_t> packed = packHdr(source, count, format);
+  unsigned int texelBytes = hdrFormatGL(format).texelBytes;
+  for (size_t i = 0; i < count; ++i) {
+    glm::vec3 expected = glm::max(source[i], 0.0f);
+    float brightest = std::max(expected.r, std::max(expected.g, expected.b));
+    if (brightest <= 1e-6f)
+      continue;
+    glm::vec3 difference = glm::abs(unpackHdr(&packed[i * texelBytes], format) - expected);
+    double relative = std::max(difference.r, std::max(difference.g, difference.b)) / brightest;
+    error.meanRelative += relative;
+    error.maxRelative = std::max(error.maxRelative, relative);
+  }
+  if (count > 0)
+    error.meanRelative /= (double)count;
+  return error;
+}
+
+#endif
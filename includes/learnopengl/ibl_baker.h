@@ -0,0 +1,443 @@
+#ifndef IBL_BAKER_H
+#define IBL_BAKER_H
+
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include "learnopengl/image_loader.h"
+#include "learnopengl/simd.h"
+
+using std::vector;
+
+/*
+* CPU image based lighting baker
+*
+* Does the work of the irradiance and prefilter convolution passes without a GL context, so an
+* environment can be baked headless:
+*
+*   equirectangularToCubemap  resamples an HDR panorama onto cube faces
+*   projectIrradianceSH       diffuse irradiance as 9 spherical harmonics coefficients
+*   prefilterGGX              importance sampled GGX specular levels, roughness 0 to 1
+*
+* Panoramas are read the way the cubemap shaders sample them (row 0 is the bottom, as loaded
+* with ImageLoader::setFlipVerticallyOnLoad(true)) and cube faces are laid out like GL's:
+* +X -X +Y -Y +Z -Z, each row by row from t = 0.
+*
+* Every stage is spread over the ImageLoader workers. The two expensive loops run four lanes
+* at a time through simd.h: the SH projection accumulates all 9 coefficients of a channel in
+* three registers, and the GGX prefilter turns four samples into light directions at once, then
+* filters each one as a single RGB register from a copy of the environment padded to 4 floats.
+*/
+struct FloatCubemap {
+  unsigned int size = 0;
+  vector<glm::vec3> texels; // 6 faces of size x size, one after another
+
+  glm::vec3 *face(unsigned int index) { return texels.data() + (size_t)index * size * size; }
+  const glm::vec3 *face(unsigned int index) const { return texels.data() + (size_t)index * size * size; }
+};
+
+/*
+* Irradiance / pi as 9 SH coefficients with the basis constants and cosine lobe folded in,
+* so evaluating it for a normal n only takes the polynomial terms:
+*
+*   c0 + c1 y + c2 z + c3 x + c4 xy + c5 yz + c6 (3z^2 - 1) + c7 xz + c8 (x^2 - y^2)
+*
+* The result matches what the 32x32 irradiance cubemap stored.
+*/
+struct IrradianceSH {
+  glm::vec3 coefficients[9] = {};
+
+  glm::vec3 evaluate(const glm::vec3 &n) const {
+    const glm::vec3 *c = coefficients;
+    return c[0]
+      + c[1] * n.y + c[2] * n.z + c[3] * n.x
+      + c[4] * (n.x * n.y) + c[5] * (n.y * n.z) + c[6] * (3.0f * n.z * n.z - 1.0f)
+      + c[7] * (n.x * n.z) + c[8] * (n.x * n.x - n.y * n.y);
+  }
+};
+
+namespace ibl_baker {
+  // Direction through the centre of texel (x, y) of a face, following the GL cubemap face table
+  inline glm::vec3 texelDirection(unsigned int face, unsigned int x, unsigned int y, unsigned int size) {
+    float s = 2.0f * (x + 0.5f) / size - 1.0f;
+    float t = 2.0f * (y + 0.5f) / size - 1.0f;
+    glm::vec3 direction;
+    switch (face) {
+      case 0: direction = glm::vec3(1.0f, -t, -s); break;
+      case 1: direction = glm::vec3(-1.0f, -t, s); break;
+      case 2: direction = glm::vec3(s, 1.0f, t); break;
+      case 3: direction = glm::vec3(s, -1.0f, -t); break;
+      case 4: direction = glm::vec3(s, -t, 1.0f); break;
+      default: direction = glm::vec3(-s, -t, -1.0f); break;
+    }
+    return glm::normalize(direction);
+  }
+
+  // Face and [0, 1] face coordinates a direction hits
+  inline unsigned int directionFace(const glm::vec3 &direction, float &s, float &t) {
+    glm::vec3 a = glm::abs(direction);
+    unsigned int face;
+    float sc, tc, major;
+    if (a.x >= a.y && a.x >= a.z) {
+      face = direction.x > 0.0f ? 0 : 1;
+      sc = direction.x > 0.0f ? -direction.z : direction.z;
+      tc = -direction.y;
+      major = a.x;
+    } else if (a.y >= a.z) {
+      face = direction.y > 0.0f ? 2 : 3;
+      sc = direction.x;
+      tc = direction.y > 0.0f ? direction.z : -direction.z;
+      major = a.y;
+    } else {
+      face = direction.z > 0.0f ? 4 : 5;
+      sc = direction.z > 0.0f ? direction.x : -direction.x;
+      tc = -direction.y;
+      major = a.z;
+    }
+    s = 0.5f * (sc / major + 1.0f);
+    t = 0.5f * (tc / major + 1.0f);
+    return face;
+  }
+
+  // Bilinear lookup within one face; edges clamp rather than crossing into the neighbour
+  inline glm::vec3 sampleCubemap(const FloatCubemap &cubemap, const glm::vec3 &direction) {
+    float s, t;
+    unsigned int face = directionFace(direction, s, t);
+    int size = (int)cubemap.size;
+    float x = s * size - 0.5f;
+    float y = t * size - 0.5f;
+    int x0 = (int)std::floor(x), y0 = (int)std::floor(y);
+    float fx = x - x0, fy = y - y0;
+    int x1 = glm::clamp(x0 + 1, 0, size - 1), y1 = glm::clamp(y0 + 1, 0, size - 1);
+    x0 = glm::clamp(x0, 0, size - 1);
+    y0 = glm::clamp(y0, 0, size - 1);
+    const glm::vec3 *texels = cubemap.face(face);
+    glm::vec3 top = glm::mix(texels[y0 * size + x0], texels[y0 * size + x1], fx);
+    glm::vec3 bottom = glm::mix(texels[y1 * size + x0], texels[y1 * size + x1], fx);
+    return glm::mix(top, bottom, fy);
+  }
+
+  // Trilinear lookup into a mip chain
+  inline glm::vec3 sampleCubemap(const vector<FloatCubemap> &levels, const glm::vec3 &direction, float lod) {
+    lod = glm::clamp(lod, 0.0f, (float)levels.size() - 1.0f);
+    unsigned int level = (unsigned int)lod;
+    float blend = lod - level;
+    glm::vec3 colour = sampleCubemap(levels[level], direction);
+    if (blend > 0.0f && level + 1 < levels.size())
+      colour = glm::mix(colour, sampleCubemap(levels[level + 1], direction), blend);
+    return colour;
+  }
+
+  inline glm::vec3 samplePanorama(const float *rgb, unsigned int width, unsigned int height, const glm::vec3 &direction) {
+    float u = std::atan2(direction.z, direction.x) * glm::one_over_two_pi<float>() + 0.5f;
+    float v = std::asin(glm::clamp(direction.y, -1.0f, 1.0f)) * glm::one_over_pi<float>() + 0.5f;
+    float x = u * width - 0.5f;
+    float y = glm::clamp(v * height - 0.5f, 0.0f, height - 1.0f);
+    int x0 = (int)std::floor(x), y0 = (int)y;
+    float fx = x - x0, fy = y - y0;
+    int x1 = (x0 + 1) % (int)width;
+    x0 = (x0 + (int)width) % (int)width;
+    int y1 = std::min(y0 + 1, (int)height - 1);
+    auto texel = [&](int tx, int ty) {
+      const float *p = rgb + ((size_t)ty * width + tx) * 3;
+      return glm::vec3(p[0], p[1], p[2]);
+    };
+    glm::vec3 top = glm::mix(texel(x0, y0), texel(x1, y0), fx);
+    glm::vec3 bottom = glm::mix(texel(x0, y1), texel(x1, y1), fx);
+    return glm::mix(top, bottom, fy);
+  }
+
+  inline glm::vec2 hammersley(unsigned int i, unsigned int count) {
+    uint32_t bits = i;
+    bits = (bits << 16u) | (bits >> 16u);
+    bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+    bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+    bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+    bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+    return glm::vec2((float)i / count, bits * 2.3283064365386963e-10f);
+  }
+
+  // GGX half vector around +Z for a Hammersley point; N = V = R, so the pdf is D / 4
+  inline glm::vec3 importanceSampleGGX(const glm::vec2 &xi, float roughness, float &pdf) {
+    float a = roughness * roughness;
+    float phi = glm::two_pi<float>() * xi.x;
+    float cosTheta = std::sqrt((1.0f - xi.y) / (1.0f + (a * a - 1.0f) * xi.y));
+    float sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+    float denominator = cosTheta * cosTheta * (a * a - 1.0f) + 1.0f;
+    float distribution = a * a / (glm::pi<float>() * denominator * denominator);
+    pdf = distribution * 0.25f + 0.0001f;
+    return glm::vec3(std::cos(phi) * sinTheta, std::sin(phi) * sinTheta, cosTheta);
+  }
+
+  // An environment mip with a padding float after every texel, so a texel is one register
+  struct PaddedCubemap {
+    unsigned int size = 0;
+    vector<float> texels;
+  };
+
+  inline vector<PaddedCubemap> padCubemaps(const vector<FloatCubemap> &levels) {
+    vector<PaddedCubemap> padded(levels.size());
+    for (size_t level = 0; level < levels.size(); ++level) {
+      padded[level].size = levels[level].size;
+      padded[level].texels.resize(levels[level].texels.size() * 4);
+      float *out = padded[level].texels.data();
+      for (const glm::vec3 &texel : levels[level].texels) {
+        out[0] = texel.r;
+        out[1] = texel.g;
+        out[2] = texel.b;
+        out[3] = 0.0f;
+        out += 4;
+      }
+    }
+    return padded;
+  }
+
+  // sampleCubemap on a padded level, the four texels weighted in one register each
+  inline simd::Float4 sampleCubemap(const PaddedCubemap &cubemap, const glm::vec3 &direction) {
+    float s, t;
+    unsigned int face = directionFace(direction, s, t);
+    int size = (int)cubemap.size;
+    float x = s * size - 0.5f;
+    float y = t * size - 0.5f;
+    int x0 = (int)std::floor(x), y0 = (int)std::floor(y);
+    float fx = x - x0, fy = y - y0;
+    int x1 = glm::clamp(x0 + 1, 0, size - 1), y1 = glm::clamp(y0 + 1, 0, size - 1);
+    x0 = glm::clamp(x0, 0, size - 1);
+    y0 = glm::clamp(y0, 0, size - 1);
+    const float *texels = cubemap.texels.data() + (size_t)face * size * size * 4;
+    simd::Float4 colour = simd::mul(simd::load(texels + (y0 * size + x0) * 4), simd::splat((1.0f - fx) * (1.0f - fy)));
+    colour = simd::madd(simd::load(texels + (y0 * size + x1) * 4), simd::splat(fx * (1.0f - fy)), colour);
+    colour = simd::madd(simd::load(texels + (y1 * size + x0) * 4), simd::splat((1.0f - fx) * fy), colour);
+    return simd::madd(simd::load(texels + (y1 * size + x1) * 4), simd::splat(fx * fy), colour);
+  }
+
+  inline simd::Float4 sampleCubemap(const vector<PaddedCubemap> &levels, const glm::vec3 &direction, float lod) {
+    lod = glm::clamp(lod, 0.0f, (float)levels.size() - 1.0f);
+    unsigned int level = (unsigned int)lod;
+    float blend = lod - level;
+    simd::Float4 colour = sampleCubemap(levels[level], direction);
+    if (blend > 0.0f && level + 1 < levels.size()) {
+      colour = simd::mul(colour, simd::splat(1.0f - blend));
+      colour = simd::madd(sampleCubemap(levels[level + 1], direction), simd::splat(blend), colour);
+    }
+    return colour;
+  }
+
+  // 2x2 box downsample of every face
+  inline FloatCubemap downsample(const FloatCubemap &source) {
+    FloatCubemap result;
+    result.size = std::max(source.size / 2, 1u);
+    result.texels.resize((size_t)result.size * result.size * 6);
+    for (unsigned int face = 0; face < 6; ++face) {
+      const glm::vec3 *in = source.face(face);
+      glm::vec3 *out = result.face(face);
+      for (unsigned int y = 0; y < result.size; ++y) {
+        unsigned int y0 = std::min(y * 2, source.size - 1), y1 = std::min(y * 2 + 1, source.size - 1);
+        for (unsigned int x = 0; x < result.size; ++x) {
+          unsigned int x0 = std::min(x * 2, source.size - 1), x1 = std::min(x * 2 + 1, source.size - 1);
+          out[y * result.size + x] = 0.25f * (in[y0 * source.size + x0] + in[y0 * source.size + x1]
+                                            + in[y1 * source.size + x0] + in[y1 * source.size + x1]);
+        }
+      }
+    }
+    return result;
+  }
+}
+
+inline FloatCubemap equirectangularToCubemap(const float *rgb, unsigned int width, unsigned int height, unsigned int size) {
+  FloatCubemap cubemap;
+  cubemap.size = size;
+  cubemap.texels.resize((size_t)size * size * 6);
+  ImageLoader::instance().parallelFor((size_t)size * 6, [&](size_t row) {
+    unsigned int face = (unsigned int)(row / size);
+    unsigned int y = (unsigned int)(row % size);
+    glm::vec3 *out = cubemap.face(face) + (size_t)y * size;
+    for (unsigned int x = 0; x < size; ++x)
+      out[x] = ibl_baker::samplePanorama(rgb, width, height, ibl_baker::texelDirection(face, x, y, size));
+  });
+  return cubemap;
+}
+
+// Every level of a cubemap down to 1x1, the given one first
+inline vector<FloatCubemap> buildCubemapMips(FloatCubemap base) {
+  vector<FloatCubemap> levels;
+  levels.push_back(std::move(base));
+  while (levels.back().size > 1)
+    levels.push_back(ibl_baker::downsample(levels.back()));
+  return levels;
+}
+
+/*
+* Projects the panorama straight onto the SH basis (every texel weighted by its solid angle),
+* then convolves with the clamped cosine lobe: band l is scaled by A_l / pi = 1, 2/3, 1/4
+*/
+inline IrradianceSH projectIrradianceSH(const float *rgb, unsigned int width, unsigned int height) {
+  // 1. Per row partial sums so rows can run in parallel and be added up in a fixed order.
+  //    A texel's 9 basis values sit in three registers (the last one padded), each scaled by r,
+  //    g and b into three registers per channel
+  vector<IrradianceSH> rows(height);
+  float texelAngle = glm::two_pi<float>() / width * glm::pi<float>() / height;
+  vector<float> cosLongitude(width), sinLongitude(width);
+  for (unsigned int x = 0; x < width; ++x) {
+    float longitude = ((x + 0.5f) / width - 0.5f) * glm::two_pi<float>();
+    cosLongitude[x] = std::cos(longitude);
+    sinLongitude[x] = std::sin(longitude);
+  }
+  ImageLoader::instance().parallelFor(height, [&](size_t y) {
+    const simd::Float4 BAND_0_1 = simd::set(0.282095f, 0.488603f, 0.488603f, 0.488603f);
+    const simd::Float4 BAND_2 = simd::set(1.092548f, 1.092548f, 0.315392f, 1.092548f);
+    float latitude = ((y + 0.5f) / height - 0.5f) * glm::pi<float>();
+    float cosLatitude = std::cos(latitude), sinLatitude = std::sin(latitude);
+    float weight = texelAngle * cosLatitude;
+    simd::Float4 sum[3][3];
+    for (auto &channel : sum)
+      for (simd::Float4 &lanes : channel)
+        lanes = simd::zero();
+
+    const float *p = rgb + (size_t)y * width * 3;
+    for (unsigned int x = 0; x < width; ++x, p += 3) {
+      float nx = cosLatitude * cosLongitude[x], ny = sinLatitude, nz = cosLatitude * sinLongitude[x];
+      simd::Float4 basis[3] = {
+        simd::mul(simd::set(1.0f, ny, nz, nx), BAND_0_1),
+        simd::mul(simd::set(nx * ny, ny * nz, 3.0f * nz * nz - 1.0f, nx * nz), BAND_2),
+        simd::set(0.546274f * (nx * nx - ny * ny), 0.0f, 0.0f, 0.0f),
+      };
+      for (unsigned int c = 0; c < 3; ++c) {
+        simd::Float4 radiance = simd::splat(p[c] * weight);
+        for (unsigned int i = 0; i < 3; ++i)
+          sum[c][i] = simd::madd(basis[i], radiance, sum[c][i]);
+      }
+    }
+
+    float lanes[3][12];
+    for (unsigned int c = 0; c < 3; ++c)
+      for (unsigned int i = 0; i < 3; ++i)
+        simd::store(lanes[c] + i * 4, sum[c][i]);
+    for (unsigned int k = 0; k < 9; ++k)
+      rows[y].coefficients[k] = glm::vec3(lanes[0][k], lanes[1][k], lanes[2][k]);
+  });
+
+  // 2. Fold in the cosine lobe and the basis constants for IrradianceSH::evaluate
+  const float scale[9] = {
+    1.0f * 0.282095f,
+    2.0f / 3.0f * 0.488603f, 2.0f / 3.0f * 0.488603f, 2.0f / 3.0f * 0.488603f,
+    0.25f * 1.092548f, 0.25f * 1.092548f, 0.25f * 0.315392f, 0.25f * 1.092548f, 0.25f * 0.546274f,
+  };
+  IrradianceSH sh;
+  for (const IrradianceSH &row : rows)
+    for (unsigned int i = 0; i < 9; ++i)
+      sh.coefficients[i] += row.coefficients[i];
+  for (unsigned int i = 0; i < 9; ++i)
+    sh.coefficients[i] *= scale[i];
+  return sh;
+}
+
+/*
+* Prefiltered specular levels for the split sum: level m has roughness m / (levels - 1).
+* Each sample reads the environment mip whose texel footprint matches the sample's solid
+* angle, which keeps bright spots from turning into dots with few samples. Level 0 is a
+* straight copy of the environment at that size.
+*/
+inline vector<FloatCubemap> prefilterGGX(const vector<FloatCubemap> &environment, unsigned int size,
+                                         unsigned int levels, unsigned int sampleCount = 1024) {
+  // 1. The sample set is the same for every texel of a level, only rotated. Stored as one
+  //    array per component, padded to whole registers with h = 0, which gives l = -n and is
+  //    skipped like any other sample below the horizon
+  struct Samples {
+    vector<float> x, y, z, lod;
+  };
+  size_t paddedCount = (sampleCount + 3) / 4 * 4;
+  vector<Samples> samples(levels);
+  float texelAngle = 4.0f * glm::pi<float>() / (6.0f * environment[0].size * environment[0].size);
+  for (unsigned int level = 1; level < levels; ++level) {
+    float roughness = (float)level / (levels - 1);
+    Samples &set = samples[level];
+    set.x.assign(paddedCount, 0.0f);
+    set.y.assign(paddedCount, 0.0f);
+    set.z.assign(paddedCount, 0.0f);
+    set.lod.assign(paddedCount, 0.0f);
+    for (unsigned int i = 0; i < sampleCount; ++i) {
+      float pdf;
+      glm::vec3 h = ibl_baker::importanceSampleGGX(ibl_baker::hammersley(i, sampleCount), roughness, pdf);
+      float sampleAngle = 1.0f / (sampleCount * pdf + 0.0001f);
+      set.x[i] = h.x;
+      set.y[i] = h.y;
+      set.z[i] = h.z;
+      set.lod[i] = 0.5f * std::log2(sampleAngle / texelAngle);
+    }
+  }
+  vector<ibl_baker::PaddedCubemap> padded = ibl_baker::padCubemaps(environment);
+
+  // 2. One row of one face of one level per work item
+  vector<FloatCubemap> result(levels);
+  vector<size_t> firstRow(levels + 1, 0);
+  for (unsigned int level = 0; level < levels; ++level) {
+    result[level].size = std::max(size >> level, 1u);
+    result[level].texels.resize((size_t)result[level].size * result[level].size * 6);
+    firstRow[level + 1] = firstRow[level] + (size_t)result[level].size * 6;
+  }
+  ImageLoader::instance().parallelFor(firstRow[levels], [&](size_t row) {
+    unsigned int level = (unsigned int)(std::upper_bound(firstRow.begin(), firstRow.end(), row) - firstRow.begin() - 1);
+    FloatCubemap &target = result[level];
+    unsigned int face = (unsigned int)((row - firstRow[level]) / target.size);
+    unsigned int y = (unsigned int)((row - firstRow[level]) % target.size);
+    glm::vec3 *out = target.face(face) + (size_t)y * target.size;
+    for (unsigned int x = 0; x < target.size; ++x) {
+      glm::vec3 n = ibl_baker::texelDirection(face, x, y, target.size);
+      if (level == 0) {
+        out[x] = ibl_baker::sampleCubemap(environment, n, std::log2((float)environment[0].size / target.size));
+        continue;
+      }
+
+      glm::vec3 up = std::fabs(n.z) < 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+      glm::vec3 tangent = glm::normalize(glm::cross(up, n));
+      glm::vec3 bitangent = glm::cross(n, tangent);
+      simd::Float4 basis[3][3] = {
+        { simd::splat(tangent.x), simd::splat(bitangent.x), simd::splat(n.x) },
+        { simd::splat(tangent.y), simd::splat(bitangent.y), simd::splat(n.y) },
+        { simd::splat(tangent.z), simd::splat(bitangent.z), simd::splat(n.z) },
+      };
+      simd::Float4 normal[3] = { basis[0][2], basis[1][2], basis[2][2] };
+      simd::Float4 negativeNormal[3] = { simd::splat(-n.x), simd::splat(-n.y), simd::splat(-n.z) };
+      simd::Float4 colour = simd::zero();
+      float totalWeight = 0.0f;
+
+      const Samples &set = samples[level];
+      for (size_t i = 0; i < paddedCount; i += 4) {
+        // h = tangent hx + bitangent hy + n hz, l = 2 (n.h) h - n, four samples per register
+        simd::Float4 hx = simd::load(&set.x[i]), hy = simd::load(&set.y[i]), hz = simd::load(&set.z[i]);
+        simd::Float4 h[3];
+        for (unsigned int c = 0; c < 3; ++c)
+          h[c] = simd::madd(basis[c][0], hx, simd::madd(basis[c][1], hy, simd::mul(basis[c][2], hz)));
+        simd::Float4 nDotH = simd::madd(normal[0], h[0], simd::madd(normal[1], h[1], simd::mul(normal[2], h[2])));
+        simd::Float4 twoNDotH = simd::add(nDotH, nDotH);
+        simd::Float4 l[3];
+        for (unsigned int c = 0; c < 3; ++c)
+          l[c] = simd::madd(twoNDotH, h[c], negativeNormal[c]);
+        simd::Float4 nDotL = simd::madd(normal[0], l[0], simd::madd(normal[1], l[1], simd::mul(normal[2], l[2])));
+
+        float lx[4], ly[4], lz[4], weights[4];
+        simd::store(lx, l[0]);
+        simd::store(ly, l[1]);
+        simd::store(lz, l[2]);
+        simd::store(weights, nDotL);
+        for (unsigned int lane = 0; lane < 4; ++lane) {
+          if (weights[lane] <= 0.0f)
+            continue;
+          glm::vec3 direction(lx[lane], ly[lane], lz[lane]);
+          colour = simd::madd(ibl_baker::sampleCubemap(padded, direction, set.lod[i + lane]), simd::splat(weights[lane]), colour);
+          totalWeight += weights[lane];
+        }
+      }
+      float rgb[4];
+      simd::store(rgb, colour);
+      out[x] = totalWeight > 0.0f ? glm::vec3(rgb[0], rgb[1], rgb[2]) / totalWeight : glm::vec3(0.0f);
+    }
+  });
+  return result;
+}
+
+#endif
@@ -0,0 +1,277 @@
+#ifndef IBL_CACHE_H
+#define IBL_CACHE_H
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include <glad/glad.h>
+#include "learnopengl/ibl_baker.h"
+#include "learnopengl/hdr_format.h"
+
+using std::vector;
+using std::string;
+
+/*
+* Persistent cache for baked image based lighting
+*
+* Baking an environment (equirectangular to cubemap, irradiance SH and prefiltered specular
+* levels) takes seconds on every start. An IblCache writes the products out after the
+* first bake, textures in the packed HDR format they live in on the GPU, and uploads them
+* straight back afterwards.
+*
+*   [IblCacheHeader]
+*   [irradiance   9 SH coefficients,                   RGB32F]
+*   [environment  level 0..n, faces +X -X +Y -Y +Z -Z, IblBakeSettings::format]
+*   [prefilter    level 0..n, faces,                   IblBakeSettings::format]
+*
+* The BRDF LUT is not part of it, it does not depend on the environment (see brdf_lut.h).
+*
+* Files are named after an FNV-1a hash of the source image's contents, the bake settings and
+* the contents of any other files the bake depends on, so editing any of them simply misses
+* and bakes again.
+*/
+const uint32_t IBL_CACHE_MAGIC = 0x4c42494c; // "LIBL"
+const uint32_t IBL_CACHE_VERSION = 4; // 2: SH irradiance, CPU bake, 3: no BRDF LUT, 4: packed formats
+
+struct IblBakeSettings {
+  unsigned int environmentSize = 512;
+  unsigned int prefilterSize = 128;
+  unsigned int prefilterLevels = 5;
+  unsigned int prefilterSamples = 1024;
+  // RGB9E5 takes half the memory of RGB16F (drivers pad it to RGBA16F) and stays within 0.2% of the float bake
+  HdrFormat format = HdrFormat::RGB9E5;
+};
+
+struct IblMaps {
+  unsigned int environment = 0;
+  unsigned int prefilter = 0;
+  IrradianceSH irradiance;
+};
+
+struct IblCacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key;
+  uint32_t environmentSize;
+  uint32_t environmentLevels;
+  uint32_t prefilterSize;
+  uint32_t prefilterLevels;
+  uint32_t prefilterSamples;
+  uint32_t format;
+};
+
+class IblCache {
+public:
+  // dependencies: files whose contents shape the bake besides the source, e.g. bake shaders
+  IblCache(const string &sourcePath, IblBakeSettings settings = {}, const vector<string> &dependencies = {})
+    : settings(settings) {
+    uint64_t hash = FNV_OFFSET;
+    hashFile(sourcePath, hash);
+    for (const string &dependency : dependencies)
+      hashFile(dependency, hash);
+    const unsigned int values[] = { settings.environmentSize, settings.prefilterSize, settings.prefilterLevels,
+                                    settings.prefilterSamples, (unsigned int)settings.format, IBL_CACHE_VERSION };
+    hashBytes(values, sizeof(values), hash);
+    key = hash;
+
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+    cachePath = string(CACHE_DIR) + "/ibl/" + name + ".iblcache";
+  }
+
+  /*
+  * Creates a trilinear cubemap from texels already packed as `format`, every level of face
+  * +X, -X, +Y, -Y, +Z, -Z in turn; cursor is left after the last one
+  */
+  static unsigned int createCubemap(HdrFormat format, unsigned int size, unsigned int levels, const char *&cursor) {
+    HdrFormatGL gl = hdrFormatGL(format);
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+    for (unsigned int level = 0; level < levels; ++level) {
+      unsigned int levelSize = std::max(size >> level, 1u);
+      for (unsigned int face = 0; face < 6; ++face) {
+        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, level, gl.internalFormat, levelSize, levelSize, 0, gl.format, gl.type, cursor);
+        cursor += (size_t)levelSize * levelSize * gl.texelBytes;
+      }
+    }
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    return texture;
+  }
+
+  // Packs CPU baked levels (see ibl_baker.h) and uploads them like createCubemap
+  static unsigned int createCubemap(HdrFormat format, const vector<FloatCubemap> &levels) {
+    vector<uint8_t> packed;
+    for (const FloatCubemap &level : levels) {
+      vector<uint8_t> texels = packHdr(level.texels.data(), level.texels.size(), format);
+      packed.insert(packed.end(), texels.begin(), texels.end());
+    }
+    GLint alignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    const char *cursor = reinterpret_cast<const char*>(packed.data());
+    unsigned int texture = createCubemap(format, levels[0].size, (unsigned int)levels.size(), cursor);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+    return texture;
+  }
+
+  // Levels in a full mip chain down to 1x1, as the environment cubemap has
+  static unsigned int fullMipCount(unsigned int size) {
+    unsigned int levels = 1;
+    while (size > 1) {
+      size /= 2;
+      levels++;
+    }
+    return levels;
+  }
+
+  /*
+  * Creates the textures from the cache file, with the same formats and sampling the bake
+  * uses, and reads back the irradiance SH. Returns false on a missing or mismatching file
+  * so the caller can bake instead.
+  */
+  bool load(IblMaps &maps) {
+    std::ifstream in(cachePath, std::ios::binary | std::ios::ate);
+    if (!in)
+      return false;
+    vector<char> bytes((size_t)in.tellg());
+    in.seekg(0);
+    in.read(bytes.data(), bytes.size());
+    if (!in || bytes.size() < sizeof(IblCacheHeader))
+      return false;
+
+    // 1. Validate the header against what this run would bake
+    IblCacheHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != IBL_CACHE_MAGIC || header.version != IBL_CACHE_VERSION || header.key != key)
+      return false;
+    if (bytes.size() != sizeof(IblCacheHeader) + payloadBytes())
+      return false;
+
+    // 2. Upload each product level by level; RGB16F rows of 1 texel are 6 bytes, so unpack unaligned
+    GLint alignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    const char *cursor = bytes.data() + sizeof(IblCacheHeader);
+    std::memcpy(maps.irradiance.coefficients, cursor, sizeof(maps.irradiance.coefficients));
+    cursor += sizeof(maps.irradiance.coefficients);
+    maps.environment = createCubemap(settings.format, settings.environmentSize, fullMipCount(settings.environmentSize), cursor);
+    maps.prefilter = createCubemap(settings.format, settings.prefilterSize, settings.prefilterLevels, cursor);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+    return true;
+  }
+
+  /*
+  * Reads the baked textures back from the GPU and writes them out for the next run
+  */
+  bool save(const IblMaps &maps) {
+    IblCacheHeader header = {};
+    header.magic = IBL_CACHE_MAGIC;
+    header.version = IBL_CACHE_VERSION;
+    header.key = key;
+    header.environmentSize = settings.environmentSize;
+    header.environmentLevels = fullMipCount(settings.environmentSize);
+    header.prefilterSize = settings.prefilterSize;
+    header.prefilterLevels = settings.prefilterLevels;
+    header.prefilterSamples = settings.prefilterSamples;
+    header.format = (uint32_t)settings.format;
+
+    // 1. Read every level of every face back as stored
+    vector<char> payload(payloadBytes());
+    char *cursor = payload.data();
+    std::memcpy(cursor, maps.irradiance.coefficients, sizeof(maps.irradiance.coefficients));
+    cursor += sizeof(maps.irradiance.coefficients);
+    GLint alignment;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    readCubemap(maps.environment, settings.format, settings.environmentSize, header.environmentLevels, cursor);
+    readCubemap(maps.prefilter, settings.format, settings.prefilterSize, settings.prefilterLevels, cursor);
+    glPixelStorei(GL_PACK_ALIGNMENT, alignment);
+
+    // 2. Write to a temporary file and rename, so a crash never leaves a half written cache
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+    string temporaryPath = cachePath + ".tmp";
+    std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      std::cout << "ERROR::IBL_CACHE::FAILED_TO_WRITE " << cachePath << std::endl;
+      return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(payload.data(), payload.size());
+    out.close();
+    if (!out) {
+      std::filesystem::remove(temporaryPath, error);
+      return false;
+    }
+    std::filesystem::rename(temporaryPath, cachePath, error);
+    return !error;
+  }
+
+private:
+  static const uint64_t FNV_OFFSET = 14695981039346656037ull;
+
+  IblBakeSettings settings;
+  uint64_t key = 0;
+  string cachePath;
+
+  static void hashBytes(const void *data, size_t size, uint64_t &hash) {
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash ^= bytes[i];
+      hash *= 1099511628211ull;
+    }
+  }
+
+  // A missing file still changes the hash, so it can never collide with the real contents
+  static void hashFile(const string &path, uint64_t &hash) {
+    hashBytes(path.data(), path.size(), hash);
+    std::ifstream in(path, std::ios::binary);
+    char buffer[65536];
+    while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0)
+      hashBytes(buffer, (size_t)in.gcount(), hash);
+  }
+
+  static size_t cubemapBytes(HdrFormat format, unsigned int size, unsigned int levels) {
+    size_t bytes = 0;
+    for (unsigned int level = 0; level < levels; ++level) {
+      unsigned int levelSize = std::max(size >> level, 1u);
+      bytes += (size_t)levelSize * levelSize * 6 * hdrFormatGL(format).texelBytes;
+    }
+    return bytes;
+  }
+
+  size_t payloadBytes() const {
+    return sizeof(IrradianceSH::coefficients)
+      + cubemapBytes(settings.format, settings.environmentSize, fullMipCount(settings.environmentSize))
+      + cubemapBytes(settings.format, settings.prefilterSize, settings.prefilterLevels);
+  }
+
+  static void readCubemap(unsigned int texture, HdrFormat format, unsigned int size, unsigned int levels, char *&cursor) {
+    HdrFormatGL gl = hdrFormatGL(format);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+    for (unsigned int level = 0; level < levels; ++level) {
+      unsigned int levelSize = std::max(size >> level, 1u);
+      for (unsigned int face = 0; face < 6; ++face) {
+        glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, level, gl.format, gl.type, cursor);
+        cursor += (size_t)levelSize * levelSize * gl.texelBytes;
+      }
+    }
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+  }
+};
+
+#endif
@@ -0,0 +1,235 @@
+#ifndef IMAGE_LOADER_H
+#define IMAGE_LOADER_H
+
+#include <stbi_image.h>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <future>
+#include <functional>
+#include <condition_variable>
+
+using std::vector;
+using std::string;
+
+/*
+* Decoded pixels handed back from the loader. Owns the stb buffer, so it can only be moved.
+*/
+struct Image {
+  string path;
+  int width = 0;
+  int height = 0;
+  int channels = 0;
+  bool hdr = false;
+  void *pixels = nullptr;
+
+  Image() {}
+  Image(const Image&) = delete;
+  Image &operator=(const Image&) = delete;
+
+  Image(Image &&other) noexcept {
+    *this = std::move(other);
+  }
+
+  Image &operator=(Image &&other) noexcept {
+    if (this != &other) {
+      release();
+      path = std::move(other.path);
+      width = other.width;
+      height = other.height;
+      channels = other.channels;
+      hdr = other.hdr;
+      pixels = other.pixels;
+      other.pixels = nullptr;
+    }
+    return *this;
+  }
+
+  ~Image() {
+    release();
+  }
+
+  bool valid() const { return pixels != nullptr; }
+  unsigned char *data() const { return static_cast<unsigned char*>(pixels); }
+  float *hdrData() const { return static_cast<float*>(pixels); }
+
+  void release() {
+    if (pixels)
+      stbi_image_free(pixels);
+    pixels = nullptr;
+  }
+};
+
+struct ImageRequest {
+  string path;              // absolute path, e.g. RESOURCES_DIR + "/textures/container.jpg"
+  int desiredChannels = 0;  // 0 keeps the file's channel count
+  bool hdr = false;         // decode with stbi_loadf
+  int flip = -1;            // -1 follows ImageLoader::setFlipVerticallyOnLoad
+};
+
+/*
+* Shared image decoding service
+*
+* Decodes on a pool of worker threads and hands finished pixel buffers back to the caller,
+* which stays responsible for the GL upload. loadAll() returns images in request order, so
+* uploads happen in the same deterministic order as the old synchronous stbi_load calls.
+*/
+class ImageLoader {
+public:
+  static ImageLoader &instance() {
+    static ImageLoader loader;
+    return loader;
+  }
+
+  // stb keeps its flip flag per thread for the workers, so mirror the global flag here
+  static void setFlipVerticallyOnLoad(bool flip) {
+    flipByDefault() = flip;
+    stbi_set_flip_vertically_on_load(flip);
+  }
+
+  static bool flipVerticallyOnLoad() {
+    return flipByDefault();
+  }
+
+  std::future<Image> submit(ImageRequest request) {
+    if (request.flip < 0)
+      request.flip = flipByDefault() ? 1 : 0;
+
+    auto task = std::make_shared<std::packaged_task<Image()>>([request]() {
+      return decode(request);
+    });
+    std::future<Image> result = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      queue.push_back([task]() { (*task)(); });
+    }
+    available.notify_one();
+    return result;
+  }
+
+  vector<Image> loadAll(const vector<ImageRequest> &requests) {
+    vector<std::future<Image>> pending;
+    pending.reserve(requests.size());
+    for (const ImageRequest &request : requests)
+      pending.push_back(submit(request));
+
+    vector<Image> images;
+    images.reserve(requests.size());
+    for (std::future<Image> &result : pending)
+      images.push_back(result.get());
+    return images;
+  }
+
+  unsigned int workerCount() const {
+    return (unsigned int)workers.size();
+  }
+
+  /*
+  * Calls work(i) for every i < count on the workers and the calling thread, returning once all
+  * of them have run. The caller takes items as well, so the loop finishes even while every
+  * worker is busy decoding; a worker that only gets to its task afterwards finds nothing left.
+  */
+  template <typename Work>
+  void parallelFor(size_t count, Work work) {
+    if (count == 0)
+      return;
+    struct Batch {
+      std::atomic<size_t> next { 0 };
+      std::atomic<size_t> finished { 0 };
+      std::mutex mutex;
+      std::condition_variable done;
+    };
+    auto batch = std::make_shared<Batch>();
+    // work is only touched while an item is claimed, which ends before this call returns
+    Work *body = &work;
+    auto drain = [batch, body, count]() {
+      size_t completed = 0;
+      for (size_t i = batch->next++; i < count; i = batch->next++, ++completed)
+        (*body)(i);
+      if (completed > 0 && batch->finished.fetch_add(completed) + completed == count) {
+        std::lock_guard<std::mutex> lock(batch->mutex);
+        batch->done.notify_all();
+      }
+    };
+
+    size_t helpers = std::min<size_t>(workers.size(), count - 1);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (size_t i = 0; i < helpers; ++i)
+        queue.push_back(drain);
+    }
+    available.notify_all();
+    drain();
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->done.wait(lock, [&]() { return batch->finished.load() == count; });
+  }
+
+private:
+  vector<std::thread> workers;
+  std::deque<std::function<void()>> queue;
+  std::mutex mutex;
+  std::condition_variable available;
+  bool stopping = false;
+
+  ImageLoader() {
+    unsigned int count = std::thread::hardware_concurrency();
+    if (count == 0)
+      count = 2;
+    for (unsigned int i = 0; i < count; ++i)
+      workers.emplace_back([this]() { work(); });
+  }
+
+  ~ImageLoader() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    available.notify_all();
+    for (std::thread &worker : workers)
+      worker.join();
+  }
+
+  static std::atomic<bool> &flipByDefault() {
+    static std::atomic<bool> flip(false);
+    return flip;
+  }
+
+  void work() {
+    while (true) {
+      std::function<void()> job;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        available.wait(lock, [this]() { return stopping || !queue.empty(); });
+        if (stopping && queue.empty())
+          return;
+        job = std::move(queue.front());
+        queue.pop_front();
+      }
+      job();
+    }
+  }
+
+  static Image decode(const ImageRequest &request) {
+    Image image;
+    image.path = request.path;
+    image.hdr = request.hdr;
+
+    stbi_set_flip_vertically_on_load_thread(request.flip);
+    if (request.hdr)
+      image.pixels = stbi_loadf(request.path.c_str(), &image.width, &image.height, &image.channels, request.desiredChannels);
+    else
+      image.pixels = stbi_load(request.path.c_str(), &image.width, &image.height, &image.channels, request.desiredChannels);
+
+    if (image.pixels && request.desiredChannels != 0)
+      image.channels = request.desiredChannels;
+    return image;
+  }
+};
+
+#endif
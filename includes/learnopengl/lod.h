@@ -0,0 +1,159 @@
+#ifndef LOD_H
+#define LOD_H
+
+#include "learnopengl/model.h"
+#include "learnopengl/gl_state.h"
+#include <vector>
+#include <algorithm>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+using std::vector;
+
+/*
+* Picks a Model LOD from its projected screen space error
+*
+* Each level stores how far (in object space) it strays from the full mesh. Scaled by the instance
+* transform and projected at the instance's distance that becomes an error in pixels, and the
+* coarsest level that stays under pixelThreshold wins.
+*/
+class LodSelector {
+public:
+  float pixelThreshold;
+
+  LodSelector(const Model &model, float pixelThreshold = 1.0f) : pixelThreshold(pixelThreshold) {
+    vec3 boundsMin, boundsMax;
+    model.getBounds(boundsMin, boundsMax);
+    center = (boundsMin + boundsMax) * 0.5f;
+    radius = glm::length(boundsMax - boundsMin) * 0.5f;
+    for (unsigned int i = 0; i < model.lodCount(); ++i)
+      errors.push_back(model.lodError(i));
+  }
+
+  // Pixels covered by one unit at distance one, for the y scale of a perspective projection
+  static float projectionScale(const glm::mat4 &projection, float viewportHeight) {
+    return projection[1][1] * viewportHeight * 0.5f;
+  }
+
+  unsigned int select(const glm::mat4 &model, vec3 cameraPos, float projectionScale) const {
+    float scale = std::max(glm::length(vec3(model[0])), std::max(glm::length(vec3(model[1])), glm::length(vec3(model[2]))));
+    vec3 worldCenter = vec3(model * glm::vec4(center, 1.0f));
+    float distance = glm::length(worldCenter - cameraPos) - radius * scale;
+    if (distance <= 0.0f)
+      return 0;
+
+    float pixelsPerUnit = scale * projectionScale / distance;
+    unsigned int level = 0;
+    while (level + 1 < errors.size() && errors[level + 1] * pixelsPerUnit <= pixelThreshold)
+      level++;
+    return level;
+  }
+
+  unsigned int lodCount() const {
+    return (unsigned int)errors.size();
+  }
+
+private:
+  vec3 center;
+  float radius;
+  vector<float> errors;
+};
+
+/*
+* Draws many instances of a Model with one instanced draw per mesh and LOD
+*
+* update() buckets the instance matrices by LOD into a single buffer, one contiguous run per
+* level. GL 3.3 has no base instance, so draw() re-points the mat4 attributes (locations 3-6)
+* at each run before issuing its glDrawElementsInstanced.
+*/
+class LodInstancer {
+public:
+  LodInstancer(Model &model, vector<glm::mat4> instances, float pixelThreshold = 1.0f)
+    : model(model), selector(model, pixelThreshold), instances(std::move(instances)) {
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, this->instances.size() * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+
+    GLState &state = GLState::instance();
+    for (Mesh &mesh : model.meshes) {
+      state.bindVertexArray(mesh.VAO);
+      for (unsigned int i = 0; i < 4; ++i) {
+        glEnableVertexAttribArray(3 + i);
+        glVertexAttribDivisor(3 + i, 1);
+      }
+    }
+    state.bindVertexArray(0);
+  }
+
+  LodInstancer(const LodInstancer&) = delete;
+  LodInstancer &operator=(const LodInstancer&) = delete;
+
+  ~LodInstancer() {
+    if (glfwGetCurrentContext())
+      glDeleteBuffers(1, &buffer);
+  }
+
+  // Rebuckets every instance for this frame's camera
+  void update(vec3 cameraPos, const glm::mat4 &projection, float viewportHeight) {
+    float projectionScale = LodSelector::projectionScale(projection, viewportHeight);
+    unsigned int levels = selector.lodCount();
+
+    // 1. Select and count per level
+    levelOf.resize(instances.size());
+    counts.assign(levels, 0);
+    for (size_t i = 0; i < instances.size(); ++i) {
+      levelOf[i] = selector.select(instances[i], cameraPos, projectionScale);
+      counts[levelOf[i]]++;
+    }
+
+    // 2. Counting sort the matrices into one run per level
+    firsts.assign(levels, 0);
+    for (unsigned int level = 1; level < levels; ++level)
+      firsts[level] = firsts[level - 1] + counts[level - 1];
+    sorted.resize(instances.size());
+    cursor = firsts; // keeps its capacity, so steady frames do not allocate
+    for (size_t i = 0; i < instances.size(); ++i)
+      sorted[cursor[levelOf[i]]++] = instances[i];
+
+    // 3. Orphan and refill the instance buffer
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, sorted.size() * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sorted.size() * sizeof(glm::mat4), sorted.data());
+  }
+
+  void draw(Shader &shader) {
+    GLState &state = GLState::instance();
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    for (Mesh &mesh : model.meshes) {
+      mesh.setMaterial(shader);
+      state.bindVertexArray(mesh.VAO);
+      for (unsigned int level = 0; level < counts.size(); ++level) {
+        if (counts[level] == 0)
+          continue;
+        size_t offset = firsts[level] * sizeof(glm::mat4);
+        for (unsigned int i = 0; i < 4; ++i)
+          glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(offset + i * sizeof(glm::vec4)));
+        glDrawElementsInstanced(GL_TRIANGLES, mesh.lod(level).indexCount, mesh.indexType, mesh.lodOffset(level), counts[level]);
+      }
+    }
+    state.releaseVertexArray();
+  }
+
+  // Instances drawn at each level by the last update()
+  const vector<unsigned int> &levelCounts() const {
+    return counts;
+  }
+
+private:
+  Model &model;
+  LodSelector selector;
+  vector<glm::mat4> instances;
+  vector<glm::mat4> sorted;
+  vector<unsigned int> levelOf;
+  vector<unsigned int> counts;
+  vector<unsigned int> firsts;
+  vector<unsigned int> cursor;
+  unsigned int buffer = 0;
+};
+
+#endif
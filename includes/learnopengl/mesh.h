@@ -2,8 +2,14 @@
 #define MESH_H
 
 #include "learnopengl/shader.h"
+#include "learnopengl/vertex_format.h"
+#include "learnopengl/asset_streamer.h"
+#include "learnopengl/texture_cache.h"
+#include "learnopengl/gl_state.h"
 #include <vector>
 #include <string>
+#include <utility>
+#include <algorithm>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <GLFW/glfw3.h>
@@ -13,91 +19,323 @@ using std::string;
 using glm::vec3;
 using glm::vec2;
 
-struct Vertex {
-  vec3 Position;
-  vec3 Normal;
-  vec2 TexCoords;
-};
-
 struct Texture {
   unsigned int id;
   string type;
   string path;
 };
 
+// What a Mesh keeps in RAM once its geometry lives in the VBO / EBO
+enum class GeometryRetention {
+  Keep,          // full vertex and index arrays (default)
+  PositionsOnly, // just the vertex positions, e.g. for picking or culling
+  Release,       // nothing, the GPU copy is the only one
+};
+
+// One level of detail: a range in the mesh's index buffer plus how far it strays from LOD 0
+struct MeshLod {
+  unsigned int indexOffset;
+  unsigned int indexCount;
+  float error; // object space distance
+};
+
+// A small run of LOD 0 triangles with the bounds needed to cull it on the CPU
+struct MeshCluster {
+  unsigned int indexOffset;
+  unsigned int indexCount;
+  vec3 center;      // bounding sphere
+  float radius;
+  vec3 coneApex;    // normal cone: back facing when dot(normalize(coneApex - eye), coneAxis) >= coneCutoff
+  vec3 coneAxis;
+  float coneCutoff; // > 1 when the triangles face too many ways to ever be culled
+};
+
+// Meshes with at most this many vertices are drawn with GL_UNSIGNED_SHORT indices
+const unsigned int SHORT_INDEX_LIMIT = 65536;
+
 class Mesh {
 public:
   vector<Vertex> vertices;
   vector<unsigned int> indices;
   vector<Texture> textures;
+  vector<TextureLayer> textureLayers; // parallel to textures once they are packed into arrays, empty otherwise
+  vector<vec3> positions; // only filled with GeometryRetention::PositionsOnly
+  vector<MeshLod> lods;   // lods[0] is the full mesh, coarser levels follow it in the same EBO
+  vector<MeshCluster> clusters; // partition of lods[0], empty unless the Model asked for clusters
 
-  Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures) {
-    this->vertices = vertices;
-    this->indices = indices;
-    this->textures = textures;
+  unsigned int vertexCount = 0;
+  unsigned int indexCount = 0; // every LOD together
+  VertexFormat format = VertexFormat::Float;
+  GLenum indexType = GL_UNSIGNED_INT; // GL_UNSIGNED_SHORT whenever every index fits
+  vec3 boundsMin = vec3(0.0f), boundsMax = vec3(0.0f);
+
+  Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures,
+       VertexFormat format = VertexFormat::Float, vector<MeshLod> lods = {}) {
+    this->vertices = std::move(vertices);
+    this->indices = std::move(indices);
+    this->textures = std::move(textures);
+    this->format = format;
+    vertexCount = (unsigned int)this->vertices.size();
+    indexCount = (unsigned int)this->indices.size();
+    setLods(std::move(lods));
 
     setupMesh();
   }
 
-  unsigned int VAO, VBO, EBO;
+  // Build a mesh straight from pre-packed vertex / index blobs (e.g. a mapped mesh cache)
+  Mesh(const Vertex *vertexData, unsigned int vertexCount, const unsigned int *indexData, unsigned int indexCount,
+       vector<Texture> textures, GeometryRetention retention = GeometryRetention::Keep,
+       VertexFormat format = VertexFormat::Float, vector<MeshLod> lods = {}) {
+    this->textures = std::move(textures);
+    this->format = format;
+    this->vertexCount = vertexCount;
+    this->indexCount = indexCount;
+    setLods(std::move(lods));
+    if (retention == GeometryRetention::Keep) {
+      this->vertices.assign(vertexData, vertexData + vertexCount);
+      this->indices.assign(indexData, indexData + indexCount);
+    } else if (retention == GeometryRetention::PositionsOnly) {
+      keepPositions(vertexData, vertexCount);
+    }
+
+    setupMesh(vertexData, indexData);
+  }
+
+  // GPU objects have a single owner, so meshes can only be moved
+  Mesh(const Mesh&) = delete;
+  Mesh &operator=(const Mesh&) = delete;
+
+  Mesh(Mesh &&other) noexcept {
+    *this = std::move(other);
+  }
+
+  Mesh &operator=(Mesh &&other) noexcept {
+    if (this != &other) {
+      deleteBuffers();
+      vertices = std::move(other.vertices);
+      indices = std::move(other.indices);
+      textures = std::move(other.textures);
+      textureLayers = std::move(other.textureLayers);
+      uniforms = std::move(other.uniforms);
+      positions = std::move(other.positions);
+      lods = std::move(other.lods);
+      clusters = std::move(other.clusters);
+      vertexCount = other.vertexCount;
+      indexCount = other.indexCount;
+      format = other.format;
+      indexType = other.indexType;
+      boundsMin = other.boundsMin;
+      boundsMax = other.boundsMax;
+      VAO = other.VAO;
+      VBO = other.VBO;
+      EBO = other.EBO;
+      other.VAO = other.VBO = other.EBO = 0;
+    }
+    return *this;
+  }
+
+  // Meshes that outlive glfwTerminate() leave their objects to the destroyed context
+  ~Mesh() {
+    if (glfwGetCurrentContext())
+      deleteBuffers();
+  }
+
+  unsigned int VAO = 0, VBO = 0, EBO = 0;
 
   void setupMesh() {
+    setupMesh(vertices.data(), indices.data());
+  }
+
+  // Frees the CPU side copies once the data has been uploaded
+  void releaseGeometry(GeometryRetention retention) {
+    if (retention == GeometryRetention::Keep)
+      return;
+    if (retention == GeometryRetention::PositionsOnly)
+      keepPositions(vertices.data(), (unsigned int)vertices.size());
+    vector<Vertex>().swap(vertices);
+    vector<unsigned int>().swap(indices);
+  }
+
+  size_t cpuBytes() const {
+    return vertices.capacity() * sizeof(Vertex)
+      + indices.capacity() * sizeof(unsigned int)
+      + positions.capacity() * sizeof(vec3);
+  }
+
+  size_t gpuBytes() const {
+    return (size_t)vertexCount * vertexStride(format) + (size_t)indexCount * indexSize();
+  }
+
+  size_t indexSize() const {
+    return indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+  }
+
+  void setupMesh(const Vertex *vertexData, const unsigned int *indexData) {
+    uploadBuffers(vertexData, indexData);
+
+    // VAOs belong to one context, so the upload thread leaves them to the render thread
+    if (!AssetStreamer::onUploadThread())
+      setupVertexArray();
+  }
+
+  void uploadBuffers(const Vertex *vertexData, const unsigned int *indexData) {
+    computeBounds(vertexData, vertexCount, boundsMin, boundsMax);
+
     // 1. Generate GLFW Buffers
-    glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
 
-    // 2. Populate data into the VAO and VBO
-    glBindVertexArray(VAO);
+    // 2. Populate data into the VBO, quantizing it first for the packed layout
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+    if (format == VertexFormat::Packed) {
+      vector<PackedVertex> packed = packVertices(vertexData, vertexCount, boundsMin, boundsMax);
+      glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(PackedVertex), packed.data(), GL_STATIC_DRAW);
+    } else if (format == VertexFormat::Float) {
+      vector<FloatVertex> stripped = dropTangents(vertexData, vertexCount);
+      glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(FloatVertex), stripped.data(), GL_STATIC_DRAW);
+    } else {
+      glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(Vertex), vertexData, GL_STATIC_DRAW);
+    }
+
+    // 3. Populate data into the EBO, narrowing to 16 bit indices when the mesh is small enough.
+    //    The element binding is VAO state, so fill it through the copy target instead
+    glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+    if (vertexCount <= SHORT_INDEX_LIMIT) {
+      indexType = GL_UNSIGNED_SHORT;
+      vector<uint16_t> shortIndices(indexData, indexData + indexCount);
+      glBufferData(GL_COPY_WRITE_BUFFER, indexCount * sizeof(uint16_t), shortIndices.data(), GL_STATIC_DRAW);
+    } else {
+      indexType = GL_UNSIGNED_INT;
+      glBufferData(GL_COPY_WRITE_BUFFER, indexCount * sizeof(unsigned int), indexData, GL_STATIC_DRAW);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  }
 
-    // 3. Populate data into the EBO
+  void setupVertexArray() {
+    // 4. Bind the buffers to a VAO and set the vertex positions, normals, texture coords and tangents
+    //    Through GLState, as streamed meshes get here in the middle of a frame
+    GLState &state = GLState::instance();
+    glGenVertexArrays(1, &VAO);
+    state.bindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+    setupVertexAttributes(format);
+
+    state.bindVertexArray(0);
+  }
 
-    // 4. Set the vertex positions, normals, and texture coords
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+  /*
+  * Packed meshes bind sampler2DArrays instead and set the layer next to each sampler,
+  * e.g. material.texture_diffuse1 and material.texture_diffuse1Layer
+  */
+  void setMaterial(Shader &shader) {
+    const MaterialUniforms &uniforms = materialUniforms(shader);
+    GLState &state = GLState::instance();
+    bool layered = !textureLayers.empty();
 
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
+    // inside a GLState frame, meshes sharing textures or texture arrays skip the rebinds
+    for(unsigned int i=0; i<textures.size(); ++i) {
+      shader.set(uniforms.samplers[i], (int)i);
+      shader.set(uniforms.shininess, 32.0f);
+      if (!layered) {
+        state.bindTexture(i, GL_TEXTURE_2D, textures[i].id);
+        continue;
+      }
+
+      shader.set(uniforms.layers[i], (float)textureLayers[i].layer);
+      state.bindTexture(i, GL_TEXTURE_2D_ARRAY, textureLayers[i].array);
+    }
 
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+    state.releaseTextureUnit();
 
-    glBindVertexArray(0);
+    // packed positions are stored relative to the mesh bounds
+    if (format == VertexFormat::Packed) {
+      shader.set(uniforms.positionOffset, boundsMin);
+      shader.set(uniforms.positionScale, quantizationScale(boundsMin, boundsMax));
+    }
   }
 
-  void setMaterial(Shader &shader) {
+  // What DrawQueue groups by: the texture array, or else the first texture
+  unsigned int materialKey() const {
+    if (!textureLayers.empty())
+      return textureLayers[0].array;
+    return textures.empty() ? 0u : textures[0].id;
+  }
+
+  // Clamps to the coarsest level this mesh has
+  const MeshLod &lod(unsigned int level) const {
+    return lods[std::min<size_t>(level, lods.size() - 1)];
+  }
+
+  const void *lodOffset(unsigned int level) const {
+    return (const void*)(lod(level).indexOffset * indexSize());
+  }
+
+  void draw(Shader &shader, unsigned int level = 0) {
+    setMaterial(shader);
+
+    // draw mesh
+    GLState &state = GLState::instance();
+    state.bindVertexArray(VAO);
+    glDrawElements(GL_TRIANGLES, lod(level).indexCount, indexType, lodOffset(level));
+    state.releaseVertexArray();
+  }
+
+private:
+  // Material uniforms resolved for the last program this mesh was drawn with
+  struct MaterialUniforms {
+    unsigned int program = 0;
+    vector<UniformHandle<int>> samplers;
+    vector<UniformHandle<float>> layers;
+    UniformHandle<float> shininess;
+    UniformHandle<glm::vec3> positionOffset;
+    UniformHandle<glm::vec3> positionScale;
+  } uniforms;
+
+  // e.g. material.texture_diffuse1 and material.texture_diffuse1Layer, only rebuilt when the program changes
+  const MaterialUniforms &materialUniforms(const Shader &shader) {
+    if (uniforms.program == shader.ID && uniforms.samplers.size() == textures.size())
+      return uniforms;
+
+    uniforms.program = shader.ID;
+    uniforms.samplers.clear();
+    uniforms.layers.clear();
     unsigned int diffuseNum = 1;
     unsigned int specularNum = 1;
-
-    for(unsigned int i=0; i<textures.size(); ++i) {
-      glActiveTexture(GL_TEXTURE0 + i);
+    for (const Texture &texture : textures) {
       string number;
-      string name = textures[i].type;
-      if (name == "texture_diffuse") {
+      if (texture.type == "texture_diffuse") {
         number = std::to_string(diffuseNum++);
-      } else if (name == "texture_specular") {
+      } else if (texture.type == "texture_specular") {
         number = std::to_string(specularNum++);
       }
-
-      shader.setInt(("material." + name + number).c_str(), i);
-      shader.setFloat("material.shininess", 32.0f);
-      glBindTexture(GL_TEXTURE_2D, textures[i].id);
+      string uniform = "material." + texture.type + number;
+      uniforms.samplers.push_back(shader.uniform<int>(uniform));
+      uniforms.layers.push_back(shader.uniform<float>(uniform + "Layer"));
     }
+    uniforms.shininess = shader.uniform<float>("material.shininess");
+    uniforms.positionOffset = shader.uniform<glm::vec3>("positionOffset");
+    uniforms.positionScale = shader.uniform<glm::vec3>("positionScale");
+    return uniforms;
+  }
 
-    glActiveTexture(GL_TEXTURE0);
+  void setLods(vector<MeshLod> lods) {
+    this->lods = std::move(lods);
+    if (this->lods.empty())
+      this->lods.push_back({ 0, indexCount, 0.0f });
   }
 
-  void draw(Shader &shader) {
-    setMaterial(shader);
+  void keepPositions(const Vertex *vertexData, unsigned int count) {
+    positions.resize(count);
+    for (unsigned int i = 0; i < count; ++i)
+      positions[i] = vertexData[i].Position;
+  }
 
-    // draw mesh
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+  void deleteBuffers() {
+    if (VAO) glDeleteVertexArrays(1, &VAO);
+    if (VBO) glDeleteBuffers(1, &VBO);
+    if (EBO) glDeleteBuffers(1, &EBO);
+    VAO = VBO = EBO = 0;
   }
 };
 
@@ -0,0 +1,428 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include "learnopengl/mesh.h"
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using std::vector;
+using std::string;
+
+/*
+* Binary mesh cache
+*
+* A cache file holds everything Model needs to rebuild its meshes without Assimp:
+*
+*   [MeshCacheHeader]
+*   [MeshCacheRecord    x meshCount]
+*   [MeshCacheTexture   x textureCount]
+*   [MeshLod            x lodCount]
+*   [MeshCluster        x clusterCount]
+*   [string table]      (source path, texture types and paths)
+*   [vertex / index blobs, 16 byte aligned]
+*
+* Files are keyed by the source path, its mtime and size, the Assimp import flags, the
+* MeshProcessFlags and the Vertex layout.
+* Any mismatch is treated as a miss and the model is imported (and re-cached) through Assimp.
+*/
+const uint32_t MESH_CACHE_MAGIC = 0x48534d4c; // "LMSH"
+const uint32_t MESH_CACHE_VERSION = 6; // 2: Vertex gained Tangent, 3: processFlags, 4: LODs, 5: clusters, 6: cluster cache order
+
+struct MeshCacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  int64_t sourceTime;
+  uint64_t sourceSize;
+  uint32_t importFlags;
+  uint32_t processFlags;
+  uint32_t vertexStride;
+  uint32_t meshCount;
+  uint32_t textureCount;
+  uint32_t lodCount;
+  uint32_t clusterCount;
+  uint32_t sourcePathOffset;
+  uint32_t sourcePathLength;
+  uint64_t stringsOffset;
+  uint64_t stringsSize;
+};
+
+struct MeshCacheRecord {
+  uint64_t vertexOffset;
+  uint64_t indexOffset;
+  uint32_t vertexCount;
+  uint32_t indexCount;
+  uint32_t firstTexture;
+  uint32_t textureCount;
+  uint32_t firstLod;
+  uint32_t lodCount;
+  uint32_t firstCluster;
+  uint32_t clusterCount;
+};
+
+struct MeshCacheTexture {
+  uint32_t typeOffset;
+  uint32_t typeLength;
+  uint32_t pathOffset;
+  uint32_t pathLength;
+};
+
+/*
+* Read-only view of a whole file. Uses mmap where available so the vertex and
+* index blobs can be handed straight to glBufferData.
+*/
+class MappedFile {
+public:
+  MappedFile() {}
+  MappedFile(const MappedFile&) = delete;
+  MappedFile &operator=(const MappedFile&) = delete;
+
+  ~MappedFile() {
+    close();
+  }
+
+  bool open(const string &path) {
+    close();
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+      ::close(fd);
+      return false;
+    }
+
+    void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+      return false;
+
+    bytes = static_cast<const unsigned char*>(mapped);
+    length = info.st_size;
+    return true;
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+      return false;
+    fallback.resize((size_t)file.tellg());
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(fallback.data()), fallback.size());
+    bytes = fallback.data();
+    length = fallback.size();
+    return !fallback.empty();
+#endif
+  }
+
+  void close() {
+#ifndef _WIN32
+    if (bytes)
+      munmap(const_cast<unsigned char*>(bytes), length);
+#else
+    fallback.clear();
+#endif
+    bytes = nullptr;
+    length = 0;
+  }
+
+  const unsigned char *data() const { return bytes; }
+  size_t size() const { return length; }
+
+private:
+  const unsigned char *bytes = nullptr;
+  size_t length = 0;
+#ifdef _WIN32
+  vector<unsigned char> fallback;
+#endif
+};
+
+class MeshCache {
+public:
+  // source mesh data handed back to Model on a cache hit
+  struct MeshView {
+    const Vertex *vertices;
+    unsigned int vertexCount;
+    const unsigned int *indices;
+    unsigned int indexCount;
+    vector<Texture> textures; // id is left unset; Model resolves the texture
+    vector<MeshLod> lods;
+    vector<MeshCluster> clusters;
+  };
+
+  MeshCache(const string &sourcePath, unsigned int importFlags, unsigned int processFlags = 0)
+    : sourcePath(sourcePath), importFlags(importFlags), processFlags(processFlags) {
+    cachePath = string(CACHE_DIR) + "/meshes/" + hashName(sourcePath) + ".meshcache";
+  }
+
+  /*
+  * Maps the cache file and validates it against the current source file.
+  * Returns false on any mismatch so the caller can fall back to Assimp.
+  */
+  bool load(vector<MeshView> &meshes) {
+    int64_t sourceTime;
+    uint64_t sourceSize;
+    if (!sourceStats(sourceTime, sourceSize))
+      return false;
+    if (!file.open(cachePath))
+      return false;
+
+    // 1. Validate the header against the source file and import settings
+    if (file.size() < sizeof(MeshCacheHeader))
+      return false;
+    MeshCacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.magic != MESH_CACHE_MAGIC || header.version != MESH_CACHE_VERSION)
+      return false;
+    if (header.sourceTime != sourceTime || header.sourceSize != sourceSize)
+      return false;
+    if (header.importFlags != importFlags || header.processFlags != processFlags || header.vertexStride != sizeof(Vertex))
+      return false;
+
+    size_t recordsEnd = sizeof(MeshCacheHeader)
+      + header.meshCount * sizeof(MeshCacheRecord)
+      + header.textureCount * sizeof(MeshCacheTexture)
+      + header.lodCount * sizeof(MeshLod)
+      + header.clusterCount * sizeof(MeshCluster);
+    if (recordsEnd > file.size() || !inRange(header.stringsOffset, header.stringsSize, file.size()))
+      return false;
+
+    const char *strings = reinterpret_cast<const char*>(file.data() + header.stringsOffset);
+    if (!inRange(header.sourcePathOffset, header.sourcePathLength, header.stringsSize))
+      return false;
+    if (string(strings + header.sourcePathOffset, header.sourcePathLength) != sourcePath)
+      return false;
+
+    // 2. Point each mesh directly into the mapped blobs
+    const MeshCacheRecord *records = reinterpret_cast<const MeshCacheRecord*>(file.data() + sizeof(MeshCacheHeader));
+    const MeshCacheTexture *textures = reinterpret_cast<const MeshCacheTexture*>(records + header.meshCount);
+    const MeshLod *lods = reinterpret_cast<const MeshLod*>(textures + header.textureCount);
+    const MeshCluster *clusters = reinterpret_cast<const MeshCluster*>(lods + header.lodCount);
+
+    meshes.clear();
+    meshes.reserve(header.meshCount);
+    for (unsigned int i = 0; i < header.meshCount; ++i) {
+      const MeshCacheRecord &record = records[i];
+      if (!inRange(record.vertexOffset, (uint64_t)record.vertexCount * sizeof(Vertex), file.size()) ||
+          !inRange(record.indexOffset, (uint64_t)record.indexCount * sizeof(unsigned int), file.size()) ||
+          !inRange(record.firstTexture, record.textureCount, header.textureCount) ||
+          !inRange(record.firstLod, record.lodCount, header.lodCount) ||
+          !inRange(record.firstCluster, record.clusterCount, header.clusterCount)) {
+        meshes.clear();
+        return false;
+      }
+
+      MeshView view;
+      view.vertices = reinterpret_cast<const Vertex*>(file.data() + record.vertexOffset);
+      view.vertexCount = record.vertexCount;
+      view.indices = reinterpret_cast<const unsigned int*>(file.data() + record.indexOffset);
+      view.indexCount = record.indexCount;
+
+      // a stale or corrupt cache must not hand glDrawElements an index past the vertices
+      unsigned int maxIndex = 0;
+      for (unsigned int j = 0; j < record.indexCount; ++j)
+        maxIndex = std::max(maxIndex, view.indices[j]);
+      if (record.indexCount > 0 && maxIndex >= record.vertexCount) {
+        meshes.clear();
+        return false;
+      }
+      for (unsigned int j = 0; j < record.textureCount; ++j) {
+        const MeshCacheTexture &reference = textures[record.firstTexture + j];
+        if (!inRange(reference.typeOffset, reference.typeLength, header.stringsSize) ||
+            !inRange(reference.pathOffset, reference.pathLength, header.stringsSize)) {
+          meshes.clear();
+          return false;
+        }
+        Texture texture;
+        texture.id = 0;
+        texture.type = string(strings + reference.typeOffset, reference.typeLength);
+        texture.path = string(strings + reference.pathOffset, reference.pathLength);
+        view.textures.push_back(texture);
+      }
+      for (unsigned int j = 0; j < record.lodCount; ++j) {
+        const MeshLod &lod = lods[record.firstLod + j];
+        if (!inRange(lod.indexOffset, lod.indexCount, record.indexCount)) {
+          meshes.clear();
+          return false;
+        }
+      }
+      view.lods.assign(lods + record.firstLod, lods + record.firstLod + record.lodCount);
+      for (unsigned int j = 0; j < record.clusterCount; ++j) {
+        const MeshCluster &cluster = clusters[record.firstCluster + j];
+        if (!inRange(cluster.indexOffset, cluster.indexCount, record.indexCount)) {
+          meshes.clear();
+          return false;
+        }
+      }
+      view.clusters.assign(clusters + record.firstCluster, clusters + record.firstCluster + record.clusterCount);
+      meshes.push_back(view);
+    }
+    return true;
+  }
+
+  /*
+  * Writes the imported meshes out so the next launch can skip Assimp entirely
+  */
+  bool save(const vector<Mesh> &meshes) {
+    int64_t sourceTime;
+    uint64_t sourceSize;
+    if (!sourceStats(sourceTime, sourceSize))
+      return false;
+
+    // 1. Build the string table and the per-mesh records
+    string strings;
+    auto addString = [&strings](const string &value, uint32_t &offset, uint32_t &length) {
+      offset = (uint32_t)strings.size();
+      length = (uint32_t)value.size();
+      strings += value;
+    };
+
+    MeshCacheHeader header = {};
+    header.magic = MESH_CACHE_MAGIC;
+    header.version = MESH_CACHE_VERSION;
+    header.sourceTime = sourceTime;
+    header.sourceSize = sourceSize;
+    header.importFlags = importFlags;
+    header.processFlags = processFlags;
+    header.vertexStride = sizeof(Vertex);
+    header.meshCount = (uint32_t)meshes.size();
+    addString(sourcePath, header.sourcePathOffset, header.sourcePathLength);
+
+    vector<MeshCacheRecord> records(meshes.size());
+    vector<MeshCacheTexture> textures;
+    vector<MeshLod> lods;
+    vector<MeshCluster> clusters;
+    for (unsigned int i = 0; i < meshes.size(); ++i) {
+      records[i].vertexCount = (uint32_t)meshes[i].vertices.size();
+      records[i].indexCount = (uint32_t)meshes[i].indices.size();
+      records[i].firstTexture = (uint32_t)textures.size();
+      records[i].textureCount = (uint32_t)meshes[i].textures.size();
+      records[i].firstLod = (uint32_t)lods.size();
+      records[i].lodCount = (uint32_t)meshes[i].lods.size();
+      lods.insert(lods.end(), meshes[i].lods.begin(), meshes[i].lods.end());
+      records[i].firstCluster = (uint32_t)clusters.size();
+      records[i].clusterCount = (uint32_t)meshes[i].clusters.size();
+      clusters.insert(clusters.end(), meshes[i].clusters.begin(), meshes[i].clusters.end());
+      for (const Texture &texture : meshes[i].textures) {
+        MeshCacheTexture reference;
+        addString(texture.type, reference.typeOffset, reference.typeLength);
+        addString(texture.path, reference.pathOffset, reference.pathLength);
+        textures.push_back(reference);
+      }
+    }
+    header.textureCount = (uint32_t)textures.size();
+    header.lodCount = (uint32_t)lods.size();
+    header.clusterCount = (uint32_t)clusters.size();
+
+    // 2. Lay out the blobs after the string table
+    uint64_t offset = sizeof(MeshCacheHeader)
+      + records.size() * sizeof(MeshCacheRecord)
+      + textures.size() * sizeof(MeshCacheTexture)
+      + lods.size() * sizeof(MeshLod)
+      + clusters.size() * sizeof(MeshCluster);
+    header.stringsOffset = offset;
+    header.stringsSize = strings.size();
+    offset += strings.size();
+    for (unsigned int i = 0; i < meshes.size(); ++i) {
+      offset = align(offset);
+      records[i].vertexOffset = offset;
+      offset += (uint64_t)records[i].vertexCount * sizeof(Vertex);
+      offset = align(offset);
+      records[i].indexOffset = offset;
+      offset += (uint64_t)records[i].indexCount * sizeof(unsigned int);
+    }
+
+    // 3. Write to a temporary file and rename, so a crash never leaves a half written cache
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+    string temporaryPath = cachePath + ".tmp";
+    std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      std::cout << "ERROR::MESH_CACHE::FAILED_TO_WRITE " << cachePath << std::endl;
+      return false;
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(MeshCacheRecord));
+    out.write(reinterpret_cast<const char*>(textures.data()), textures.size() * sizeof(MeshCacheTexture));
+    out.write(reinterpret_cast<const char*>(lods.data()), lods.size() * sizeof(MeshLod));
+    out.write(reinterpret_cast<const char*>(clusters.data()), clusters.size() * sizeof(MeshCluster));
+    out.write(strings.data(), strings.size());
+    for (unsigned int i = 0; i < meshes.size(); ++i) {
+      pad(out, records[i].vertexOffset);
+      out.write(reinterpret_cast<const char*>(meshes[i].vertices.data()), records[i].vertexCount * sizeof(Vertex));
+      pad(out, records[i].indexOffset);
+      out.write(reinterpret_cast<const char*>(meshes[i].indices.data()), records[i].indexCount * sizeof(unsigned int));
+    }
+    out.close();
+    if (!out) {
+      std::filesystem::remove(temporaryPath, error);
+      return false;
+    }
+
+    file.close();
+    std::filesystem::rename(temporaryPath, cachePath, error);
+    return !error;
+  }
+
+private:
+  string sourcePath;
+  string cachePath;
+  unsigned int importFlags;
+  unsigned int processFlags;
+  MappedFile file;
+
+  bool sourceStats(int64_t &time, uint64_t &size) const {
+    std::error_code error;
+    auto writeTime = std::filesystem::last_write_time(sourcePath, error);
+    if (error)
+      return false;
+    size = std::filesystem::file_size(sourcePath, error);
+    if (error)
+      return false;
+    time = (int64_t)writeTime.time_since_epoch().count();
+    return true;
+  }
+
+  // offset + length <= size, checked without letting the sum wrap
+  static bool inRange(uint64_t offset, uint64_t length, uint64_t size) {
+    return offset <= size && length <= size - offset;
+  }
+
+  static uint64_t align(uint64_t offset) {
+    return (offset + 15) & ~(uint64_t)15;
+  }
+
+  static void pad(std::ofstream &out, uint64_t offset) {
+    static const char zeros[16] = {};
+    uint64_t position = (uint64_t)out.tellp();
+    if (offset > position)
+      out.write(zeros, offset - position);
+  }
+
+  // FNV-1a over the source path gives a stable, filesystem safe cache name
+  static string hashName(const string &path) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : path) {
+      hash ^= c;
+      hash *= 1099511628211ull;
+    }
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", (unsigned long long)hash);
+    return string(name);
+  }
+};
+
+#endif
@@ -0,0 +1,871 @@
+#ifndef MESH_PROCESSING_H
+#define MESH_PROCESSING_H
+
+#include "learnopengl/mesh.h"
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <algorithm>
+#include <unordered_map>
+
+using std::vector;
+
+/*
+* Import-time mesh processing
+*
+* Everything in here runs once after Assimp, before the result is written to the mesh cache.
+* Each step has a bit in MeshProcessFlags, which is part of the cache key, so changing the
+* options a Model is loaded with never picks up a cache file built with different ones.
+*/
+enum MeshProcessFlags : unsigned int {
+  MESH_PROCESS_SPLIT_SHORT_INDICES = 1 << 0,
+  MESH_PROCESS_OPTIMIZE = 1 << 1,
+  MESH_PROCESS_LODS = 1 << 2, // LOD count and reduction are packed into the bits above 8
+  MESH_PROCESS_CLUSTERS = 1 << 3,
+};
+
+struct MeshChunk {
+  vector<Vertex> vertices;
+  vector<unsigned int> indices;
+};
+
+/*
+* Splits a triangle list into chunks that each reference at most maxVertices vertices.
+* Triangles keep their order and vertices shared across a chunk border are duplicated.
+*/
+inline vector<MeshChunk> splitForShortIndices(const vector<Vertex> &vertices, const vector<unsigned int> &indices,
+                                              unsigned int maxVertices = SHORT_INDEX_LIMIT) {
+  vector<MeshChunk> chunks;
+  const unsigned int unmapped = 0xffffffffu;
+  vector<unsigned int> remap(vertices.size(), unmapped);
+  vector<unsigned int> touched;
+
+  MeshChunk chunk;
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    // 1. Count the vertices this triangle would add to the current chunk
+    unsigned int added = 0;
+    for (unsigned int j = 0; j < 3; ++j) {
+      unsigned int index = indices[i + j];
+      bool repeated = (j > 0 && indices[i] == index) || (j > 1 && indices[i + 1] == index);
+      if (remap[index] == unmapped && !repeated)
+        added++;
+    }
+
+    // 2. Start a new chunk when it would overflow
+    if (chunk.vertices.size() + added > maxVertices) {
+      chunks.push_back(std::move(chunk));
+      chunk = MeshChunk();
+      for (unsigned int index : touched)
+        remap[index] = unmapped;
+      touched.clear();
+    }
+
+    // 3. Append the triangle, remapping its vertices into the chunk
+    for (unsigned int j = 0; j < 3; ++j) {
+      unsigned int index = indices[i + j];
+      if (remap[index] == unmapped) {
+        remap[index] = (unsigned int)chunk.vertices.size();
+        chunk.vertices.push_back(vertices[index]);
+        touched.push_back(index);
+      }
+      chunk.indices.push_back(remap[index]);
+    }
+  }
+  if (!chunk.indices.empty())
+    chunks.push_back(std::move(chunk));
+  return chunks;
+}
+
+/*
+* Post-transform vertex cache statistics, simulated with a FIFO cache of cacheSize entries.
+* ACMR is misses per triangle (0.5 is the ideal for a regular grid, 3 is the worst case),
+* ATVR is misses per referenced vertex (1 is ideal).
+*/
+struct VertexCacheStats {
+  size_t triangles = 0;
+  size_t vertices = 0;
+  size_t misses = 0;
+
+  float acmr() const { return triangles ? (float)misses / triangles : 0.0f; }
+  float atvr() const { return vertices ? (float)misses / vertices : 0.0f; }
+
+  VertexCacheStats &operator+=(const VertexCacheStats &other) {
+    triangles += other.triangles;
+    vertices += other.vertices;
+    misses += other.misses;
+    return *this;
+  }
+};
+
+inline VertexCacheStats analyzeVertexCache(const vector<unsigned int> &indices, size_t vertexCount, unsigned int cacheSize = 16) {
+  VertexCacheStats stats;
+  stats.triangles = indices.size() / 3;
+
+  // a vertex is cached while fewer than cacheSize misses happened since it was loaded
+  vector<size_t> loadedAt(vertexCount, 0);
+  vector<bool> referenced(vertexCount, false);
+  for (unsigned int index : indices) {
+    if (!referenced[index]) {
+      referenced[index] = true;
+      stats.vertices++;
+    }
+    if (loadedAt[index] == 0 || stats.misses + 1 - loadedAt[index] > cacheSize) {
+      stats.misses++;
+      loadedAt[index] = stats.misses;
+    }
+  }
+  return stats;
+}
+
+/*
+* Merges bit-identical vertices. OBJ files come out of Assimp with one vertex per face corner,
+* so this is usually the biggest win of the whole stage.
+*/
+inline void weldVertices(vector<Vertex> &vertices, vector<unsigned int> &indices) {
+  struct VertexHash {
+    size_t operator()(const Vertex &vertex) const {
+      const unsigned char *bytes = reinterpret_cast<const unsigned char*>(&vertex);
+      uint64_t hash = 14695981039346656037ull;
+      for (size_t i = 0; i < sizeof(Vertex); ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+      }
+      return (size_t)hash;
+    }
+  };
+  struct VertexEqual {
+    bool operator()(const Vertex &a, const Vertex &b) const {
+      return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+    }
+  };
+
+  std::unordered_map<Vertex, unsigned int, VertexHash, VertexEqual> unique;
+  unique.reserve(vertices.size());
+  vector<unsigned int> remap(vertices.size());
+  vector<Vertex> welded;
+  welded.reserve(vertices.size());
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    auto inserted = unique.emplace(vertices[i], (unsigned int)welded.size());
+    if (inserted.second)
+      welded.push_back(vertices[i]);
+    remap[i] = inserted.first->second;
+  }
+
+  for (unsigned int &index : indices)
+    index = remap[index];
+  vertices = std::move(welded);
+}
+
+/*
+* Reorders triangles for the post-transform vertex cache (Tom Forsyth, "Linear-Speed Vertex
+* Cache Optimisation"). Vertices score higher the more recently they were used and the fewer
+* triangles still need them, and the best scoring triangle next to the cache is emitted next.
+*/
+inline void optimizeVertexCache(vector<unsigned int> &indices, size_t vertexCount) {
+  const int cacheSize = 32;
+  const size_t triangleCount = indices.size() / 3;
+  if (triangleCount == 0)
+    return;
+
+  auto vertexScore = [cacheSize](int cachePosition, unsigned int remaining) {
+    if (remaining == 0)
+      return -1.0f;
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+      // the last triangle's vertices get a fixed score so the next one doesn't simply reuse them
+      if (cachePosition < 3)
+        score = 0.75f;
+      else
+        score = std::pow(1.0f - (float)(cachePosition - 3) / (cacheSize - 3), 1.5f);
+    }
+    return score + 2.0f / std::sqrt((float)remaining);
+  };
+
+  // 1. Vertex -> triangle adjacency
+  vector<unsigned int> remaining(vertexCount, 0);
+  for (unsigned int index : indices)
+    remaining[index]++;
+  vector<unsigned int> offsets(vertexCount + 1, 0);
+  for (size_t i = 0; i < vertexCount; ++i)
+    offsets[i + 1] = offsets[i] + remaining[i];
+  vector<unsigned int> adjacency(indices.size());
+  vector<unsigned int> filled(offsets.begin(), offsets.end() - 1);
+  for (size_t t = 0; t < triangleCount; ++t)
+    for (unsigned int j = 0; j < 3; ++j)
+      adjacency[filled[indices[t * 3 + j]]++] = (unsigned int)t;
+
+  // 2. Initial scores
+  vector<int> cachePosition(vertexCount, -1);
+  vector<float> scores(vertexCount);
+  for (size_t i = 0; i < vertexCount; ++i)
+    scores[i] = vertexScore(-1, remaining[i]);
+  vector<float> triangleScores(triangleCount);
+  vector<bool> emitted(triangleCount, false);
+  for (size_t t = 0; t < triangleCount; ++t)
+    triangleScores[t] = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] + scores[indices[t * 3 + 2]];
+
+  // 3. Emit triangles greedily
+  vector<unsigned int> result;
+  result.reserve(indices.size());
+  vector<unsigned int> cache;
+  vector<unsigned int> nextCache;
+  size_t best = std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin();
+  size_t cursor = 0;
+  while (result.size() < indices.size()) {
+    emitted[best] = true;
+    const unsigned int *triangle = &indices[best * 3];
+    result.insert(result.end(), triangle, triangle + 3);
+
+    // drop the triangle from its vertices' adjacency lists
+    for (unsigned int j = 0; j < 3; ++j) {
+      unsigned int vertex = triangle[j];
+      unsigned int *begin = &adjacency[offsets[vertex]];
+      unsigned int *end = begin + remaining[vertex];
+      unsigned int *found = std::find(begin, end, (unsigned int)best);
+      if (found != end) {
+        *found = *(end - 1);
+        remaining[vertex]--;
+      }
+    }
+
+    // move the triangle's vertices to the front of the cache
+    nextCache.clear();
+    for (unsigned int j = 0; j < 3; ++j)
+      if (std::find(nextCache.begin(), nextCache.end(), triangle[j]) == nextCache.end())
+        nextCache.push_back(triangle[j]);
+    size_t front = nextCache.size();
+    for (unsigned int vertex : cache)
+      if (std::find(nextCache.begin(), nextCache.begin() + front, vertex) == nextCache.begin() + front)
+        nextCache.push_back(vertex);
+
+    // rescore everything that entered, moved in or fell out of the cache
+    for (size_t i = 0; i < nextCache.size(); ++i) {
+      unsigned int vertex = nextCache[i];
+      cachePosition[vertex] = i < (size_t)cacheSize ? (int)i : -1;
+      scores[vertex] = vertexScore(cachePosition[vertex], remaining[vertex]);
+    }
+    if (nextCache.size() > (size_t)cacheSize)
+      nextCache.resize(cacheSize);
+
+    float bestScore = -1.0f;
+    best = triangleCount;
+    for (unsigned int vertex : nextCache) {
+      for (unsigned int k = 0; k < remaining[vertex]; ++k) {
+        unsigned int t = adjacency[offsets[vertex] + k];
+        float score = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] + scores[indices[t * 3 + 2]];
+        triangleScores[t] = score;
+        if (score > bestScore) {
+          bestScore = score;
+          best = t;
+        }
+      }
+    }
+    cache.swap(nextCache);
+
+    // nothing left next to the cache, continue with the next triangle in input order
+    if (best == triangleCount) {
+      while (cursor < triangleCount && emitted[cursor])
+        cursor++;
+      best = cursor;
+      if (best == triangleCount)
+        break;
+    }
+  }
+  indices = std::move(result);
+}
+
+/*
+* Reorders clusters of triangles so the outward facing ones are drawn first and occlude the rest
+* (Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw").
+* Clusters end where the vertex cache restarts anyway, or earlier when the ACMR stays within
+* threshold of the cluster's, so the cache order from optimizeVertexCache is mostly preserved.
+*/
+inline void optimizeOverdraw(vector<unsigned int> &indices, const vector<Vertex> &vertices, float threshold = 1.05f) {
+  const size_t triangleCount = indices.size() / 3;
+  if (triangleCount == 0)
+    return;
+  const unsigned int cacheSize = 16;
+
+  // FIFO cache simulation; reset() evicts everything by moving time past the cache size
+  vector<size_t> loadedAt(vertices.size(), 0);
+  size_t time = cacheSize + 1;
+  auto reset = [&time, cacheSize]() { time += cacheSize + 1; };
+  auto triangleMisses = [&](size_t t) {
+    unsigned int count = 0;
+    for (unsigned int j = 0; j < 3; ++j) {
+      unsigned int vertex = indices[t * 3 + j];
+      if (time + 1 - loadedAt[vertex] > cacheSize) {
+        loadedAt[vertex] = ++time;
+        count++;
+      }
+    }
+    return count;
+  };
+
+  // 1. Hard boundaries wherever a triangle misses with all three vertices
+  vector<unsigned int> misses(triangleCount);
+  vector<size_t> hard;
+  for (size_t t = 0; t < triangleCount; ++t) {
+    misses[t] = triangleMisses(t);
+    if (t == 0 || misses[t] == 3)
+      hard.push_back(t);
+  }
+  hard.push_back(triangleCount);
+
+  // 2. Soft boundaries inside each hard cluster, as soon as its ACMR is back within threshold
+  vector<size_t> clusters;
+  for (size_t c = 0; c + 1 < hard.size(); ++c) {
+    size_t first = hard[c], last = hard[c + 1];
+    size_t hardMisses = 0;
+    for (size_t t = first; t < last; ++t)
+      hardMisses += misses[t];
+    float limit = threshold * (float)hardMisses / (last - first);
+
+    reset();
+    size_t start = first;
+    size_t clusterMisses = 0;
+    clusters.push_back(start);
+    for (size_t t = first; t < last; ++t) {
+      clusterMisses += triangleMisses(t);
+      if (t + 1 < last && (float)clusterMisses / (t - start + 1) <= limit) {
+        start = t + 1;
+        clusterMisses = 0;
+        clusters.push_back(start);
+        reset();
+      }
+    }
+  }
+  clusters.push_back(triangleCount);
+
+  // 3. Sort clusters by how much they face away from the mesh centroid
+  vec3 meshCentroid(0.0f);
+  for (const Vertex &vertex : vertices)
+    meshCentroid += vertex.Position;
+  meshCentroid /= (float)std::max<size_t>(vertices.size(), 1);
+
+  size_t clusterCount = clusters.size() - 1;
+  vector<float> keys(clusterCount);
+  for (size_t c = 0; c < clusterCount; ++c) {
+    vec3 centroid(0.0f), normal(0.0f);
+    float area = 0.0f;
+    for (size_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+      vec3 a = vertices[indices[t * 3]].Position;
+      vec3 b = vertices[indices[t * 3 + 1]].Position;
+      vec3 d = vertices[indices[t * 3 + 2]].Position;
+      vec3 n = glm::cross(b - a, d - a);
+      float triangleArea = glm::length(n);
+      centroid += (a + b + d) * (triangleArea / 3.0f);
+      normal += n;
+      area += triangleArea;
+    }
+    centroid = area > 0.0f ? centroid / area : vertices[indices[clusters[c] * 3]].Position;
+    float length = glm::length(normal);
+    keys[c] = length > 0.0f ? glm::dot(centroid - meshCentroid, normal / length) : 0.0f;
+  }
+
+  vector<size_t> order(clusterCount);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&keys](size_t a, size_t b) { return keys[a] > keys[b]; });
+
+  vector<unsigned int> result;
+  result.reserve(indices.size());
+  for (size_t c : order)
+    result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+  indices = std::move(result);
+}
+
+// Reorders vertices by first use so vertex fetch walks the VBO linearly; drops unreferenced ones
+inline void optimizeVertexFetch(vector<Vertex> &vertices, vector<unsigned int> &indices) {
+  const unsigned int unmapped = 0xffffffffu;
+  vector<unsigned int> remap(vertices.size(), unmapped);
+  vector<Vertex> ordered;
+  ordered.reserve(vertices.size());
+  for (unsigned int &index : indices) {
+    if (remap[index] == unmapped) {
+      remap[index] = (unsigned int)ordered.size();
+      ordered.push_back(vertices[index]);
+    }
+    index = remap[index];
+  }
+  vertices = std::move(ordered);
+}
+
+/*
+* Symmetric 4x4 error quadric (Garland and Heckbert). Stores the upper triangle and the total
+* weight so error() returns a weighted mean squared distance in object space units.
+*/
+struct Quadric {
+  double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+  double b0 = 0, b1 = 0, b2 = 0, c = 0;
+  double weight = 0;
+
+  static Quadric plane(vec3 normal, float distance, double weight) {
+    Quadric q;
+    double x = normal.x, y = normal.y, z = normal.z, d = distance;
+    q.a00 = weight * x * x; q.a01 = weight * x * y; q.a02 = weight * x * z;
+    q.a11 = weight * y * y; q.a12 = weight * y * z; q.a22 = weight * z * z;
+    q.b0 = weight * x * d; q.b1 = weight * y * d; q.b2 = weight * z * d;
+    q.c = weight * d * d;
+    q.weight = weight;
+    return q;
+  }
+
+  Quadric &operator+=(const Quadric &o) {
+    a00 += o.a00; a01 += o.a01; a02 += o.a02; a11 += o.a11; a12 += o.a12; a22 += o.a22;
+    b0 += o.b0; b1 += o.b1; b2 += o.b2; c += o.c;
+    weight += o.weight;
+    return *this;
+  }
+
+  double error(vec3 p) const {
+    double x = p.x, y = p.y, z = p.z;
+    double e = a00 * x * x + a11 * y * y + a22 * z * z
+      + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+      + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+    return weight > 0 ? std::max(e, 0.0) / weight : 0.0;
+  }
+};
+
+/*
+* Builds a chain of simplified index lists over the same vertices with quadric error
+* half-edge collapses. Collapses work on positions, so UV and normal seams stay closed: every
+* vertex at the collapsed position moves to the vertex at the target with the closest normal
+* and UV, and that attribute distance is added to the collapse cost. Border edges get extra
+* perpendicular quadrics and border vertices only slide along the border.
+*
+* LOD ranges are appended to indices; lods[0] always covers the original triangles.
+*/
+inline vector<MeshLod> buildLods(const vector<Vertex> &vertices, vector<unsigned int> &indices,
+                                 unsigned int lodCount, float reduction = 0.5f) {
+  vector<MeshLod> lods = { { 0, (unsigned int)indices.size(), 0.0f } };
+  if (lodCount <= 1 || indices.size() < 3 * 32)
+    return lods;
+
+  // 1. Group vertices by position
+  struct PositionHash {
+    size_t operator()(const vec3 &p) const {
+      uint32_t bits[3];
+      std::memcpy(bits, &p, sizeof(bits));
+      return (size_t)bits[0] * 73856093u ^ (size_t)bits[1] * 19349663u ^ (size_t)bits[2] * 83492791u;
+    }
+  };
+  std::unordered_map<vec3, unsigned int, PositionHash> groupByPosition;
+  vector<unsigned int> group(vertices.size());
+  vector<vec3> groupPosition;
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    auto inserted = groupByPosition.emplace(vertices[i].Position, (unsigned int)groupPosition.size());
+    if (inserted.second)
+      groupPosition.push_back(vertices[i].Position);
+    group[i] = inserted.first->second;
+  }
+  const size_t groupCount = groupPosition.size();
+  vector<unsigned int> groupOffsets(groupCount + 1, 0);
+  for (unsigned int g : group)
+    groupOffsets[g + 1]++;
+  for (size_t g = 0; g < groupCount; ++g)
+    groupOffsets[g + 1] += groupOffsets[g];
+  vector<unsigned int> groupVertices(vertices.size());
+  vector<unsigned int> groupFilled(groupOffsets.begin(), groupOffsets.end() - 1);
+  for (size_t i = 0; i < vertices.size(); ++i)
+    groupVertices[groupFilled[group[i]]++] = (unsigned int)i;
+
+  vec3 boundsMin, boundsMax;
+  computeBounds(vertices.data(), (unsigned int)vertices.size(), boundsMin, boundsMax);
+  float extent = glm::length(boundsMax - boundsMin);
+  const double attributeWeight = (double)extent * extent * 1e-4;
+
+  auto edgeKey = [](unsigned int a, unsigned int b) {
+    return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+  };
+  auto triangleNormal = [](vec3 a, vec3 b, vec3 c) {
+    return glm::cross(b - a, c - a);
+  };
+
+  // 2. Plane quadrics of every triangle, plus perpendicular planes along the open borders
+  vector<unsigned int> triangles(indices.begin(), indices.end());
+  vector<Quadric> quadrics(groupCount);
+  std::unordered_map<uint64_t, unsigned int> edgeUse;
+  for (size_t t = 0; t + 2 < triangles.size(); t += 3) {
+    unsigned int g[3] = { group[triangles[t]], group[triangles[t + 1]], group[triangles[t + 2]] };
+    vec3 n = triangleNormal(groupPosition[g[0]], groupPosition[g[1]], groupPosition[g[2]]);
+    float area = glm::length(n);
+    if (area == 0.0f)
+      continue;
+    n /= area;
+    Quadric q = Quadric::plane(n, -glm::dot(n, groupPosition[g[0]]), area * 0.5);
+    for (unsigned int j = 0; j < 3; ++j) {
+      quadrics[g[j]] += q;
+      edgeUse[edgeKey(g[j], g[(j + 1) % 3])]++;
+    }
+  }
+  for (size_t t = 0; t + 2 < triangles.size(); t += 3) {
+    unsigned int g[3] = { group[triangles[t]], group[triangles[t + 1]], group[triangles[t + 2]] };
+    vec3 n = triangleNormal(groupPosition[g[0]], groupPosition[g[1]], groupPosition[g[2]]);
+    for (unsigned int j = 0; j < 3; ++j) {
+      unsigned int a = g[j], b = g[(j + 1) % 3];
+      if (a == b || edgeUse[edgeKey(a, b)] != 1)
+        continue;
+      vec3 edge = groupPosition[b] - groupPosition[a];
+      vec3 perpendicular = glm::cross(edge, n);
+      float length = glm::length(perpendicular);
+      if (length == 0.0f)
+        continue;
+      perpendicular /= length;
+      Quadric q = Quadric::plane(perpendicular, -glm::dot(perpendicular, groupPosition[a]), glm::dot(edge, edge) * 10.0);
+      quadrics[a] += q;
+      quadrics[b] += q;
+    }
+  }
+
+  // vertex at the target position whose normal and UV are closest to the collapsed vertex
+  auto closestVertex = [&](unsigned int vertex, unsigned int target, double &distance) {
+    unsigned int best = groupVertices[groupOffsets[target]];
+    distance = 1e30;
+    for (unsigned int k = groupOffsets[target]; k < groupOffsets[target + 1]; ++k) {
+      unsigned int candidate = groupVertices[k];
+      vec3 dn = vertices[vertex].Normal - vertices[candidate].Normal;
+      vec2 dt = vertices[vertex].TexCoords - vertices[candidate].TexCoords;
+      double d = glm::dot(dn, dn) + glm::dot(dt, dt);
+      if (d < distance) {
+        distance = d;
+        best = candidate;
+      }
+    }
+    return best;
+  };
+
+  struct Collapse {
+    unsigned int from;
+    unsigned int to;
+    double cost;
+    double error;
+  };
+
+  // 3. Collapse in passes until each LOD's triangle target is met
+  vector<unsigned int> remap(vertices.size());
+  vector<unsigned char> locked(groupCount);
+  vector<unsigned char> border(groupCount);
+  vector<unsigned int> adjacencyOffsets(groupCount + 1);
+  vector<unsigned int> adjacency;
+  vector<unsigned char> referenced(vertices.size());
+  double maxError = 0.0;
+  size_t target = indices.size();
+  for (unsigned int level = 1; level < lodCount; ++level) {
+    target = (size_t)(target / 3 * reduction) * 3;
+    size_t before = triangles.size();
+
+    while (triangles.size() > target) {
+      size_t triangleTotal = triangles.size() / 3;
+
+      // group -> triangle adjacency and border flags for the current triangles
+      std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+      for (unsigned int vertex : triangles)
+        adjacencyOffsets[group[vertex] + 1]++;
+      for (size_t g = 0; g < groupCount; ++g)
+        adjacencyOffsets[g + 1] += adjacencyOffsets[g];
+      adjacency.resize(triangles.size());
+      vector<unsigned int> filled(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+      for (size_t t = 0; t < triangleTotal; ++t)
+        for (unsigned int j = 0; j < 3; ++j)
+          adjacency[filled[group[triangles[t * 3 + j]]]++] = (unsigned int)t;
+
+      edgeUse.clear();
+      for (size_t t = 0; t < triangles.size(); t += 3)
+        for (unsigned int j = 0; j < 3; ++j)
+          edgeUse[edgeKey(group[triangles[t + j]], group[triangles[t + (j + 1) % 3]])]++;
+      std::fill(border.begin(), border.end(), 0);
+      for (auto &edge : edgeUse) {
+        if (edge.second == 1) {
+          border[edge.first >> 32] = 1;
+          border[edge.first & 0xffffffffu] = 1;
+        }
+      }
+
+      std::fill(referenced.begin(), referenced.end(), 0);
+      for (unsigned int vertex : triangles)
+        referenced[vertex] = 1;
+
+      // score every half-edge collapse
+      vector<Collapse> collapses;
+      collapses.reserve(edgeUse.size() * 2);
+      for (auto &edge : edgeUse) {
+        unsigned int ends[2] = { (unsigned int)(edge.first >> 32), (unsigned int)(edge.first & 0xffffffffu) };
+        for (unsigned int d = 0; d < 2; ++d) {
+          unsigned int from = ends[d], to = ends[1 - d];
+          if (border[from] && edge.second != 1)
+            continue;
+          double error = quadrics[from].error(groupPosition[to]);
+          double attributes = 0.0;
+          for (unsigned int k = groupOffsets[from]; k < groupOffsets[from + 1]; ++k) {
+            unsigned int vertex = groupVertices[k];
+            if (!referenced[vertex])
+              continue;
+            double distance;
+            closestVertex(vertex, to, distance);
+            attributes += distance;
+          }
+          collapses.push_back({ from, to, error + attributes * attributeWeight, error });
+        }
+      }
+      std::sort(collapses.begin(), collapses.end(), [](const Collapse &a, const Collapse &b) { return a.cost < b.cost; });
+
+      // apply the cheapest collapses that don't touch each other or flip a triangle
+      std::fill(locked.begin(), locked.end(), 0);
+      for (size_t i = 0; i < vertices.size(); ++i)
+        remap[i] = (unsigned int)i;
+      size_t remaining = triangleTotal;
+      size_t applied = 0;
+      for (const Collapse &collapse : collapses) {
+        if (remaining * 3 <= target)
+          break;
+        if (locked[collapse.from] || locked[collapse.to])
+          continue;
+
+        bool flips = false;
+        size_t removed = 0;
+        for (unsigned int k = adjacencyOffsets[collapse.from]; k < adjacencyOffsets[collapse.from + 1] && !flips; ++k) {
+          unsigned int t = adjacency[k];
+          vec3 p[3];
+          bool degenerate = false;
+          for (unsigned int j = 0; j < 3; ++j) {
+            unsigned int g = group[triangles[t * 3 + j]];
+            degenerate |= g == collapse.to;
+            p[j] = groupPosition[g];
+          }
+          if (degenerate) {
+            removed++;
+            continue;
+          }
+          vec3 before = triangleNormal(p[0], p[1], p[2]);
+          for (unsigned int j = 0; j < 3; ++j)
+            if (group[triangles[t * 3 + j]] == collapse.from)
+              p[j] = groupPosition[collapse.to];
+          flips = glm::dot(before, triangleNormal(p[0], p[1], p[2])) <= 0.0f;
+        }
+        if (flips)
+          continue;
+
+        for (unsigned int k = groupOffsets[collapse.from]; k < groupOffsets[collapse.from + 1]; ++k) {
+          unsigned int vertex = groupVertices[k];
+          double distance;
+          remap[vertex] = closestVertex(vertex, collapse.to, distance);
+        }
+        for (unsigned int k = adjacencyOffsets[collapse.from]; k < adjacencyOffsets[collapse.from + 1]; ++k) {
+          unsigned int t = adjacency[k];
+          for (unsigned int j = 0; j < 3; ++j)
+            locked[group[triangles[t * 3 + j]]] = 1;
+        }
+        locked[collapse.to] = 1;
+        quadrics[collapse.to] += quadrics[collapse.from];
+        maxError = std::max(maxError, collapse.error);
+        remaining -= removed;
+        applied++;
+      }
+      if (applied == 0)
+        break;
+
+      // rebuild the triangle list, dropping the ones that collapsed to a line
+      vector<unsigned int> next;
+      next.reserve(triangles.size());
+      for (size_t t = 0; t < triangles.size(); t += 3) {
+        unsigned int a = remap[triangles[t]], b = remap[triangles[t + 1]], c = remap[triangles[t + 2]];
+        if (group[a] == group[b] || group[b] == group[c] || group[a] == group[c])
+          continue;
+        next.push_back(a);
+        next.push_back(b);
+        next.push_back(c);
+      }
+      triangles = std::move(next);
+    }
+
+    // stop once simplification stalls instead of storing near-duplicate levels
+    if (triangles.size() * 10 > before * 9 || triangles.empty())
+      break;
+
+    vector<unsigned int> lodIndices = triangles;
+    optimizeVertexCache(lodIndices, vertices.size());
+    lods.push_back({ (unsigned int)indices.size(), (unsigned int)lodIndices.size(), (float)std::sqrt(maxError) });
+    indices.insert(indices.end(), lodIndices.begin(), lodIndices.end());
+    target = triangles.size();
+  }
+  return lods;
+}
+
+/*
+* Splits a triangle list into clusters of at most maxVertices / maxTriangles and rewrites the
+* indices so each cluster is one contiguous range. Clusters grow greedily through shared
+* vertices, preferring triangles that add the fewest new ones, so they stay compact. Growing
+* loses the order optimizeVertexCache left behind, so each cluster's range is cache ordered
+* again on its own, over the cluster's local vertex numbering.
+*/
+inline vector<MeshCluster> buildClusters(const vector<Vertex> &vertices, vector<unsigned int> &indices,
+                                         unsigned int maxVertices = 64, unsigned int maxTriangles = 124) {
+  const size_t triangleCount = indices.size() / 3;
+  vector<MeshCluster> clusters;
+  if (triangleCount == 0)
+    return clusters;
+
+  // 1. Vertex -> triangle adjacency
+  vector<unsigned int> offsets(vertices.size() + 1, 0);
+  for (unsigned int index : indices)
+    offsets[index + 1]++;
+  for (size_t i = 0; i < vertices.size(); ++i)
+    offsets[i + 1] += offsets[i];
+  vector<unsigned int> adjacency(indices.size());
+  vector<unsigned int> filled(offsets.begin(), offsets.end() - 1);
+  for (size_t t = 0; t < triangleCount; ++t)
+    for (unsigned int j = 0; j < 3; ++j)
+      adjacency[filled[indices[t * 3 + j]]++] = (unsigned int)t;
+
+  // 2. Grow clusters
+  vector<bool> used(triangleCount, false);
+  vector<int> slot(vertices.size(), -1); // vertex -> position in the current cluster
+  vector<unsigned int> clusterVertices;
+  vector<unsigned int> clusterTriangles;
+  vector<unsigned int> clusterIndices;
+  vector<unsigned int> clusterOptimized;
+  vector<unsigned int> result;
+  result.reserve(indices.size());
+  size_t seed = 0;
+
+  auto newVertices = [&](size_t t) {
+    unsigned int count = 0;
+    for (unsigned int j = 0; j < 3; ++j)
+      if (slot[indices[t * 3 + j]] < 0)
+        count++;
+    return count;
+  };
+
+  while (true) {
+    while (seed < triangleCount && used[seed])
+      seed++;
+    if (seed == triangleCount)
+      break;
+
+    clusterVertices.clear();
+    clusterTriangles.clear();
+    size_t next = seed;
+    while (next != triangleCount) {
+      used[next] = true;
+      clusterTriangles.push_back((unsigned int)next);
+      for (unsigned int j = 0; j < 3; ++j) {
+        unsigned int vertex = indices[next * 3 + j];
+        if (slot[vertex] < 0) {
+          slot[vertex] = (int)clusterVertices.size();
+          clusterVertices.push_back(vertex);
+        }
+      }
+      if (clusterTriangles.size() >= maxTriangles)
+        break;
+
+      // the neighbouring triangle that adds the fewest vertices and still fits
+      next = triangleCount;
+      unsigned int bestAdded = 4;
+      for (unsigned int vertex : clusterVertices) {
+        for (unsigned int k = offsets[vertex]; k < offsets[vertex + 1]; ++k) {
+          unsigned int t = adjacency[k];
+          if (used[t])
+            continue;
+          unsigned int added = newVertices(t);
+          if (added < bestAdded && clusterVertices.size() + added <= maxVertices) {
+            bestAdded = added;
+            next = t;
+          }
+        }
+        if (bestAdded == 0)
+          break;
+      }
+    }
+
+    // 3. Emit the cluster and its bounds
+    MeshCluster cluster;
+    cluster.indexOffset = (unsigned int)result.size();
+    cluster.indexCount = (unsigned int)clusterTriangles.size() * 3;
+    clusterIndices.clear();
+    for (unsigned int t : clusterTriangles)
+      for (unsigned int j = 0; j < 3; ++j)
+        clusterIndices.push_back((unsigned int)slot[indices[t * 3 + j]]);
+    clusterOptimized = clusterIndices;
+    optimizeVertexCache(clusterOptimized, clusterVertices.size());
+    // the grown order is already strip like on regular grids, keep it when it misses less
+    if (analyzeVertexCache(clusterOptimized, clusterVertices.size()).misses < analyzeVertexCache(clusterIndices, clusterVertices.size()).misses)
+      clusterIndices.swap(clusterOptimized);
+    for (unsigned int local : clusterIndices)
+      result.push_back(clusterVertices[local]);
+
+    vec3 boundsMin = vertices[clusterVertices[0]].Position, boundsMax = boundsMin;
+    for (unsigned int vertex : clusterVertices) {
+      boundsMin = glm::min(boundsMin, vertices[vertex].Position);
+      boundsMax = glm::max(boundsMax, vertices[vertex].Position);
+      slot[vertex] = -1;
+    }
+    cluster.center = (boundsMin + boundsMax) * 0.5f;
+    cluster.radius = 0.0f;
+    for (unsigned int vertex : clusterVertices)
+      cluster.radius = std::max(cluster.radius, glm::length(vertices[vertex].Position - cluster.center));
+
+    // normal cone (as in meshoptimizer): average normal, widest deviation and an apex behind every plane
+    vec3 axis(0.0f);
+    vector<vec3> normals;
+    for (unsigned int t : clusterTriangles) {
+      vec3 a = vertices[indices[t * 3]].Position;
+      vec3 n = glm::cross(vertices[indices[t * 3 + 1]].Position - a, vertices[indices[t * 3 + 2]].Position - a);
+      float length = glm::length(n);
+      if (length == 0.0f)
+        continue;
+      normals.push_back(n / length);
+      axis += n / length;
+    }
+    float axisLength = glm::length(axis);
+    cluster.coneAxis = axisLength > 0.0f ? axis / axisLength : vec3(0.0f, 0.0f, 1.0f);
+    cluster.coneApex = cluster.center;
+    cluster.coneCutoff = 2.0f;
+
+    float minDot = 1.0f;
+    for (const vec3 &n : normals)
+      minDot = std::min(minDot, glm::dot(n, cluster.coneAxis));
+    if (axisLength > 0.0f && minDot > 0.1f) {
+      float maxT = 0.0f;
+      size_t normal = 0;
+      for (unsigned int t : clusterTriangles) {
+        vec3 a = vertices[indices[t * 3]].Position;
+        vec3 n = glm::cross(vertices[indices[t * 3 + 1]].Position - a, vertices[indices[t * 3 + 2]].Position - a);
+        if (glm::length(n) == 0.0f)
+          continue;
+        const vec3 &unit = normals[normal++];
+        float t0 = glm::dot(cluster.center - a, unit) / glm::dot(cluster.coneAxis, unit);
+        maxT = std::max(maxT, t0);
+      }
+      cluster.coneApex = cluster.center - cluster.coneAxis * maxT;
+      cluster.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+    clusters.push_back(cluster);
+  }
+
+  indices = std::move(result);
+  return clusters;
+}
+
+struct MeshOptimizationReport {
+  size_t verticesBefore = 0;
+  size_t verticesAfter = 0;
+  VertexCacheStats before;
+  VertexCacheStats after;
+};
+
+// Full optimisation stage: weld, vertex cache order, overdraw order, fetch order
+inline void optimizeMesh(vector<Vertex> &vertices, vector<unsigned int> &indices, MeshOptimizationReport &report) {
+  report.verticesBefore += vertices.size();
+  report.before += analyzeVertexCache(indices, vertices.size());
+
+  weldVertices(vertices, indices);
+  optimizeVertexCache(indices, vertices.size());
+  optimizeOverdraw(indices, vertices);
+  optimizeVertexFetch(vertices, indices);
+
+  report.verticesAfter += vertices.size();
+  report.after += analyzeVertexCache(indices, vertices.size());
+}
+
+#endif
@@ -0,0 +1,249 @@
+#ifndef MIP_BUILDER_H
+#define MIP_BUILDER_H
+
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include "learnopengl/simd.h"
+
+using std::vector;
+
+/*
+* CPU mip chain builder for cooked textures
+*
+* Works on float RGBA so nothing is requantized between levels, and filters each level from the
+* one above with a separable filter:
+*
+*   Box     2x2 average (exact area weights for odd sizes)
+*   Kaiser  Kaiser windowed sinc over 3 texels of the smaller level, sharper without ringing much
+*
+* sRGB colour is filtered in linear light, normal maps are renormalised after every level and
+* alpha tested textures get their alpha scaled so each level keeps the coverage of level 0 at
+* the cutoff (otherwise grass and foliage thin out with distance).
+*
+* Both passes run four lanes at a time through simd.h: the horizontal pass keeps one texel
+* (RGBA) per register, the vertical pass streams whole rows as plain floats.
+*/
+enum class MipFilter {
+  Box,
+  Kaiser,
+};
+
+struct MipSettings {
+  MipFilter filter = MipFilter::Kaiser;
+  // colour is stored sRGB encoded, filter it in linear light
+  bool srgb = false;
+  // rgb holds a unit vector mapped to [0, 1]
+  bool normalMap = false;
+  // >= 0: the alpha test threshold whose coverage every level should keep
+  float alphaCutoff = -1.0f;
+};
+
+namespace mip_builder {
+  struct FloatImage {
+    unsigned int width = 0;
+    unsigned int height = 0;
+    vector<glm::vec4> texels;
+  };
+
+  // Source texels contributing to each destination texel along an axis, `count` per texel.
+  // Shorter footprints are padded with zero weights and indices are already clamped to the edge
+  struct Taps {
+    unsigned int count = 0;
+    vector<int> indices;
+    vector<float> weights;
+  };
+
+  inline float srgbToLinear(float c) {
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+  }
+
+  inline float linearToSrgb(float c) {
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+  }
+
+  inline float besselI0(float x) {
+    float sum = 1.0f, term = 1.0f;
+    for (int k = 1; k < 20; ++k) {
+      term *= (x * 0.5f / k) * (x * 0.5f / k);
+      sum += term;
+    }
+    return sum;
+  }
+
+  inline float kaiserWindowedSinc(float t, float radius) {
+    const float ALPHA = 4.0f;
+    if (std::fabs(t) >= radius)
+      return 0.0f;
+    float x = t / radius;
+    float window = besselI0(ALPHA * std::sqrt(1.0f - x * x)) / besselI0(ALPHA);
+    float sinc = t == 0.0f ? 1.0f : std::sin(glm::pi<float>() * t) / (glm::pi<float>() * t);
+    return sinc * window;
+  }
+
+  inline Taps filterTaps(unsigned int source, unsigned int destination, MipFilter filter) {
+    const float KAISER_RADIUS = 1.5f; // in destination texels
+    float scale = (float)source / destination;
+    float reach = filter == MipFilter::Box ? scale * 0.5f : KAISER_RADIUS * scale;
+
+    Taps taps;
+    for (unsigned int d = 0; d < destination; ++d) {
+      float center = (d + 0.5f) * scale;
+      int span = (int)std::ceil(center + reach) - (int)std::floor(center - reach);
+      taps.count = std::max(taps.count, (unsigned int)span);
+    }
+    taps.indices.assign((size_t)destination * taps.count, 0);
+    taps.weights.assign((size_t)destination * taps.count, 0.0f);
+
+    for (unsigned int d = 0; d < destination; ++d) {
+      float center = (d + 0.5f) * scale;
+      int first = (int)std::floor(center - reach);
+      int last = (int)std::ceil(center + reach);
+      int *indices = &taps.indices[(size_t)d * taps.count];
+      float *weights = &taps.weights[(size_t)d * taps.count];
+      float total = 0.0f;
+      for (int s = first; s < last; ++s) {
+        float weight;
+        if (filter == MipFilter::Box)
+          weight = std::max(0.0f, std::min((float)s + 1.0f, center + reach) - std::max((float)s, center - reach));
+        else
+          weight = kaiserWindowedSinc((s + 0.5f - center) / scale, KAISER_RADIUS);
+        indices[s - first] = glm::clamp(s, 0, (int)source - 1);
+        weights[s - first] = weight;
+        total += weight;
+      }
+      for (int i = 0; i < last - first; ++i)
+        weights[i] /= total;
+    }
+    return taps;
+  }
+
+  // Separable downsample to half size; edges clamp
+  inline FloatImage downsample(const FloatImage &source, MipFilter filter) {
+    FloatImage result;
+    result.width = std::max(source.width / 2, 1u);
+    result.height = std::max(source.height / 2, 1u);
+
+    // 1. Horizontal pass into a (result.width x source.height) buffer, one texel per register
+    Taps horizontal = filterTaps(source.width, result.width, filter);
+    vector<glm::vec4> rows((size_t)result.width * source.height);
+    for (unsigned int y = 0; y < source.height; ++y) {
+      const glm::vec4 *row = &source.texels[(size_t)y * source.width];
+      const int *indices = horizontal.indices.data();
+      const float *weights = horizontal.weights.data();
+      for (unsigned int x = 0; x < result.width; ++x) {
+        simd::Float4 sum = simd::zero();
+        for (unsigned int i = 0; i < horizontal.count; ++i)
+          sum = simd::madd(simd::load(&row[indices[i]].x), simd::splat(weights[i]), sum);
+        simd::store(&rows[(size_t)y * result.width + x].x, sum);
+        indices += horizontal.count;
+        weights += horizontal.count;
+      }
+    }
+
+    // 2. Vertical pass, a whole output row at a time so the inner loop streams floats in order
+    Taps vertical = filterTaps(source.height, result.height, filter);
+    result.texels.assign((size_t)result.width * result.height, glm::vec4(0.0f));
+    size_t rowFloats = (size_t)result.width * 4;
+    for (unsigned int y = 0; y < result.height; ++y) {
+      float *out = &result.texels[(size_t)y * result.width].x;
+      for (unsigned int i = 0; i < vertical.count; ++i) {
+        size_t tap = (size_t)y * vertical.count + i;
+        const float *in = &rows[(size_t)vertical.indices[tap] * result.width].x;
+        simd::Float4 weight = simd::splat(vertical.weights[tap]);
+        for (size_t x = 0; x < rowFloats; x += 4)
+          simd::store(out + x, simd::madd(simd::load(in + x), weight, simd::load(out + x)));
+      }
+    }
+    return result;
+  }
+
+  inline FloatImage decode(const uint8_t *rgba, unsigned int width, unsigned int height, const MipSettings &settings) {
+    float table[256];
+    for (unsigned int i = 0; i < 256; ++i)
+      table[i] = settings.srgb ? srgbToLinear(i / 255.0f) : i / 255.0f;
+
+    FloatImage image;
+    image.width = width;
+    image.height = height;
+    image.texels.resize((size_t)width * height);
+    for (size_t i = 0; i < image.texels.size(); ++i) {
+      const uint8_t *texel = rgba + i * 4;
+      image.texels[i] = glm::vec4(table[texel[0]], table[texel[1]], table[texel[2]], texel[3] / 255.0f);
+    }
+    return image;
+  }
+
+  inline vector<uint8_t> encode(const FloatImage &image, const MipSettings &settings) {
+    vector<uint8_t> rgba(image.texels.size() * 4);
+    for (size_t i = 0; i < image.texels.size(); ++i) {
+      glm::vec4 texel = glm::clamp(image.texels[i], 0.0f, 1.0f);
+      if (settings.srgb)
+        texel = glm::vec4(linearToSrgb(texel.r), linearToSrgb(texel.g), linearToSrgb(texel.b), texel.a);
+      for (unsigned int c = 0; c < 4; ++c)
+        rgba[i * 4 + c] = (uint8_t)std::lround(texel[c] * 255.0f);
+    }
+    return rgba;
+  }
+
+  inline void renormalize(FloatImage &image) {
+    for (glm::vec4 &texel : image.texels) {
+      glm::vec3 normal = glm::vec3(texel) * 2.0f - 1.0f;
+      float length = glm::length(normal);
+      if (length > 1e-6f)
+        texel = glm::vec4(normal / length * 0.5f + 0.5f, texel.a);
+    }
+  }
+
+  inline float alphaCoverage(const FloatImage &image, float cutoff, float scale) {
+    size_t covered = 0;
+    for (const glm::vec4 &texel : image.texels)
+      covered += texel.a * scale >= cutoff ? 1 : 0;
+    return (float)covered / image.texels.size();
+  }
+
+  // Scales alpha so the fraction of texels passing the cutoff matches `target`
+  inline void preserveCoverage(FloatImage &image, float cutoff, float target) {
+    float low = 0.0f, high = 4.0f;
+    for (unsigned int iteration = 0; iteration < 16; ++iteration) {
+      float middle = (low + high) * 0.5f;
+      if (alphaCoverage(image, cutoff, middle) < target)
+        low = middle;
+      else
+        high = middle;
+    }
+    for (glm::vec4 &texel : image.texels)
+      texel.a = std::min(texel.a * high, 1.0f);
+  }
+}
+
+// Every level of an RGBA8 image down to 1x1, level 0 (an untouched copy) first
+inline vector<vector<uint8_t>> buildMipChain(const uint8_t *rgba, unsigned int width, unsigned int height, const MipSettings &settings = {}) {
+  vector<vector<uint8_t>> levels;
+  levels.emplace_back(rgba, rgba + (size_t)width * height * 4);
+
+  mip_builder::FloatImage current = mip_builder::decode(rgba, width, height, settings);
+  bool alphaTested = settings.alphaCutoff >= 0.0f;
+  float coverage = alphaTested ? mip_builder::alphaCoverage(current, settings.alphaCutoff, 1.0f) : 0.0f;
+
+  while (current.width > 1 || current.height > 1) {
+    current = mip_builder::downsample(current, settings.filter);
+    if (settings.normalMap)
+      mip_builder::renormalize(current);
+
+    // coverage scaling only goes into the stored level, the next one still filters the real alpha
+    if (alphaTested) {
+      mip_builder::FloatImage scaled = current;
+      mip_builder::preserveCoverage(scaled, settings.alphaCutoff, coverage);
+      levels.push_back(mip_builder::encode(scaled, settings));
+    } else {
+      levels.push_back(mip_builder::encode(current, settings));
+    }
+  }
+  return levels;
+}
+
+#endif
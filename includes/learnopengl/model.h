@@ -3,7 +3,14 @@
 
 #include "learnopengl/shader.h"
 #include "learnopengl/mesh.h"
+#include "learnopengl/mesh_cache.h"
+#include "learnopengl/mesh_processing.h"
+#include "learnopengl/texture_cache.h"
+#include "learnopengl/asset_streamer.h"
+#include <atomic>
+#include <memory>
 #include <vector>
+#include <unordered_map>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <GLFW/glfw3.h>
@@ -18,55 +25,356 @@ using std::string;
 using glm::vec3;
 using glm::vec2;
 
+struct ModelOptions {
+  // what each Mesh keeps in RAM after upload
+  GeometryRetention retention = GeometryRetention::Keep;
+  // layout of the uploaded vertices; FloatTangent adds tangents, Packed needs a shader that decodes it (see vertex_format.h)
+  VertexFormat vertexFormat = VertexFormat::Float;
+  // split meshes over 65536 vertices so every chunk can be drawn with 16 bit indices
+  bool splitLargeMeshes = true;
+  // weld duplicate vertices and reorder for vertex cache, overdraw and fetch locality
+  bool optimize = true;
+  // levels of detail to build at import, 1 disables them; each level keeps lodReduction of the triangles
+  unsigned int lodCount = 1;
+  float lodReduction = 0.5f;
+  // partition meshes into small clusters with bounds so ClusterCuller can skip hidden parts
+  bool clusters = false;
+  // import and upload on the AssetStreamer thread; the Model draws nothing until ready()
+  bool async = false;
+  // pack this model's textures into texture arrays (see packTextureArrays), the shader samples sampler2DArrays
+  bool textureArrays = false;
+};
+
 class Model {
 public:
   // model data - make public to insert instanced vertex attributes
   vector<Mesh> meshes;
 
-  Model(const char *path) {
+  Model(const char *path, ModelOptions options = {}) : options(options) {
+    if (options.async && AssetStreamer::instance().running()) {
+      loadAsync(path);
+      return;
+    }
     loadModel(path);
+    if (options.textureArrays)
+      packTextureArrays({ this });
     std::cout << "Loaded " << path << std::endl;
   }
-  void draw(Shader &shader) {
+
+  /*
+  * Moves the textures of every given model into shared GL_TEXTURE_2D_ARRAYs (one per size and
+  * format), so meshes carry a layer instead of their own texture and consecutive draws can keep
+  * the same arrays bound. Every model holds a reference to all the arrays of the batch.
+  * Models still streaming in are skipped.
+  */
+  static void packTextureArrays(const vector<Model*> &models, TextureSettings settings = {}) {
+    // 1. Every distinct texture file across the batch, in first use order
+    vector<string> paths;
+    std::unordered_map<string, unsigned int> layerOf;
+    for (Model *model : models) {
+      for (Mesh &mesh : model->meshes) {
+        for (const Texture &texture : mesh.textures) {
+          string path = std::string(RESOURCES_DIR) + model->directory + "/" + texture.path;
+          if (layerOf.count(path) != 0) continue;
+          layerOf[path] = (unsigned int)paths.size();
+          paths.push_back(path);
+        }
+      }
+    }
+    if (paths.empty())
+      return;
+
+    // 2. Point the meshes at their layers and drop the per texture references
+    for (Model *model : models) {
+      if (model->meshes.empty())
+        continue;
+      vector<TextureLayer> layers = TextureCache::instance().acquireLayers(paths, settings);
+      model->releaseTextures();
+      for (const TextureLayer &layer : layers) {
+        if (std::find(model->textureArrays.begin(), model->textureArrays.end(), layer.array) == model->textureArrays.end())
+          model->textureArrays.push_back(layer.array);
+      }
+      for (Mesh &mesh : model->meshes) {
+        mesh.textureLayers.clear();
+        for (Texture &texture : mesh.textures) {
+          mesh.textureLayers.push_back(layers[layerOf[std::string(RESOURCES_DIR) + model->directory + "/" + texture.path]]);
+          texture.id = 0;
+        }
+      }
+    }
+  }
+
+  // Models own their meshes and texture references, so they can only be moved
+  Model(const Model&) = delete;
+  Model &operator=(const Model&) = delete;
+
+  Model(Model &&other) noexcept {
+    *this = std::move(other);
+  }
+
+  Model &operator=(Model &&other) noexcept {
+    if (this != &other) {
+      releaseTextures();
+      meshes = std::move(other.meshes);
+      loadedTextures = std::move(other.loadedTextures);
+      textureArrays = std::move(other.textureArrays);
+      directory = std::move(other.directory);
+      options = other.options;
+      pending = std::move(other.pending);
+      other.loadedTextures.clear();
+      other.textureArrays.clear();
+    }
+    return *this;
+  }
+
+  // Without a current context the textures already went with it, and GL can't be called
+  ~Model() {
+    if (glfwGetCurrentContext())
+      releaseTextures();
+  }
+
+  /*
+  * False while an async load is still in flight. Once the upload fence has signalled the meshes
+  * and textures are taken over and their VAOs created, which has to happen on this thread.
+  */
+  bool ready() {
+    if (!pending)
+      return true;
+    if (!pending->done.load(std::memory_order_acquire))
+      return false;
+    if (pending->fence) {
+      if (glClientWaitSync(pending->fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+        return false;
+      glDeleteSync(pending->fence);
+      pending->fence = 0;
+    }
+
+    meshes = std::move(pending->meshes);
+    loadedTextures = std::move(pending->loadedTextures);
+    textureArrays = std::move(pending->textureArrays);
+    directory = std::move(pending->directory);
+    pending->loadedTextures.clear();
+    pending->textureArrays.clear();
+    for (Mesh &mesh : meshes) {
+      if (mesh.VAO == 0)
+        mesh.setupVertexArray();
+    }
+    std::cout << "Streamed " << pending->path << " in " << glfwGetTime() - pending->started << "s" << std::endl;
+    pending.reset();
+    return true;
+  }
+
+  void draw(Shader &shader, unsigned int lod = 0) {
+    if (!ready())
+      return;
+    for (unsigned int i = 0; i < meshes.size(); ++i) {
+      meshes[i].draw(shader, lod);
+    }
+  }
+
+  unsigned int lodCount() const {
+    size_t count = 1;
+    for (const Mesh &mesh : meshes)
+      count = std::max(count, mesh.lods.size());
+    return (unsigned int)count;
+  }
+
+  // Worst object space deviation of any mesh drawn at this level
+  float lodError(unsigned int level) const {
+    float error = 0.0f;
+    for (const Mesh &mesh : meshes)
+      error = std::max(error, mesh.lod(level).error);
+    return error;
+  }
+
+  void getBounds(vec3 &boundsMin, vec3 &boundsMax) const {
+    boundsMin = vec3(0.0f);
+    boundsMax = vec3(0.0f);
     for (unsigned int i = 0; i < meshes.size(); ++i) {
-      meshes[i].draw(shader);
+      boundsMin = i == 0 ? meshes[i].boundsMin : glm::min(boundsMin, meshes[i].boundsMin);
+      boundsMax = i == 0 ? meshes[i].boundsMax : glm::max(boundsMax, meshes[i].boundsMax);
+    }
+  }
+
+  // CPU side geometry still held by the meshes next to what was uploaded to the GPU
+  void printMemoryReport(const string &name) const {
+    size_t cpuBytes = 0;
+    size_t gpuBytes = 0;
+    for (const Mesh &mesh : meshes) {
+      cpuBytes += mesh.cpuBytes();
+      gpuBytes += mesh.gpuBytes();
     }
+    std::cout << name << ": " << meshes.size() << " meshes, geometry GPU " << gpuBytes / 1024
+      << " KiB, CPU " << cpuBytes / 1024 << " KiB" << std::endl;
   }
 
 private:
-  vector<Texture> loadedTextures;
+  // Result of a load running on the AssetStreamer thread, shared with the job until it finishes
+  struct AsyncLoad {
+    std::atomic<bool> done{false};
+    GLsync fence = 0;
+    string path;
+    double started = 0.0;
+    vector<Mesh> meshes;
+    std::unordered_map<string, Texture> loadedTextures;
+    vector<unsigned int> textureArrays;
+    string directory;
+
+    ~AsyncLoad() {
+      if (!glfwGetCurrentContext())
+        return;
+      for (auto &loaded : loadedTextures) {
+        TextureCache::instance().release(loaded.second.id);
+      }
+      for (unsigned int array : textureArrays) {
+        TextureCache::instance().release(array);
+      }
+      if (fence)
+        glDeleteSync(fence);
+    }
+  };
+
+  // textures this model holds a TextureCache reference to, keyed by material path
+  std::unordered_map<string, Texture> loadedTextures;
+  // texture arrays this model holds a reference to once packed
+  vector<unsigned int> textureArrays;
   string directory;
+  ModelOptions options;
+  std::shared_ptr<AsyncLoad> pending;
+
+  void loadAsync(const char *path) {
+    pending = std::make_shared<AsyncLoad>();
+    pending->path = path;
+    pending->started = glfwGetTime();
+
+    ModelOptions streamed = options;
+    streamed.async = false;
+    std::shared_ptr<AsyncLoad> load = pending;
+    AssetStreamer::instance().submit([load, streamed]() {
+      // 1. Import and upload with the shared context current; the meshes come back without VAOs
+      Model model(load->path.c_str(), streamed);
+      load->meshes = std::move(model.meshes);
+      load->loadedTextures = std::move(model.loadedTextures);
+      load->textureArrays = std::move(model.textureArrays);
+      load->directory = std::move(model.directory);
+      model.loadedTextures.clear();
+      model.textureArrays.clear();
+
+      // 2. Fence the uploads and flush so the render thread's wait can ever see it signal
+      load->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+      glFlush();
+      load->done.store(true, std::memory_order_release);
+    });
+  }
+
+  void releaseTextures() {
+    for (auto &loaded : loadedTextures) {
+      TextureCache::instance().release(loaded.second.id);
+    }
+    loadedTextures.clear();
+    for (unsigned int array : textureArrays) {
+      TextureCache::instance().release(array);
+    }
+    textureArrays.clear();
+  }
 
   void loadModel(string path) {
-    // 1. Declare an Importer and call its ReadFile function
-    Assimp::Importer import;
+    const unsigned int importFlags = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace;
     std::string resourcePath = (std::string(RESOURCES_DIR) + path);
-    const aiScene *scene = import.ReadFile(resourcePath, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+    directory = path.substr(0, path.find_last_of('/'));
+
+    // 1. Try the binary mesh cache first, Assimp only runs on a miss
+    MeshCache cache(resourcePath, importFlags, processFlags());
+    if (loadFromCache(cache)) {
+      return;
+    }
 
-    // 2. After loading the model, check if the scene and the root node are not null
+    // 2. Declare an Importer and call its ReadFile function
+    Assimp::Importer import;
+    const aiScene *scene = import.ReadFile(resourcePath, importFlags);
+
+    // 3. After loading the model, check if the scene and the root node are not null
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
       return;
     }
 
-    // 3. Set the directory and process the root node, recursively
-    directory = path.substr(0, path.find_last_of('/'));
+    // 4. Decode every material texture on the image loader pool before building meshes
+    vector<Texture> references;
+    for (unsigned int i=0; i<scene->mNumMeshes; ++i) {
+      aiMaterial *material = scene->mMaterials[scene->mMeshes[i]->mMaterialIndex];
+      collectMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse", references);
+      collectMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular", references);
+      collectMaterialTextures(material, aiTextureType_HEIGHT, "texture_normal", references);
+    }
+    preloadTextures(references);
+
+    // 5. Process the root node, recursively, then cache the result for the next launch
+    MeshOptimizationReport report;
+    processNode(scene->mRootNode, scene, report);
+    if (options.optimize) {
+      printOptimizationReport(path, report);
+    }
+    cache.save(meshes);
+    for (Mesh &mesh : meshes) {
+      mesh.releaseGeometry(options.retention);
+    }
+  }
+
+  bool loadFromCache(MeshCache &cache) {
+    vector<MeshCache::MeshView> views;
+    if (!cache.load(views)) {
+      return false;
+    }
+
+    vector<Texture> references;
+    for (const MeshCache::MeshView &view : views) {
+      references.insert(references.end(), view.textures.begin(), view.textures.end());
+    }
+    preloadTextures(references);
 
-    processNode(scene->mRootNode, scene);
+    for (MeshCache::MeshView &view : views) {
+      vector<Texture> textures;
+      for (const Texture &reference : view.textures) {
+        textures.push_back(loadTextureReference(reference.path, reference.type));
+      }
+      meshes.emplace_back(view.vertices, view.vertexCount, view.indices, view.indexCount, std::move(textures), options.retention, options.vertexFormat, std::move(view.lods));
+      meshes.back().clusters = std::move(view.clusters);
+    }
+    return true;
   }
 
-  void processNode(aiNode *node, const aiScene *scene) {
+  void processNode(aiNode *node, const aiScene *scene, MeshOptimizationReport &report) {
     // 1. Process all the node's meshes, if any
     for (unsigned int i=0; i<node->mNumMeshes; ++i) {
       aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
-      meshes.push_back(processMesh(mesh, scene));
+      processMesh(mesh, scene, report);
     }
     // 2. Do the same for its children
     for (unsigned int i=0; i<node->mNumChildren; ++i) {
-      processNode(node->mChildren[i], scene);
+      processNode(node->mChildren[i], scene, report);
     }
   }
 
-  Mesh processMesh(aiMesh *mesh, const aiScene *scene) {
+  static void printOptimizationReport(const string &path, const MeshOptimizationReport &report) {
+    std::cout << "Optimised " << path << ": vertices " << report.verticesBefore << " -> " << report.verticesAfter
+      << ", ACMR " << report.before.acmr() << " -> " << report.after.acmr()
+      << ", ATVR " << report.before.atvr() << " -> " << report.after.atvr() << std::endl;
+  }
+
+  unsigned int processFlags() const {
+    unsigned int flags = 0;
+    if (options.splitLargeMeshes)
+      flags |= MESH_PROCESS_SPLIT_SHORT_INDICES;
+    if (options.optimize)
+      flags |= MESH_PROCESS_OPTIMIZE;
+    if (options.lodCount > 1)
+      flags |= MESH_PROCESS_LODS | (options.lodCount & 0xff) << 8 | ((unsigned int)(options.lodReduction * 100.0f) & 0xff) << 16;
+    if (options.clusters)
+      flags |= MESH_PROCESS_CLUSTERS;
+    return flags;
+  }
+
+  void processMesh(aiMesh *mesh, const aiScene *scene, MeshOptimizationReport &report) {
     vector<Vertex> vertices;
     vector<unsigned int> indices;
     vector<Texture> textures;
@@ -90,9 +398,18 @@ private:
         texture.x = mesh->mTextureCoords[0][i].x;
         texture.y = mesh->mTextureCoords[0][i].y;
       }
+
+      // the bitangent is rebuilt in the shader from cross(normal, tangent) and the stored sign
+      vec4 tangent = vec4(0.0);
+      if (mesh->HasTangentsAndBitangents()) {
+        vec3 t = vec3(mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z);
+        vec3 b = vec3(mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z);
+        tangent = vec4(t, glm::dot(glm::cross(normal, t), b) < 0.0f ? -1.0f : 1.0f);
+      }
       vertex.Position = position;
       vertex.Normal = normal;
       vertex.TexCoords = texture;
+      vertex.Tangent = tangent;
       vertices.push_back(vertex);
     }
 
@@ -119,7 +436,27 @@ private:
       textures.insert(textures.end(), normalMaps.begin(), normalMaps.end());
     }
 
-    return Mesh(vertices, indices, textures);
+    // 4. Weld and reorder for the GPU, then split large meshes so each part still fits 16 bit indices
+    if (options.optimize) {
+      optimizeMesh(vertices, indices, report);
+    }
+    if (options.splitLargeMeshes && vertices.size() > SHORT_INDEX_LIMIT) {
+      for (MeshChunk &chunk : splitForShortIndices(vertices, indices)) {
+        addMesh(std::move(chunk.vertices), std::move(chunk.indices), textures);
+      }
+      return;
+    }
+    addMesh(std::move(vertices), std::move(indices), std::move(textures));
+  }
+
+  void addMesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures) {
+    vector<MeshCluster> clusters;
+    if (options.clusters) {
+      clusters = buildClusters(vertices, indices);
+    }
+    vector<MeshLod> lods = buildLods(vertices, indices, options.lodCount, options.lodReduction);
+    meshes.emplace_back(std::move(vertices), std::move(indices), std::move(textures), options.vertexFormat, std::move(lods));
+    meshes.back().clusters = std::move(clusters);
   }
 
   vector<Texture> loadMaterialTextures(aiMaterial *mat, aiTextureType type, string typeName) {
@@ -127,69 +464,53 @@ private:
     for (unsigned int i=0; i<mat->GetTextureCount(type); ++i) {
       aiString str;
       mat->GetTexture(type, i, &str);
+      textures.push_back(loadTextureReference(str.C_Str(), typeName));
+    }
+    return textures;
+  }
 
+  void collectMaterialTextures(aiMaterial *mat, aiTextureType type, string typeName, vector<Texture> &references) {
+    for (unsigned int i=0; i<mat->GetTextureCount(type); ++i) {
+      aiString str;
+      mat->GetTexture(type, i, &str);
+      references.push_back({ 0, typeName, str.C_Str() });
+    }
+  }
 
-      bool skip = false;
-      // Compare the texture path with all the already loaded textures and skip if loaded already
-      for (unsigned int j=0; j<loadedTextures.size(); ++j) {
-        if (std::strcmp(loadedTextures[j].path.data(), str.C_Str()) == 0) {
-          textures.push_back(loadedTextures[j]);
-          skip = true;
-          break;
-        }
-      }
-
-      if (skip) continue;
+  /*
+  * Resolves every not-yet-loaded texture through the global TextureCache in one batch,
+  * so all misses decode in parallel and files shared with other Models are reused
+  */
+  void preloadTextures(const vector<Texture> &references) {
+    vector<Texture> pending;
+    vector<TextureRequest> requests;
+    for (const Texture &reference : references) {
+      if (loadedTextures.count(reference.path) != 0) continue;
+
+      loadedTextures[reference.path] = reference;
+      pending.push_back(reference);
+      requests.push_back({ std::string(RESOURCES_DIR) + directory + "/" + reference.path });
+    }
 
-      Texture texture;
-      texture.id = loadTexture(str.C_Str(), this->directory);
-      texture.type = typeName;
-      texture.path = str.C_Str();
-      textures.push_back(texture);
-      loadedTextures.push_back(texture);
+    vector<unsigned int> ids = TextureCache::instance().acquireAll(requests);
+    for (unsigned int i=0; i<pending.size(); ++i) {
+      loadedTextures[pending[i].path].id = ids[i];
     }
-    return textures;
   }
 
-  unsigned int loadTexture(char const* path, const string& directory) {
-    string filename = string(path);
-    filename = directory + "/" + filename;
-
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-    
-    int width, height, nrChannels;
-    std::string resourcePath = (std::string(RESOURCES_DIR) + filename);
-    unsigned char *data = stbi_load(resourcePath.c_str(), &width, &height, &nrChannels, 0);
-
-    if (data) {
-      GLenum format;
-      if (nrChannels == 1)
-        format = GL_RED;
-      else if (nrChannels == 3)
-        format = GL_RGB;
-      else if (nrChannels == 4)
-        format = GL_RGBA;
-
-      // Bind and set the newly created texture
-      glBindTexture(GL_TEXTURE_2D, textureID);
-      glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-      glGenerateMipmap(GL_TEXTURE_2D);
-
-      // set the texture wrapping / filtering options
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-      // free the data
-      stbi_image_free(data);
-    } else {
-      std::cout << "Failed to load texture" << std::endl;
-      stbi_image_free(data);
-    }
-
-    return textureID;
+  Texture loadTextureReference(const string &path, const string &typeName) {
+    // Reuse the texture if this model already holds it
+    auto loaded = loadedTextures.find(path);
+    if (loaded != loadedTextures.end()) {
+      return loaded->second;
+    }
+
+    Texture texture;
+    texture.id = TextureCache::instance().acquire(std::string(RESOURCES_DIR) + directory + "/" + path);
+    texture.type = typeName;
+    texture.path = path;
+    loadedTextures[path] = texture;
+    return texture;
   }
 };
 
@@ -0,0 +1,256 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+using std::vector;
+using std::string;
+
+// ARB_get_program_binary (core in 4.1) and KHR_parallel_shader_compile, glad is only generated for 3.3
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+typedef void (APIENTRYP PFNPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+typedef void (APIENTRYP PFNGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+typedef void (APIENTRYP PFNPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+typedef void (APIENTRYP PFNMAXSHADERCOMPILERTHREADSPROC)(GLuint count);
+
+/*
+* Persistent cache of linked program binaries
+*
+* Every Shader used to compile and link its sources on startup. With a ProgramCache the
+* linked program is written out once with glGetProgramBinary and handed straight back to
+* glProgramBinary afterwards.
+*
+*   [ProgramCacheHeader]
+*   [binary  ProgramCacheHeader::length bytes in ProgramCacheHeader::binaryFormat]
+*
+* Files are named after an FNV-1a hash of every source and the driver (vendor, renderer and
+* version), so editing a shader or updating the driver simply misses. A driver may still
+* reject a binary it wrote, in which case the file is dropped and the program is compiled
+* like before. Drivers without binary formats (or without the entry points) always compile.
+*
+* Compiling is where KHR_parallel_shader_compile comes in: Shader::compileAll() issues every
+* compile and link before it asks for a single status, which is what lets the driver spread
+* them over its compiler threads.
+*/
+const uint32_t PROGRAM_CACHE_MAGIC = 0x4d52474c; // "LGRM"
+const uint32_t PROGRAM_CACHE_VERSION = 1;
+
+struct ProgramCacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key;
+  uint32_t binaryFormat;
+  uint32_t length;
+};
+
+class ProgramCache {
+public:
+  struct Stats {
+    unsigned int hits = 0;
+    unsigned int misses = 0;
+    unsigned int rejected = 0;
+  };
+
+  static ProgramCache &instance() {
+    static ProgramCache cache;
+    return cache;
+  }
+
+  // Needs a current context, the entry points are resolved on first use
+  bool supported() {
+    loadFunctions();
+    return binaries;
+  }
+
+  // Whether the driver compiles in the background, so deferring status queries pays off
+  bool parallelCompile() {
+    loadFunctions();
+    return parallel;
+  }
+
+  // sources: everything the program is built from, already combined with any defines
+  uint64_t key(const vector<string> &sources) {
+    uint64_t hash = FNV_OFFSET;
+    hashString(driver(), hash);
+    for (const string &source : sources)
+      hashString(source, hash);
+    hashBytes(&PROGRAM_CACHE_VERSION, sizeof(PROGRAM_CACHE_VERSION), hash);
+    return hash;
+  }
+
+  // Links program from the cached binary, false (and the file is gone) when it cannot
+  bool load(uint64_t key, unsigned int program) {
+    if (!supported())
+      return false;
+    string path = cachePath(key);
+    std::ifstream in(path, std::ios::binary);
+    ProgramCacheHeader header = {};
+    if (!in || !in.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != PROGRAM_CACHE_MAGIC
+        || header.version != PROGRAM_CACHE_VERSION || header.key != key) {
+      stats.misses++;
+      return false;
+    }
+
+    vector<char> binary(header.length);
+    int success = 0;
+    if (in.read(binary.data(), binary.size())) {
+      glProgramBinaryProc(program, header.binaryFormat, binary.data(), (GLsizei)binary.size());
+      glGetProgramiv(program, GL_LINK_STATUS, &success);
+    }
+    if (!success) {
+      // a driver update can invalidate binaries without changing the version string
+      in.close();
+      std::error_code error;
+      std::filesystem::remove(path, error);
+      stats.rejected++;
+      stats.misses++;
+      return false;
+    }
+    stats.hits++;
+    return true;
+  }
+
+  // Call before linking a program that will be saved, some drivers only keep binaries when asked
+  void prepare(unsigned int program) {
+    if (supported())
+      glProgramParameteriProc(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
+
+  bool save(uint64_t key, unsigned int program) {
+    if (!supported())
+      return false;
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+      return false;
+
+    ProgramCacheHeader header = {};
+    header.magic = PROGRAM_CACHE_MAGIC;
+    header.version = PROGRAM_CACHE_VERSION;
+    header.key = key;
+    vector<char> binary(length);
+    GLenum binaryFormat = 0;
+    GLsizei written = 0;
+    glGetProgramBinaryProc(program, length, &written, &binaryFormat, binary.data());
+    header.binaryFormat = binaryFormat;
+    header.length = (uint32_t)written;
+
+    // Write to a temporary file and rename, so a crash never leaves a half written binary
+    string path = cachePath(key);
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+    string temporaryPath = path + ".tmp";
+    std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      std::cout << "ERROR::PROGRAM_CACHE::FAILED_TO_WRITE " << path << std::endl;
+      return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(binary.data(), written);
+    out.close();
+    if (!out) {
+      std::filesystem::remove(temporaryPath, error);
+      return false;
+    }
+    std::filesystem::rename(temporaryPath, path, error);
+    return !error;
+  }
+
+  Stats getStats() const {
+    return stats;
+  }
+
+  void printStats() const {
+    std::cout << "Program cache: " << stats.hits << " hits, " << stats.misses << " compiled ("
+      << stats.rejected << " rejected by the driver), " << (binaries ? "" : "binaries unsupported, ")
+      << (parallel ? "parallel" : "serial") << " compile" << std::endl;
+  }
+
+private:
+  static const uint64_t FNV_OFFSET = 14695981039346656037ull;
+
+  bool loaded = false;
+  bool binaries = false;
+  bool parallel = false;
+  Stats stats;
+  PFNPROGRAMPARAMETERIPROC glProgramParameteriProc = nullptr;
+  PFNGETPROGRAMBINARYPROC glGetProgramBinaryProc = nullptr;
+  PFNPROGRAMBINARYPROC glProgramBinaryProc = nullptr;
+
+  ProgramCache() = default;
+
+  void loadFunctions() {
+    if (loaded)
+      return;
+    loaded = true;
+    glProgramParameteriProc = (PFNPROGRAMPARAMETERIPROC)glfwGetProcAddress("glProgramParameteri");
+    glGetProgramBinaryProc = (PFNGETPROGRAMBINARYPROC)glfwGetProcAddress("glGetProgramBinary");
+    glProgramBinaryProc = (PFNPROGRAMBINARYPROC)glfwGetProcAddress("glProgramBinary");
+    GLint formats = 0;
+    if (glProgramParameteriProc && glGetProgramBinaryProc && glProgramBinaryProc)
+      glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    binaries = formats > 0;
+
+    // Let the driver use as many compiler threads as it likes
+    if (glfwExtensionSupported("GL_KHR_parallel_shader_compile")) {
+      auto maxThreads = (PFNMAXSHADERCOMPILERTHREADSPROC)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+      if (maxThreads)
+        maxThreads(0xffffffffu);
+      parallel = true;
+    } else if (glfwExtensionSupported("GL_ARB_parallel_shader_compile")) {
+      auto maxThreads = (PFNMAXSHADERCOMPILERTHREADSPROC)glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+      if (maxThreads)
+        maxThreads(0xffffffffu);
+      parallel = true;
+    }
+  }
+
+  static string driver() {
+    string result;
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+      const GLubyte *value = glGetString(name);
+      result += value ? reinterpret_cast<const char*>(value) : "";
+      result += '\n';
+    }
+    return result;
+  }
+
+  static string cachePath(uint64_t key) {
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+    return string(CACHE_DIR) + "/programs/" + name + ".bin";
+  }
+
+  static void hashBytes(const void *data, size_t size, uint64_t &hash) {
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash ^= bytes[i];
+      hash *= 1099511628211ull;
+    }
+  }
+
+  // Length first, so moving text between two sources changes the hash
+  static void hashString(const string &value, uint64_t &hash) {
+    uint64_t size = value.size();
+    hashBytes(&size, sizeof(size), hash);
+    hashBytes(value.data(), value.size(), hash);
+  }
+};
+
+#endif
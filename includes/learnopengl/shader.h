@@ -2,152 +2,370 @@
 #define SHADER_H
 
 #include <glad/glad.h>
+#include <GLFW/glfw3.h>
 
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/glm.hpp>
+#include <memory>
+#include <algorithm>
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <thread>
+#include <vector>
+#include <utility>
 #include <iostream>
+#include <unordered_map>
+#include "learnopengl/gl_state.h"
+#include "learnopengl/program_cache.h"
+#include "learnopengl/shader_preprocessor.h"
+
+/*
+* A uniform location resolved once, typed so Shader::set() picks the right glUniform call.
+* Inactive or misspelt uniforms resolve to -1, which GL ignores like it does for strings.
+*/
+template <typename T>
+struct UniformHandle {
+  GLint location = -1;
+
+  bool valid() const { return location >= 0; }
+};
+
+inline void uploadUniform(GLint location, bool value) { glUniform1i(location, (int)value); }
+inline void uploadUniform(GLint location, int value) { glUniform1i(location, value); }
+inline void uploadUniform(GLint location, float value) { glUniform1f(location, value); }
+inline void uploadUniform(GLint location, const glm::vec2 &value) { glUniform2f(location, value.x, value.y); }
+inline void uploadUniform(GLint location, const glm::vec3 &value) { glUniform3f(location, value.x, value.y, value.z); }
+inline void uploadUniform(GLint location, const glm::vec4 &value) { glUniform4f(location, value.x, value.y, value.z, value.w); }
+inline void uploadUniform(GLint location, const glm::mat3 &value) { glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(value)); }
+inline void uploadUniform(GLint location, const glm::mat4 &value) { glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value)); }
+
+// Source files of one program, the geometry stage is optional. Defines apply to every stage
+struct ShaderFiles {
+  std::string vertex;
+  std::string fragment;
+  std::string geometry;
+  ShaderDefines defines;
+};
 
 class Shader {
 public:
 	// the program ID
-	unsigned int ID;
+	unsigned int ID = 0;
 	
   Shader(const char* vertexPath, const char* geometryPath, const char* fragmentPath) {
-    unsigned int vertex = generateShader(vertexPath, GL_VERTEX_SHADER);
-    unsigned int geometry = generateShader(geometryPath, GL_GEOMETRY_SHADER);
-    unsigned int fragment = generateShader(fragmentPath, GL_FRAGMENT_SHADER);
+    PendingProgram pending = begin({ vertexPath, fragmentPath, geometryPath });
+    finish(pending);
+  }
 
-    ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, geometry);
-    glAttachShader(ID, fragment);
-    glLinkProgram(ID);
+	// constructor reads and builds the shader, or loads it from the program cache
+  Shader(const char* vertexPath, const char* fragmentPath) {
+    PendingProgram pending = begin({ vertexPath, fragmentPath });
+    finish(pending);
+  }
 
-    int success;
-    char infoLog[512];
-    glGetProgramiv(ID, GL_LINK_STATUS, &success);
-    if (!success) {
-      glGetProgramInfoLog(ID, 512, NULL, infoLog);
-      std::cout << "ERROR:SHADER::PROGRAM::LINKING_FAILURE\n" << infoLog << std::endl;
-    }
-    glDeleteShader(vertex);
-    glDeleteShader(geometry);
-    glDeleteShader(fragment);
+  // preprocessed with files.defines, see shader_preprocessor.h
+  explicit Shader(const ShaderFiles &files) {
+    PendingProgram pending = begin(files);
+    finish(pending);
   }
 
-	// constructor reads and builds the shader
-  Shader(const char* vertexPath, const char* fragmentPath) {
-    unsigned int vertex = generateShader(vertexPath, GL_VERTEX_SHADER);
-    unsigned int fragment = generateShader(fragmentPath, GL_FRAGMENT_SHADER);
+  // GPU objects have a single owner, so shaders can only be moved
+  Shader(const Shader&) = delete;
+  Shader &operator=(const Shader&) = delete;
 
-    // 3 - Link Shader
-    ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
-    glLinkProgram(ID);
+  Shader(Shader &&other) noexcept {
+    *this = std::move(other);
+  }
 
-    int success;
-    char infoLog[512];
-    glGetProgramiv(ID, GL_LINK_STATUS, &success);
-    if (!success) {
-      glGetProgramInfoLog(ID, 512, NULL, infoLog);
-      std::cout << "ERROR:SHADER::PROGRAM::LINKING_FAILURE\n" << infoLog << std::endl;
+  Shader &operator=(Shader &&other) noexcept {
+    if (this != &other) {
+      if (ID)
+        glDeleteProgram(ID);
+      ID = other.ID;
+      uniforms = std::move(other.uniforms);
+      other.ID = 0;
     }
+    return *this;
+  }
 
-    // Delete shaders as they're linked to the program and are no longer necessary
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+  // A Shader still in scope after glfwTerminate() has nothing left to delete
+  ~Shader() {
+    if (ID && glfwGetCurrentContext())
+      glDeleteProgram(ID);
+  }
+
+  /*
+  * Builds several programs at once. Every compile and link is issued before the first status
+  * query and programs are finished as the driver completes them, so a driver with parallel
+  * compilation works on all of them together instead of one after the other.
+  */
+  static std::vector<Shader> compileAll(const std::vector<ShaderFiles> &files) {
+    std::vector<PendingProgram> pending;
+    for (const ShaderFiles &program : files)
+      pending.push_back(begin(program));
+
+    std::vector<Shader> shaders;
+    std::vector<std::unique_ptr<Shader>> finished(pending.size());
+    size_t remaining = pending.size();
+    while (remaining > 0) {
+      for (size_t i = 0; i < pending.size(); ++i) {
+        // without the extension the query blocks, so the first unfinished program simply goes next
+        if (finished[i] || (ProgramCache::instance().parallelCompile() && !pending[i].completed()))
+          continue;
+        finished[i].reset(new Shader(pending[i]));
+        remaining--;
+      }
+      if (remaining > 0)
+        std::this_thread::yield();
+    }
+    for (std::unique_ptr<Shader> &shader : finished)
+      shaders.push_back(std::move(*shader));
+    return shaders;
   }
 
   // to activate the shader
   void use() {
-    glUseProgram(ID);
+    GLState::instance().useProgram(ID);
   }
 
-  // utility functions
+  // Resolves a uniform once, for hot paths that set it every frame
+  template <typename T>
+  UniformHandle<T> uniform(const std::string &name) const {
+    return { location(name) };
+  }
+
+  template <typename T>
+  void set(UniformHandle<T> handle, const T &value) const {
+    uploadUniform(handle.location, value);
+  }
+
+  // utility functions; each call is one hash lookup in the table reflected at link time
   void setBool(const std::string &name, bool value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    glUniform1i(lookup(name), (int)value);
   }
 
   void setInt(const std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1i(lookup(name), value);
   }
 
   void setFloat(const std::string &name, float value) const {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1f(lookup(name), value);
   };
 
   void setVec2(const std::string &name, float x, float y) const {
-    glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+    glUniform2f(lookup(name), x, y);
   };
 
   void setVec2(const std::string &name, glm::vec2 value) const {
-    glUniform2f(glGetUniformLocation(ID, name.c_str()), value.x, value.y);
+    glUniform2f(lookup(name), value.x, value.y);
   };
 
   void setVec3(const std::string &name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+    glUniform3f(lookup(name), x, y, z);
   };
 
   void setVec3(const std::string &name, glm::vec3 value) const {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), value.x, value.y, value.z);
+    glUniform3f(lookup(name), value.x, value.y, value.z);
   };
 
   void setMat4(const std::string &name, glm::mat4 value) const {
-    unsigned int loc = glGetUniformLocation(ID, name.c_str());
-    glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(value));
+    glUniformMatrix4fv(lookup(name), 1, GL_FALSE, glm::value_ptr(value));
   };
 
   void setMat3(const std::string &name, glm::mat3 value) const {
-    unsigned int loc = glGetUniformLocation(ID, name.c_str());
-    glUniformMatrix3fv(loc, 1, GL_FALSE, glm::value_ptr(value));
+    glUniformMatrix3fv(lookup(name), 1, GL_FALSE, glm::value_ptr(value));
   };
 
+  // Location of an active uniform from the link time table, -1 when there is no such uniform
+  GLint location(const std::string &name) const {
+    auto found = uniforms.find(name);
+    return found != uniforms.end() ? found->second : -1;
+  }
+
+  /*
+  * String lookups made through the set*() functions by every Shader since the last reset.
+  * Reset it once a frame to see what is left to move onto UniformHandles.
+  */
+  static unsigned int &stringLookups() {
+    static unsigned int count = 0;
+    return count;
+  }
+
+  static unsigned int resetStringLookups() {
+    unsigned int count = stringLookups();
+    stringLookups() = 0;
+    return count;
+  }
+
+  /*
+  * Binding point for every block of this name in every program, handed out on first use.
+  * Starts above the few points examples bind by hand, see uniform_buffer.h
+  */
+  static GLuint uniformBlockBinding(const std::string &name) {
+    static std::unordered_map<std::string, GLuint> bindings;
+    auto found = bindings.find(name);
+    if (found != bindings.end())
+      return found->second;
+    GLuint binding = FIRST_SHARED_BLOCK_BINDING + (GLuint)bindings.size();
+    bindings[name] = binding;
+    return binding;
+  }
+
 private:
-  unsigned int generateShader(const char *path, unsigned int SHADER_TYPE) {
-    // 1: Retrieve the vertex / fragment source code from the filepaths
-    std::string shaderCode;
-    std::ifstream shaderFile;
-    
-    // Ensure ifstream objects can throw exceptions
-    shaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-    
-    try {
-      // Open files
-      shaderFile.open(path);
-    
-      // Read files' buffer contents into stream
-      std::stringstream shaderStream;
-      shaderStream << shaderFile.rdbuf();
-    
-      // Close file handlers
-      shaderFile.close();
-      
-      // Convert stream into string
-      shaderCode = shaderStream.str();
-    } catch(std::ifstream::failure e) {
-      std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << std::endl;
+  std::unordered_map<std::string, GLint> uniforms;
+
+  GLint lookup(const std::string &name) const {
+    stringLookups()++;
+    return location(name);
+  }
+
+  static const GLuint FIRST_SHARED_BLOCK_BINDING = 8;
+
+  // Points every uniform block at the binding shared by all blocks of its name
+  void bindUniformBlocks() {
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+    std::string buffer(std::max(maxLength, 1), '\0');
+    for (GLint i = 0; i < count; ++i) {
+      GLsizei length = 0;
+      glGetActiveUniformBlockName(ID, (GLuint)i, (GLsizei)buffer.size(), &length, &buffer[0]);
+      glUniformBlockBinding(ID, (GLuint)i, uniformBlockBinding(buffer.substr(0, length)));
+    }
+  }
+
+  // Every active uniform by name; arrays also by "name" and every "name[i]"
+  void reflectUniforms() {
+    std::unordered_map<std::string, GLint> table;
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::string buffer(std::max(maxLength, 1), '\0');
+    for (GLint i = 0; i < count; ++i) {
+      GLsizei length = 0;
+      GLint size = 0;
+      GLenum type = 0;
+      glGetActiveUniform(ID, (GLuint)i, (GLsizei)buffer.size(), &length, &size, &type, &buffer[0]);
+      std::string name = buffer.substr(0, length);
+      GLint first = glGetUniformLocation(ID, name.c_str());
+      if (first < 0)
+        continue; // uniform block members have no location
+      table[name] = first;
+
+      // "lights[0]" style names stand for the whole array
+      if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+        std::string base = name.substr(0, name.size() - 3);
+        table[base] = first;
+        for (GLint element = 1; element < size; ++element) {
+          std::string elementName = base + "[" + std::to_string(element) + "]";
+          table[elementName] = glGetUniformLocation(ID, elementName.c_str());
+        }
+      }
     }
+    uniforms = std::move(table);
+  }
 
-    const char* code = shaderCode.c_str();
-    // 2 - Compile Shaders
+  struct Stage {
     unsigned int shader;
-    int success;
-    char infoLog[512];
+    GLenum type;
+    std::vector<std::string> files;
+  };
+
+  // A program whose compile and link have been issued but not checked yet
+  struct PendingProgram {
+    ShaderFiles files;
+    unsigned int program = 0;
+    std::vector<Stage> stages;
+    uint64_t key = 0;
+    bool cached = false;
+
+    bool completed() const {
+      if (cached)
+        return true;
+      GLint done = GL_TRUE;
+      glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &done);
+      return done == GL_TRUE;
+    }
+  };
+
+  explicit Shader(PendingProgram &pending) {
+    finish(pending);
+  }
+
+  // 1 - Read the sources, then either load the cached binary or issue the compile and link
+  static PendingProgram begin(const ShaderFiles &files) {
+    PendingProgram pending;
+    pending.files = files;
+    std::vector<std::pair<ShaderSource, GLenum>> sources;
+    sources.push_back({ preprocessShader(files.vertex, files.defines), GL_VERTEX_SHADER });
+    if (!files.geometry.empty())
+      sources.push_back({ preprocessShader(files.geometry, files.defines), GL_GEOMETRY_SHADER });
+    sources.push_back({ preprocessShader(files.fragment, files.defines), GL_FRAGMENT_SHADER });
+
+    // the defines are part of the preprocessed code, so every variant gets its own binary
+    std::vector<std::string> keySources;
+    for (const auto &source : sources)
+      keySources.push_back(source.first.code);
+    ProgramCache &cache = ProgramCache::instance();
+    pending.key = cache.key(keySources);
+    pending.program = glCreateProgram();
+    if (cache.load(pending.key, pending.program)) {
+      pending.cached = true;
+      return pending;
+    }
+
+    // a rejected binary can leave the program in a failed state, so start from a fresh one
+    glDeleteProgram(pending.program);
+    pending.program = glCreateProgram();
+    for (const auto &source : sources) {
+      unsigned int shader = glCreateShader(source.second);
+      const char *code = source.first.code.c_str();
+      glShaderSource(shader, 1, &code, NULL);
+      glCompileShader(shader);
+      glAttachShader(pending.program, shader);
+      pending.stages.push_back({ shader, source.second, source.first.files });
+    }
+    cache.prepare(pending.program);
+    glLinkProgram(pending.program);
+    return pending;
+  }
+
+  // 2 - Check the link (and only then the compile logs), save the binary and reflect the uniforms
+  void finish(PendingProgram &pending) {
+    ID = pending.program;
+    if (!pending.cached) {
+      int success;
+      char infoLog[512];
+      glGetProgramiv(ID, GL_LINK_STATUS, &success);
+      if (!success) {
+        for (const Stage &stage : pending.stages)
+          checkCompile(stage);
+        glGetProgramInfoLog(ID, 512, NULL, infoLog);
+        std::cout << "ERROR:SHADER::PROGRAM::LINKING_FAILURE\n" << infoLog << std::endl;
+      } else {
+        ProgramCache::instance().save(pending.key, ID);
+      }
 
-    // Vertex Shader
-    shader = glCreateShader(SHADER_TYPE);
-    glShaderSource(shader, 1, &code, NULL);
-    glCompileShader(shader);
+      // Delete shaders as they're linked to the program and are no longer necessary
+      for (const Stage &stage : pending.stages) {
+        glDetachShader(ID, stage.shader);
+        glDeleteShader(stage.shader);
+      }
+      pending.stages.clear();
+    }
+    reflectUniforms();
+    bindUniformBlocks();
+  }
 
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+  static void checkCompile(const Stage &stage) {
+    int success;
+    char infoLog[512];
+    glGetShaderiv(stage.shader, GL_COMPILE_STATUS, &success);
     if (!success) {
-      glGetShaderInfoLog(shader, 512, NULL, infoLog);
+      glGetShaderInfoLog(stage.shader, 512, NULL, infoLog);
       std::string shaderTypeStr;
-      switch (SHADER_TYPE) {
+      switch (stage.type) {
         case GL_VERTEX_SHADER:
           shaderTypeStr = "VERTEX";
           break;
@@ -161,12 +379,40 @@ private:
           shaderTypeStr = "UNKNOWN";
           break;
       }
-      std::cout << "ERROR:SHADER::VERTEX::COMPILATION_FAILURE\n" << infoLog << std::endl;
+      std::cout << "ERROR:SHADER::" << shaderTypeStr << "::COMPILATION_FAILURE\n" << infoLog << std::endl;
+      // log lines are numbered per file, e.g. 1(12) is line 12 of the first include
+      for (unsigned int i = 0; i < stage.files.size() && stage.files.size() > 1; ++i)
+        std::cout << "  " << i << ": " << stage.files[i] << std::endl;
     }
+  }
+};
+
+/*
+* One set of source files compiled once per define set and kept, so a scene picks the variant
+* specialised for it (e.g. its exact light count) and switching back never compiles again
+*/
+class ShaderVariants {
+public:
+  ShaderVariants(ShaderFiles files) : files(std::move(files)) {}
 
-    return shader;
-    return 0;
+  // defines are added to (and override) the ones in files
+  Shader &get(const ShaderDefines &defines = {}) {
+    auto found = variants.find(defines);
+    if (found != variants.end())
+      return found->second;
+    ShaderFiles variant = files;
+    for (const auto &define : defines)
+      variant.defines[define.first] = define.second;
+    return variants.emplace(defines, Shader(variant)).first->second;
   }
+
+  size_t size() const {
+    return variants.size();
+  }
+
+private:
+  ShaderFiles files;
+  std::map<ShaderDefines, Shader> variants;
 };
 
 #endif
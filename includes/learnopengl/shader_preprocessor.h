@@ -0,0 +1,117 @@
+#ifndef SHADER_PREPROCESSOR_H
+#define SHADER_PREPROCESSOR_H
+
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <filesystem>
+
+using std::vector;
+using std::string;
+
+/*
+* GLSL preprocessing ahead of glShaderSource
+*
+*   #include "file.glsl"   pasted in place, relative to the including file. Every file is pasted
+*                         at most once per stage, so shared files need no include guards
+*   defines               injected right after #version, before any of the source
+*
+* Defines turn one source into specialised variants: a light count becomes a constant loop
+* bound the compiler can unroll, and #ifdef'd features compile out entirely instead of being
+* branched around at runtime. Sources can keep a default with #ifndef NAME / #define NAME.
+*
+* #line directives keep compile errors pointing at the original files: a log line such as
+* 1(12) is line 12 of ShaderSource::files[1].
+*/
+using ShaderDefines = std::map<string, string>;
+
+struct ShaderSource {
+  string code;
+  vector<string> files; // indexed by the source string number in #line
+  bool valid = true;
+};
+
+namespace shader_preprocessor {
+  inline bool readFile(const string &path, string &contents) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+      return false;
+    std::stringstream stream;
+    stream << file.rdbuf();
+    contents = stream.str();
+    return true;
+  }
+
+  // The quoted or bracketed path of an #include line, empty for any other line
+  inline string includePath(const string &line) {
+    size_t start = line.find_first_not_of(" \t");
+    if (start == string::npos || line.compare(start, 8, "#include") != 0)
+      return "";
+    size_t open = line.find_first_of("\"<", start + 8);
+    if (open == string::npos)
+      return "";
+    size_t close = line.find(line[open] == '"' ? '"' : '>', open + 1);
+    return close == string::npos ? "" : line.substr(open + 1, close - open - 1);
+  }
+
+  inline bool isVersion(const string &line) {
+    size_t start = line.find_first_not_of(" \t");
+    return start != string::npos && line.compare(start, 8, "#version") == 0;
+  }
+
+  inline void append(const string &path, const ShaderDefines &defines, ShaderSource &source, std::set<string> &included) {
+    string canonical = std::filesystem::weakly_canonical(path).string();
+    if (!included.insert(canonical).second)
+      return;
+    string contents;
+    if (!readFile(path, contents)) {
+      std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ " << path << std::endl;
+      source.valid = false;
+      return;
+    }
+
+    unsigned int fileIndex = (unsigned int)source.files.size();
+    source.files.push_back(path);
+    std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    std::istringstream lines(contents);
+    string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(lines, line)) {
+      lineNumber++;
+      if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+
+      // 1. Defines go straight after the version, which has to stay the first line
+      if (fileIndex == 0 && isVersion(line)) {
+        source.code += line + "\n";
+        for (const auto &define : defines)
+          source.code += "#define " + define.first + " " + define.second + "\n";
+        source.code += "#line " + std::to_string(lineNumber + 1) + " 0\n";
+        continue;
+      }
+
+      // 2. Paste includes in place and return to this file's numbering afterwards
+      string include = includePath(line);
+      if (include.empty()) {
+        source.code += line + "\n";
+        continue;
+      }
+      source.code += "#line 1 " + std::to_string(source.files.size()) + "\n";
+      append((directory / include).string(), defines, source, included);
+      source.code += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+    }
+  }
+}
+
+inline ShaderSource preprocessShader(const string &path, const ShaderDefines &defines = {}) {
+  ShaderSource source;
+  std::set<string> included;
+  shader_preprocessor::append(path, defines, source, included);
+  return source;
+}
+
+#endif
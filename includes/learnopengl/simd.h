@@ -0,0 +1,63 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+/*
+* Four float lanes for the CPU texture and IBL bakers
+*
+*   SSE   every x86-64 compiler enables it, so no build flags are needed
+*   NEON  every AArch64 compiler enables it
+*   plain floats everywhere else, with the same interface
+*
+* glm is built without GLM_FORCE_INTRINSICS and the examples build without optimisation flags,
+* so its vec4 math stays scalar; the hot loops go through these instead. Loads and stores are
+* unaligned, so they work straight on glm::vec4 arrays and std::vector<float>.
+*/
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace simd {
+#if defined(SIMD_SSE)
+  typedef __m128 Float4;
+
+  inline Float4 load(const float *p) { return _mm_loadu_ps(p); }
+  inline void store(float *p, Float4 v) { _mm_storeu_ps(p, v); }
+  inline Float4 splat(float x) { return _mm_set1_ps(x); }
+  inline Float4 set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+  inline Float4 zero() { return _mm_setzero_ps(); }
+  inline Float4 add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+  inline Float4 mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+  // a * b + c
+  inline Float4 madd(Float4 a, Float4 b, Float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+#elif defined(SIMD_NEON)
+  typedef float32x4_t Float4;
+
+  inline Float4 load(const float *p) { return vld1q_f32(p); }
+  inline void store(float *p, Float4 v) { vst1q_f32(p, v); }
+  inline Float4 splat(float x) { return vdupq_n_f32(x); }
+  inline Float4 set(float x, float y, float z, float w) { const float lanes[4] = { x, y, z, w }; return vld1q_f32(lanes); }
+  inline Float4 zero() { return vdupq_n_f32(0.0f); }
+  inline Float4 add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+  inline Float4 mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+  inline Float4 madd(Float4 a, Float4 b, Float4 c) { return vmlaq_f32(c, a, b); }
+#else
+  struct Float4 {
+    float lanes[4];
+  };
+
+  inline Float4 load(const float *p) { return { { p[0], p[1], p[2], p[3] } }; }
+  inline void store(float *p, Float4 v) { for (int i = 0; i < 4; ++i) p[i] = v.lanes[i]; }
+  inline Float4 splat(float x) { return { { x, x, x, x } }; }
+  inline Float4 set(float x, float y, float z, float w) { return { { x, y, z, w } }; }
+  inline Float4 zero() { return splat(0.0f); }
+  inline Float4 add(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.lanes[i] += b.lanes[i]; return a; }
+  inline Float4 mul(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.lanes[i] *= b.lanes[i]; return a; }
+  inline Float4 madd(Float4 a, Float4 b, Float4 c) { return add(mul(a, b), c); }
+#endif
+}
+
+#endif
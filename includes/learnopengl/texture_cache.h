@@ -0,0 +1,482 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include "learnopengl/image_loader.h"
+#include "learnopengl/texture_compression.h"
+#include <glad/glad.h>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <iostream>
+#include <mutex>
+#include <filesystem>
+#include <map>
+#include <unordered_map>
+
+using std::vector;
+using std::string;
+
+struct TextureSettings {
+  bool srgb = false;
+  GLint wrap = GL_REPEAT;
+  GLint minFilter = GL_LINEAR_MIPMAP_LINEAR;
+  GLint magFilter = GL_LINEAR;
+  bool mipmaps = true;
+  // use a cooked .ktx2 next to the source when there is an up to date one (see texture_compression.h)
+  bool compressed = true;
+};
+
+struct TextureRequest {
+  string path; // absolute path, e.g. RESOURCES_DIR + "/textures/container.jpg"
+  TextureSettings settings;
+};
+
+// Where a texture ended up after packing: a GL_TEXTURE_2D_ARRAY and the layer within it
+struct TextureLayer {
+  unsigned int array = 0;
+  unsigned int layer = 0;
+};
+
+/*
+* Process-wide, reference counted texture cache
+*
+* Textures are keyed by resolved path plus every setting that changes the GL object
+* (colour space, sampler state, mips, flip), so two Models or two examples that ask
+* for the same file share one GL handle. Misses are decoded on the ImageLoader pool, unless
+* tools/texture-compressor has cooked a .ktx2 for them, which carries its own mip chain.
+*
+* The cache can be used from the AssetStreamer upload thread as well as the render thread.
+* Decoding and uploading happen outside the lock; if two threads race on the same texture the
+* second upload is thrown away.
+*/
+class TextureCache {
+public:
+  struct Stats {
+    unsigned int hits = 0;
+    unsigned int misses = 0;
+    unsigned int live = 0;
+    unsigned int compressed = 0; // live textures uploaded block compressed
+    size_t gpuBytes = 0;         // estimated for uncompressed textures, RGB counted as RGBA
+  };
+
+  static TextureCache &instance() {
+    static TextureCache cache;
+    return cache;
+  }
+
+  unsigned int acquire(const string &path, TextureSettings settings = {}) {
+    return acquireAll({ { path, settings } })[0];
+  }
+
+  /*
+  * Resolves a batch of requests in order. Misses with a cooked .ktx2 next to them are uploaded
+  * block compressed; all other misses are decoded in parallel, then uploaded.
+  */
+  vector<unsigned int> acquireAll(const vector<TextureRequest> &requests) {
+    vector<unsigned int> ids(requests.size(), 0);
+    vector<string> keys(requests.size());
+    vector<unsigned int> missOwners;
+
+    // 1. Hash lookups; the first request for a missing key schedules the load
+    std::unordered_map<string, unsigned int> scheduled;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (unsigned int i = 0; i < requests.size(); ++i) {
+        keys[i] = makeKey(requests[i]);
+        auto found = entries.find(keys[i]);
+        if (found != entries.end()) {
+          found->second.references++;
+          ids[i] = found->second.id;
+          stats.hits++;
+          continue;
+        }
+        if (scheduled.count(keys[i]) == 0) {
+          scheduled[keys[i]] = i;
+          missOwners.push_back(i);
+        }
+      }
+    }
+
+    // 2. Upload cooked textures straight away, decode the rest on the pool and upload them in request order
+    vector<Entry> uploaded(missOwners.size());
+    vector<ImageRequest> decodes;
+    vector<unsigned int> decodeSlots;
+    for (unsigned int i = 0; i < missOwners.size(); ++i) {
+      const TextureRequest &request = requests[missOwners[i]];
+      CompressedImage compressed;
+      if (request.settings.compressed && loadCooked(request.path, compressed)) {
+        uploaded[i] = uploadCooked(compressed, request.settings);
+        continue;
+      }
+      decodes.push_back({ request.path });
+      decodeSlots.push_back(i);
+    }
+    vector<Image> images = ImageLoader::instance().loadAll(decodes);
+    for (unsigned int i = 0; i < images.size(); ++i) {
+      uploaded[decodeSlots[i]] = upload(images[i], requests[missOwners[decodeSlots[i]]].settings);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (unsigned int i = 0; i < uploaded.size(); ++i) {
+      unsigned int owner = missOwners[i];
+      if (entries.count(keys[owner]) != 0) {
+        glDeleteTextures(1, &uploaded[i].id);
+        stats.hits++;
+        continue;
+      }
+      entries[keys[owner]] = uploaded[i];
+      keysById[uploaded[i].id] = keys[owner];
+      stats.misses++;
+    }
+
+    // 3. Hand out the freshly uploaded handles
+    for (unsigned int i = 0; i < requests.size(); ++i) {
+      if (ids[i] != 0)
+        continue;
+      Entry &entry = entries[keys[i]];
+      entry.references++;
+      ids[i] = entry.id;
+    }
+    return ids;
+  }
+
+  /*
+  * Packs textures into GL_TEXTURE_2D_ARRAYs, one per distinct size and upload format, and returns
+  * the array and layer of every path. Each call holds one reference per array it returns, which
+  * is dropped with release() like any texture. The same paths in the same order share arrays.
+  */
+  vector<TextureLayer> acquireLayers(const vector<string> &paths, TextureSettings settings = {}) {
+    // 1. Group by what each layer will be uploaded as; layers keep their order within a group.
+    //    Only headers are read, and the same paths asked for again reuse the grouping
+    string layoutKey;
+    for (const string &path : paths)
+      layoutKey += ";" + makeKey({ path, settings });
+    vector<vector<unsigned int>> groups;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto found = layouts.find(layoutKey);
+      if (found != layouts.end())
+        groups = found->second;
+    }
+    if (groups.empty()) {
+      std::map<string, vector<unsigned int>> bySignature;
+      for (unsigned int i = 0; i < paths.size(); ++i) {
+        bySignature[layerSignature(paths[i], settings)].push_back(i);
+      }
+      for (auto &group : bySignature)
+        groups.push_back(std::move(group.second));
+      std::lock_guard<std::mutex> lock(mutex);
+      layouts[layoutKey] = groups;
+    }
+
+    // 2. One array per group, built the first time with one read of every member
+    vector<TextureLayer> layers(paths.size());
+    for (const vector<unsigned int> &group : groups) {
+      vector<string> members;
+      for (unsigned int index : group)
+        members.push_back(paths[index]);
+      unsigned int array = acquireArray(members, settings);
+      for (unsigned int layer = 0; layer < group.size(); ++layer)
+        layers[group[layer]] = { array, layer };
+    }
+    return layers;
+  }
+
+  // Drops one reference; the GL texture is deleted when nobody holds it anymore
+  void release(unsigned int id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto key = keysById.find(id);
+    if (key == keysById.end())
+      return;
+
+    auto entry = entries.find(key->second);
+    if (--entry->second.references > 0)
+      return;
+
+    glDeleteTextures(1, &id);
+    entries.erase(entry);
+    keysById.erase(key);
+  }
+
+  Stats getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats current = stats;
+    current.live = (unsigned int)entries.size();
+    for (const auto &entry : entries) {
+      current.compressed += entry.second.compressed ? 1 : 0;
+      current.gpuBytes += entry.second.bytes;
+    }
+    return current;
+  }
+
+  void printStats() const {
+    Stats current = getStats();
+    std::cout << "Texture cache: " << current.hits << " hits, " << current.misses << " misses, "
+      << current.live << " live textures (" << current.compressed << " compressed, "
+      << current.gpuBytes / (1024 * 1024) << " MiB)" << std::endl;
+  }
+
+private:
+  struct Entry {
+    unsigned int id = 0;
+    unsigned int references = 0;
+    size_t bytes = 0;
+    bool compressed = false;
+  };
+
+  std::unordered_map<string, Entry> entries;
+  std::unordered_map<unsigned int, string> keysById;
+  // how acquireLayers split each list of paths into arrays
+  std::unordered_map<string, vector<vector<unsigned int>>> layouts;
+  Stats stats;
+  mutable std::mutex mutex;
+
+  TextureCache() {}
+
+  static string makeKey(const TextureRequest &request) {
+    const TextureSettings &settings = request.settings;
+    return request.path
+      + "|" + std::to_string(settings.srgb)
+      + "|" + std::to_string(settings.wrap)
+      + "|" + std::to_string(settings.minFilter)
+      + "|" + std::to_string(settings.magFilter)
+      + "|" + std::to_string(settings.mipmaps)
+      + "|" + std::to_string(settings.compressed)
+      + "|" + std::to_string(ImageLoader::flipVerticallyOnLoad());
+  }
+
+  // The compressed formats this driver can sample from, read once per process
+  static bool compressedFormatSupported(GLenum format) {
+    static const vector<GLint> supported = []() {
+      GLint count = 0;
+      glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+      vector<GLint> formats(count);
+      if (count > 0)
+        glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data());
+      return formats;
+    }();
+    return std::find(supported.begin(), supported.end(), (GLint)format) != supported.end();
+  }
+
+  // The texture itself if it's a .ktx2 / .dds, otherwise a .ktx2 beside it that's newer than the source
+  static string cookedPath(const string &path) {
+    if (isCompressedTexturePath(path))
+      return path;
+
+    std::error_code error;
+    std::filesystem::path cooked = std::filesystem::path(path).replace_extension(".ktx2");
+    if (!std::filesystem::exists(cooked, error))
+      return "";
+    auto sourceTime = std::filesystem::last_write_time(path, error);
+    if (!error && std::filesystem::last_write_time(cooked, error) < sourceTime)
+      return "";
+    return cooked.string();
+  }
+
+  static bool loadCooked(const string &path, CompressedImage &image) {
+    string cooked = cookedPath(path);
+    return !cooked.empty() && loadCompressedImage(cooked, image) && cookedUsable(cooked, image.format, image.bottomUp);
+  }
+
+  // Same checks as loadCooked, from the header alone
+  static bool cookedInfo(const string &path, CompressedImageInfo &info) {
+    string cooked = cookedPath(path);
+    return !cooked.empty() && loadCompressedInfo(cooked, info) && cookedUsable(cooked, info.format, info.bottomUp);
+  }
+
+  static bool cookedUsable(const string &cooked, BlockFormat format, bool bottomUp) {
+    // rows can't be flipped inside blocks, so a file cooked the other way up falls back to the source
+    if (bottomUp != ImageLoader::flipVerticallyOnLoad()) {
+      std::cout << "Texture " << cooked << " was cooked for the other vertical flip, decoding the source" << std::endl;
+      return false;
+    }
+    if (format != BlockFormat::RGBA8 && !compressedFormatSupported(blockFormatGL(format, false))) {
+      std::cout << "Texture " << cooked << " uses " << blockFormatName(format) << ", which this driver can't sample" << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  static void setSampler(const TextureSettings &settings, GLenum target = GL_TEXTURE_2D) {
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, settings.wrap);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, settings.wrap);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, settings.minFilter);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, settings.magFilter);
+  }
+
+  // Textures that can share an array: same cooked format, levels and size, or decoded to RGBA8 at the same size
+  static string layerSignature(const string &path, const TextureSettings &settings) {
+    CompressedImageInfo cooked;
+    if (settings.compressed && cookedInfo(path, cooked))
+      return string(blockFormatName(cooked.format)) + " " + std::to_string(cooked.levelCount) + " "
+        + std::to_string(cooked.width) + "x" + std::to_string(cooked.height);
+
+    int width = 0, height = 0, channels = 0;
+    stbi_info(path.c_str(), &width, &height, &channels);
+    return "decoded " + std::to_string(width) + "x" + std::to_string(height);
+  }
+
+  unsigned int acquireArray(const vector<string> &members, const TextureSettings &settings) {
+    string key = "array";
+    for (const string &member : members)
+      key += ";" + makeKey({ member, settings });
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto found = entries.find(key);
+      if (found != entries.end()) {
+        found->second.references++;
+        stats.hits++;
+        return found->second.id;
+      }
+    }
+
+    Entry built = buildArray(members, settings);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = entries.find(key);
+    if (found != entries.end()) {
+      glDeleteTextures(1, &built.id);
+      found->second.references++;
+      stats.hits++;
+      return found->second.id;
+    }
+    built.references = 1;
+    entries[key] = built;
+    keysById[built.id] = key;
+    stats.misses++;
+    return built.id;
+  }
+
+  static Entry buildArray(const vector<string> &members, const TextureSettings &settings) {
+    Entry entry;
+    glGenTextures(1, &entry.id);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, entry.id);
+    GLsizei layers = (GLsizei)members.size();
+
+    // 1. Cooked layers go up as stored, one call per level for the whole array
+    vector<CompressedImage> cooked(members.size());
+    bool useCooked = settings.compressed;
+    for (unsigned int i = 0; i < members.size() && useCooked; ++i) {
+      useCooked = loadCooked(members[i], cooked[i]) && cooked[i].format == cooked[0].format
+        && cooked[i].levels.size() == cooked[0].levels.size() && cooked[i].width == cooked[0].width && cooked[i].height == cooked[0].height;
+    }
+    if (useCooked) {
+      entry.compressed = cooked[0].format != BlockFormat::RGBA8;
+      GLenum internalFormat = blockFormatGL(cooked[0].format, settings.srgb);
+      unsigned int levels = settings.mipmaps ? (unsigned int)cooked[0].levels.size() : 1;
+      unsigned int width = cooked[0].width;
+      unsigned int height = cooked[0].height;
+      for (unsigned int level = 0; level < levels; ++level) {
+        vector<uint8_t> data;
+        for (const CompressedImage &image : cooked)
+          data.insert(data.end(), image.levels[level].begin(), image.levels[level].end());
+        if (entry.compressed)
+          glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, internalFormat, width, height, layers, 0, (GLsizei)data.size(), data.data());
+        else
+          glTexImage3D(GL_TEXTURE_2D_ARRAY, level, internalFormat, width, height, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+        entry.bytes += data.size();
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+      }
+      glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levels - 1);
+      setSampler(settings, GL_TEXTURE_2D_ARRAY);
+      return entry;
+    }
+
+    // 2. Otherwise decode every layer as RGBA8 and let GL build the mips
+    vector<ImageRequest> decodes;
+    for (const string &member : members)
+      decodes.push_back({ member, 4 });
+    vector<Image> images = ImageLoader::instance().loadAll(decodes);
+    int width = 1, height = 1;
+    for (const Image &image : images) {
+      if (image.valid()) {
+        width = image.width;
+        height = image.height;
+        break;
+      }
+    }
+
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, settings.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8, width, height, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    for (unsigned int i = 0; i < images.size(); ++i) {
+      if (!images[i].valid() || images[i].width != width || images[i].height != height) {
+        std::cout << "Failed to load texture " << images[i].path << std::endl;
+        continue;
+      }
+      glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, images[i].data());
+    }
+    if (settings.mipmaps)
+      glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    setSampler(settings, GL_TEXTURE_2D_ARRAY);
+
+    entry.bytes = (size_t)width * height * 4 * layers;
+    if (settings.mipmaps)
+      entry.bytes = entry.bytes * 4 / 3;
+    return entry;
+  }
+
+  // One upload per stored level; the mips come from the file, not glGenerateMipmap
+  static Entry uploadCooked(const CompressedImage &image, const TextureSettings &settings) {
+    Entry entry;
+    entry.compressed = image.format != BlockFormat::RGBA8;
+    glGenTextures(1, &entry.id);
+    glBindTexture(GL_TEXTURE_2D, entry.id);
+
+    GLenum internalFormat = blockFormatGL(image.format, settings.srgb);
+    unsigned int levels = settings.mipmaps ? (unsigned int)image.levels.size() : 1;
+    unsigned int width = image.width;
+    unsigned int height = image.height;
+    for (unsigned int level = 0; level < levels; ++level) {
+      const vector<uint8_t> &data = image.levels[level];
+      if (entry.compressed)
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, width, height, 0, (GLsizei)data.size(), data.data());
+      else
+        glTexImage2D(GL_TEXTURE_2D, level, internalFormat, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+      entry.bytes += data.size();
+      width = std::max(width / 2, 1u);
+      height = std::max(height / 2, 1u);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    setSampler(settings);
+    return entry;
+  }
+
+  static Entry upload(const Image &image, const TextureSettings &settings) {
+    Entry entry;
+    glGenTextures(1, &entry.id);
+
+    if (!image.valid()) {
+      std::cout << "Failed to load texture " << image.path << std::endl;
+      return entry;
+    }
+
+    GLenum format = GL_RGB;
+    if (image.channels == 1)
+      format = GL_RED;
+    else if (image.channels == 3)
+      format = GL_RGB;
+    else if (image.channels == 4)
+      format = GL_RGBA;
+
+    GLenum internalFormat = format;
+    if (settings.srgb)
+      internalFormat = image.channels == 4 ? GL_SRGB_ALPHA : GL_SRGB;
+
+    // Bind and set the newly created texture
+    glBindTexture(GL_TEXTURE_2D, entry.id);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.data());
+    if (settings.mipmaps)
+      glGenerateMipmap(GL_TEXTURE_2D);
+
+    // set the texture wrapping / filtering options
+    setSampler(settings);
+
+    entry.bytes = (size_t)image.width * image.height * (image.channels == 3 ? 4 : image.channels);
+    if (settings.mipmaps)
+      entry.bytes = entry.bytes * 4 / 3;
+    return entry;
+  }
+};
+
+#endif
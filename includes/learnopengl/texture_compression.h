@@ -0,0 +1,539 @@
+#ifndef TEXTURE_COMPRESSION_H
+#define TEXTURE_COMPRESSION_H
+
+#include <glad/glad.h>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <iostream>
+
+using std::vector;
+using std::string;
+
+// S3TC, BPTC and ETC2 are extensions or newer core on the 3.3 loader, so their enums live here
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#define GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM 0x8E8D
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_R11_EAC 0x9270
+#define GL_COMPRESSED_RG11_EAC 0x9272
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#define GL_COMPRESSED_SRGB8_ETC2 0x9275
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#define GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC 0x9279
+#endif
+
+/*
+* Block compressed textures on disk
+*
+* Cooked textures are KTX2 files written by tools/texture-compressor next to their source image
+* (container2.png -> container2.ktx2). DDS is read as well for textures made by other tools.
+* Every level is stored, so uploading is one glCompressedTexImage2D per level.
+*
+*   BC1   8 bytes / 4x4  opaque colour
+*   BC3  16 bytes / 4x4  colour + smooth alpha
+*   BC4   8 bytes / 4x4  single channel
+*   BC5  16 bytes / 4x4  two channels, e.g. tangent space normal xy
+*   BC7  16 bytes / 4x4  high quality colour or colour + alpha
+*
+* ETC2 / EAC files load too, but are only uploaded where the driver lists them (GL 4.3, ES).
+* RGBA8 is the odd one out: uncompressed, but cooked with its mip chain like the rest.
+* The colour space is picked at upload from TextureSettings::srgb, so files store unorm formats.
+*/
+enum class BlockFormat {
+  BC1,
+  BC3,
+  BC4,
+  BC5,
+  BC7,
+  ETC2_RGB,
+  ETC2_RGBA,
+  EAC_R11,
+  EAC_RG11,
+  RGBA8,
+};
+
+struct CompressedImage {
+  string path;
+  BlockFormat format = BlockFormat::BC1;
+  unsigned int width = 0;
+  unsigned int height = 0;
+  bool bottomUp = false;        // first row is the bottom of the image, as with the stb flip
+  vector<vector<uint8_t>> levels; // level 0 first
+
+  bool valid() const { return !levels.empty(); }
+
+  size_t bytes() const {
+    size_t total = 0;
+    for (const vector<uint8_t> &level : levels)
+      total += level.size();
+    return total;
+  }
+};
+
+inline size_t blockBytes(BlockFormat format) {
+  switch (format) {
+    case BlockFormat::BC1:
+    case BlockFormat::BC4:
+    case BlockFormat::ETC2_RGB:
+    case BlockFormat::EAC_R11:
+      return 8;
+    default:
+      return 16;
+  }
+}
+
+inline size_t compressedLevelBytes(BlockFormat format, unsigned int width, unsigned int height) {
+  if (format == BlockFormat::RGBA8)
+    return (size_t)width * height * 4;
+  return (size_t)((width + 3) / 4) * ((height + 3) / 4) * blockBytes(format);
+}
+
+inline const char *blockFormatName(BlockFormat format) {
+  switch (format) {
+    case BlockFormat::BC1: return "BC1";
+    case BlockFormat::BC3: return "BC3";
+    case BlockFormat::BC4: return "BC4";
+    case BlockFormat::BC5: return "BC5";
+    case BlockFormat::BC7: return "BC7";
+    case BlockFormat::ETC2_RGB: return "ETC2";
+    case BlockFormat::ETC2_RGBA: return "ETC2_EAC";
+    case BlockFormat::EAC_R11: return "EAC_R11";
+    case BlockFormat::EAC_RG11: return "EAC_RG11";
+    case BlockFormat::RGBA8: return "RGBA8";
+  }
+  return "?";
+}
+
+// Single and two channel formats have no sRGB variant, so srgb is ignored for them
+inline GLenum blockFormatGL(BlockFormat format, bool srgb) {
+  switch (format) {
+    case BlockFormat::BC1: return srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case BlockFormat::BC3: return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case BlockFormat::BC4: return GL_COMPRESSED_RED_RGTC1;
+    case BlockFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+    case BlockFormat::BC7: return srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+    case BlockFormat::ETC2_RGB: return srgb ? GL_COMPRESSED_SRGB8_ETC2 : GL_COMPRESSED_RGB8_ETC2;
+    case BlockFormat::ETC2_RGBA: return srgb ? GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC : GL_COMPRESSED_RGBA8_ETC2_EAC;
+    case BlockFormat::EAC_R11: return GL_COMPRESSED_R11_EAC;
+    case BlockFormat::EAC_RG11: return GL_COMPRESSED_RG11_EAC;
+    case BlockFormat::RGBA8: return srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+  }
+  return 0;
+}
+
+namespace ktx2 {
+  const uint8_t IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+  struct Header {
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t layerCount;
+    uint32_t faceCount;
+    uint32_t levelCount;
+    uint32_t supercompressionScheme;
+  };
+
+  // follows the header; split out so the 64 bit fields keep their natural alignment
+  struct Index {
+    uint32_t dfdByteOffset;
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;
+    uint64_t sgdByteLength;
+  };
+
+  struct LevelIndex {
+    uint64_t byteOffset;
+    uint64_t byteLength;
+    uint64_t uncompressedByteLength;
+  };
+
+  // VkFormat values of the unorm variants; the sRGB ones are always one higher
+  inline uint32_t vkFormat(BlockFormat format) {
+    switch (format) {
+      case BlockFormat::BC1: return 131;
+      case BlockFormat::BC3: return 137;
+      case BlockFormat::BC4: return 139;
+      case BlockFormat::BC5: return 141;
+      case BlockFormat::BC7: return 145;
+      case BlockFormat::ETC2_RGB: return 147;
+      case BlockFormat::ETC2_RGBA: return 151;
+      case BlockFormat::EAC_R11: return 153;
+      case BlockFormat::EAC_RG11: return 155;
+      case BlockFormat::RGBA8: return 37;
+    }
+    return 0;
+  }
+
+  inline bool blockFormat(uint32_t vkFormat, BlockFormat &format) {
+    switch (vkFormat) {
+      case 131: case 132: case 133: case 134: format = BlockFormat::BC1; return true;
+      case 137: case 138: format = BlockFormat::BC3; return true;
+      case 139: format = BlockFormat::BC4; return true;
+      case 141: format = BlockFormat::BC5; return true;
+      case 145: case 146: format = BlockFormat::BC7; return true;
+      case 147: case 148: format = BlockFormat::ETC2_RGB; return true;
+      case 151: case 152: format = BlockFormat::ETC2_RGBA; return true;
+      case 153: format = BlockFormat::EAC_R11; return true;
+      case 155: format = BlockFormat::EAC_RG11; return true;
+      case 37: case 43: format = BlockFormat::RGBA8; return true;
+    }
+    return false;
+  }
+
+  // Basic data format descriptor: colour model plus one sample per 64 bit half of the block (per byte for RGBA8)
+  inline vector<uint32_t> dataFormatDescriptor(BlockFormat format) {
+    struct Sample { uint32_t offset; uint32_t length; uint32_t channel; uint32_t upper = 0xffffffffu; };
+    uint32_t model = 0;
+    vector<Sample> samples;
+    switch (format) {
+      case BlockFormat::BC1: model = 128; samples = { { 0, 64, 0 } }; break;
+      case BlockFormat::BC3: model = 130; samples = { { 0, 64, 15 }, { 64, 64, 0 } }; break;
+      case BlockFormat::BC4: model = 131; samples = { { 0, 64, 0 } }; break;
+      case BlockFormat::BC5: model = 132; samples = { { 0, 64, 0 }, { 64, 64, 1 } }; break;
+      case BlockFormat::BC7: model = 134; samples = { { 0, 128, 0 } }; break;
+      case BlockFormat::ETC2_RGB: model = 161; samples = { { 0, 64, 2 } }; break;
+      case BlockFormat::ETC2_RGBA: model = 161; samples = { { 0, 64, 15 }, { 64, 64, 2 } }; break;
+      case BlockFormat::EAC_R11: model = 161; samples = { { 0, 64, 0 } }; break;
+      case BlockFormat::EAC_RG11: model = 161; samples = { { 0, 64, 0 }, { 64, 64, 1 } }; break;
+      case BlockFormat::RGBA8: model = 1; samples = { { 0, 8, 0, 255 }, { 8, 8, 1, 255 }, { 16, 8, 2, 255 }, { 24, 8, 15, 255 } }; break;
+    }
+    bool block = format != BlockFormat::RGBA8;
+
+    uint32_t blockSize = 24 + 16 * (uint32_t)samples.size();
+    vector<uint32_t> words;
+    words.push_back(4 + blockSize);                // dfdTotalSize
+    words.push_back(0);                            // vendorId / descriptorType
+    words.push_back(2 | blockSize << 16);          // versionNumber / descriptorBlockSize
+    words.push_back(model | 1 << 8 | 1 << 16);     // colorModel, BT.709 primaries, linear transfer, flags
+    words.push_back(block ? 3 | 3 << 8 : 0);       // 4x4x1 texel block, or a single texel
+    words.push_back(block ? (uint32_t)blockBytes(format) : 4); // bytesPlane0-3
+    words.push_back(0);                            // bytesPlane4-7
+    for (const Sample &sample : samples) {
+      words.push_back(sample.offset | (sample.length - 1) << 16 | sample.channel << 24);
+      words.push_back(0);
+      words.push_back(0);
+      words.push_back(sample.upper);
+    }
+    return words;
+  }
+}
+
+namespace dds {
+  const uint32_t MAGIC = 0x20534444; // "DDS "
+
+  inline uint32_t fourCC(const char *code) {
+    return (uint32_t)code[0] | (uint32_t)code[1] << 8 | (uint32_t)code[2] << 16 | (uint32_t)code[3] << 24;
+  }
+
+  struct PixelFormat {
+    uint32_t size;
+    uint32_t flags;
+    uint32_t fourCC;
+    uint32_t rgbBitCount;
+    uint32_t masks[4];
+  };
+
+  struct Header {
+    uint32_t size;
+    uint32_t flags;
+    uint32_t height;
+    uint32_t width;
+    uint32_t pitchOrLinearSize;
+    uint32_t depth;
+    uint32_t mipMapCount;
+    uint32_t reserved1[11];
+    PixelFormat pixelFormat;
+    uint32_t caps[4];
+    uint32_t reserved2;
+  };
+
+  struct HeaderDX10 {
+    uint32_t dxgiFormat;
+    uint32_t resourceDimension;
+    uint32_t miscFlag;
+    uint32_t arraySize;
+    uint32_t miscFlags2;
+  };
+
+  inline bool blockFormat(const Header &header, const HeaderDX10 *dx10, BlockFormat &format) {
+    if (dx10) {
+      switch (dx10->dxgiFormat) {
+        case 71: case 72: format = BlockFormat::BC1; return true;
+        case 77: case 78: format = BlockFormat::BC3; return true;
+        case 80: format = BlockFormat::BC4; return true;
+        case 83: format = BlockFormat::BC5; return true;
+        case 98: case 99: format = BlockFormat::BC7; return true;
+      }
+      return false;
+    }
+    uint32_t code = header.pixelFormat.fourCC;
+    if (code == fourCC("DXT1")) { format = BlockFormat::BC1; return true; }
+    if (code == fourCC("DXT5")) { format = BlockFormat::BC3; return true; }
+    if (code == fourCC("ATI1") || code == fourCC("BC4U")) { format = BlockFormat::BC4; return true; }
+    if (code == fourCC("ATI2") || code == fourCC("BC5U")) { format = BlockFormat::BC5; return true; }
+    return false;
+  }
+}
+
+// What a cooked file holds, read from its header without touching the level data
+struct CompressedImageInfo {
+  BlockFormat format = BlockFormat::BC1;
+  unsigned int width = 0;
+  unsigned int height = 0;
+  unsigned int levelCount = 0;
+  bool bottomUp = false;
+};
+
+// Where each level sits in the file, level 0 first
+struct CompressedLevelRange {
+  uint64_t offset;
+  uint64_t length;
+};
+
+inline bool readFileRange(std::ifstream &file, uint64_t offset, void *data, size_t length) {
+  file.seekg((std::streamoff)offset);
+  file.read(reinterpret_cast<char*>(data), length);
+  return (bool)file;
+}
+
+inline uint64_t fileLength(std::ifstream &file) {
+  file.seekg(0, std::ios::end);
+  return (uint64_t)file.tellg();
+}
+
+/*
+* Header, orientation and level index of a KTX2 file. Only plain 2D textures are supported, and
+* every level has to be exactly as big as its dimensions say, as GL reads that many bytes
+*/
+inline bool readKtx2Info(std::ifstream &file, const string &path, CompressedImageInfo &info, vector<CompressedLevelRange> &ranges) {
+  // 1. Identifier and header
+  uint64_t size = fileLength(file);
+  size_t indexOffset = sizeof(ktx2::IDENTIFIER) + sizeof(ktx2::Header) + sizeof(ktx2::Index);
+  uint8_t identifier[sizeof(ktx2::IDENTIFIER)];
+  if (size < indexOffset || !readFileRange(file, 0, identifier, sizeof(identifier))
+      || memcmp(identifier, ktx2::IDENTIFIER, sizeof(ktx2::IDENTIFIER)) != 0) {
+    std::cout << "ERROR::KTX2::NOT_A_KTX2_FILE " << path << std::endl;
+    return false;
+  }
+  ktx2::Header header;
+  ktx2::Index dataIndex;
+  readFileRange(file, sizeof(ktx2::IDENTIFIER), &header, sizeof(header));
+  readFileRange(file, sizeof(ktx2::IDENTIFIER) + sizeof(header), &dataIndex, sizeof(dataIndex));
+  if (!ktx2::blockFormat(header.vkFormat, info.format) || header.supercompressionScheme != 0
+      || header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1) {
+    std::cout << "ERROR::KTX2::UNSUPPORTED_TEXTURE " << path << std::endl;
+    return false;
+  }
+  info.width = header.pixelWidth;
+  info.height = header.pixelHeight;
+  info.levelCount = std::max(header.levelCount, 1u);
+
+  // 2. Orientation lives in the key/value data, "rd" (top down) is the default
+  info.bottomUp = false;
+  if ((uint64_t)dataIndex.kvdByteOffset + dataIndex.kvdByteLength <= size) {
+    vector<uint8_t> kvd(dataIndex.kvdByteLength);
+    readFileRange(file, dataIndex.kvdByteOffset, kvd.data(), kvd.size());
+    size_t position = 0;
+    while (position + 4 <= kvd.size()) {
+      uint32_t length;
+      memcpy(&length, kvd.data() + position, 4);
+      const char *entry = reinterpret_cast<const char*>(kvd.data() + position + 4);
+      if (length > 16 && position + 4 + length <= kvd.size() && strncmp(entry, "KTXorientation", length) == 0)
+        info.bottomUp = entry[16] == 'u';
+      position += 4 + ((length + 3) & ~3u);
+    }
+  }
+
+  // 3. Level index
+  if (indexOffset + info.levelCount * sizeof(ktx2::LevelIndex) > size) {
+    std::cout << "ERROR::KTX2::TRUNCATED " << path << std::endl;
+    return false;
+  }
+  ranges.resize(info.levelCount);
+  for (unsigned int level = 0; level < info.levelCount; ++level) {
+    ktx2::LevelIndex index;
+    readFileRange(file, indexOffset + level * sizeof(index), &index, sizeof(index));
+    if (index.byteOffset + index.byteLength > size) {
+      std::cout << "ERROR::KTX2::TRUNCATED " << path << std::endl;
+      return false;
+    }
+    // a stale or hand edited file can list fewer bytes than the level needs, and GL would read past them
+    unsigned int width = std::max(info.width >> level, 1u);
+    unsigned int height = std::max(info.height >> level, 1u);
+    if (index.byteLength != compressedLevelBytes(info.format, width, height)) {
+      std::cout << "ERROR::KTX2::BAD_LEVEL_SIZE " << path << " level " << level << std::endl;
+      return false;
+    }
+    ranges[level] = { index.byteOffset, index.byteLength };
+  }
+  return (bool)file;
+}
+
+/*
+* DDS header. Levels follow each other, largest first; a file cut short keeps the levels it
+* still holds in full
+*/
+inline bool readDdsInfo(std::ifstream &file, const string &path, CompressedImageInfo &info, vector<CompressedLevelRange> &ranges) {
+  uint64_t size = fileLength(file);
+  uint32_t magic = 0;
+  dds::Header header;
+  if (size < 4 + sizeof(header) || !readFileRange(file, 0, &magic, 4) || magic != dds::MAGIC) {
+    std::cout << "ERROR::DDS::NOT_A_DDS_FILE " << path << std::endl;
+    return false;
+  }
+  readFileRange(file, 4, &header, sizeof(header));
+
+  uint64_t offset = 4 + sizeof(header);
+  dds::HeaderDX10 dx10;
+  bool hasDX10 = header.pixelFormat.fourCC == dds::fourCC("DX10");
+  if (hasDX10) {
+    if (size < offset + sizeof(dx10))
+      return false;
+    readFileRange(file, offset, &dx10, sizeof(dx10));
+    offset += sizeof(dx10);
+  }
+  if (!dds::blockFormat(header, hasDX10 ? &dx10 : nullptr, info.format)) {
+    std::cout << "ERROR::DDS::UNSUPPORTED_FORMAT " << path << std::endl;
+    return false;
+  }
+
+  info.width = header.width;
+  info.height = header.height;
+  info.bottomUp = false;
+  unsigned int levelCount = std::max(header.mipMapCount, 1u);
+  unsigned int width = info.width;
+  unsigned int height = info.height;
+  ranges.clear();
+  for (unsigned int level = 0; level < levelCount; ++level) {
+    uint64_t length = compressedLevelBytes(info.format, width, height);
+    if (offset + length > size)
+      break;
+    ranges.push_back({ offset, length });
+    offset += length;
+    width = std::max(width / 2, 1u);
+    height = std::max(height / 2, 1u);
+  }
+  info.levelCount = (unsigned int)ranges.size();
+  return info.levelCount > 0 && (bool)file;
+}
+
+inline bool saveKtx2(const string &path, const CompressedImage &image) {
+  // 1. Layout: header, level index, DFD, key/value data, then the levels smallest first
+  vector<uint32_t> dfd = ktx2::dataFormatDescriptor(image.format);
+  const char orientation[] = "KTXorientation\0rd";
+  vector<uint8_t> kvd(4 + sizeof(orientation));
+  uint32_t kvLength = (uint32_t)sizeof(orientation);
+  memcpy(kvd.data(), &kvLength, 4);
+  memcpy(kvd.data() + 4, orientation, sizeof(orientation));
+  kvd[4 + 16] = image.bottomUp ? 'u' : 'd';
+  kvd.resize((kvd.size() + 3) & ~(size_t)3);
+
+  ktx2::Header header = {};
+  header.vkFormat = ktx2::vkFormat(image.format);
+  header.typeSize = 1;
+  header.pixelWidth = image.width;
+  header.pixelHeight = image.height;
+  header.faceCount = 1;
+  header.levelCount = (uint32_t)image.levels.size();
+
+  ktx2::Index dataIndex = {};
+  dataIndex.dfdByteOffset = (uint32_t)(sizeof(ktx2::IDENTIFIER) + sizeof(header) + sizeof(dataIndex) + image.levels.size() * sizeof(ktx2::LevelIndex));
+  dataIndex.dfdByteLength = (uint32_t)(dfd.size() * 4);
+  dataIndex.kvdByteOffset = dataIndex.dfdByteOffset + dataIndex.dfdByteLength;
+  dataIndex.kvdByteLength = (uint32_t)kvd.size();
+
+  vector<ktx2::LevelIndex> index(image.levels.size());
+  uint64_t offset = dataIndex.kvdByteOffset + dataIndex.kvdByteLength;
+  for (size_t level = image.levels.size(); level-- > 0;) {
+    offset = (offset + 15) & ~(uint64_t)15;
+    index[level] = { offset, image.levels[level].size(), image.levels[level].size() };
+    offset += image.levels[level].size();
+  }
+
+  // 2. Write it out
+  std::ofstream file(path, std::ios::binary);
+  if (!file) {
+    std::cout << "ERROR::KTX2::FAILED_TO_WRITE " << path << std::endl;
+    return false;
+  }
+  file.write(reinterpret_cast<const char*>(ktx2::IDENTIFIER), sizeof(ktx2::IDENTIFIER));
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(&dataIndex), sizeof(dataIndex));
+  file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(ktx2::LevelIndex));
+  file.write(reinterpret_cast<const char*>(dfd.data()), dfd.size() * 4);
+  file.write(reinterpret_cast<const char*>(kvd.data()), kvd.size());
+  uint64_t written = dataIndex.kvdByteOffset + dataIndex.kvdByteLength;
+  for (size_t level = image.levels.size(); level-- > 0;) {
+    static const char padding[16] = {};
+    file.write(padding, index[level].byteOffset - written);
+    file.write(reinterpret_cast<const char*>(image.levels[level].data()), image.levels[level].size());
+    written = index[level].byteOffset + image.levels[level].size();
+  }
+  return (bool)file;
+}
+
+inline bool hasExtension(const string &path, const string &extension) {
+  return path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+inline bool isCompressedTexturePath(const string &path) {
+  return hasExtension(path, ".ktx2") || hasExtension(path, ".dds");
+}
+
+inline bool readCompressedInfo(std::ifstream &file, const string &path, CompressedImageInfo &info, vector<CompressedLevelRange> &ranges) {
+  if (hasExtension(path, ".dds"))
+    return readDdsInfo(file, path, info, ranges);
+  return readKtx2Info(file, path, info, ranges);
+}
+
+// Reads just the header and level index, for when the texture isn't going to be uploaded yet
+inline bool loadCompressedInfo(const string &path, CompressedImageInfo &info) {
+  std::ifstream file(path, std::ios::binary);
+  vector<CompressedLevelRange> ranges;
+  return file && readCompressedInfo(file, path, info, ranges);
+}
+
+// A .ktx2 or .dds file, each level read straight from its place in the file
+inline bool loadCompressedImage(const string &path, CompressedImage &image) {
+  std::ifstream file(path, std::ios::binary);
+  CompressedImageInfo info;
+  vector<CompressedLevelRange> ranges;
+  if (!file || !readCompressedInfo(file, path, info, ranges))
+    return false;
+
+  image.path = path;
+  image.format = info.format;
+  image.width = info.width;
+  image.height = info.height;
+  image.bottomUp = info.bottomUp;
+  image.levels.resize(ranges.size());
+  for (size_t level = 0; level < ranges.size(); ++level) {
+    image.levels[level].resize((size_t)ranges[level].length);
+    if (!readFileRange(file, ranges[level].offset, image.levels[level].data(), image.levels[level].size())) {
+      std::cout << "ERROR::COMPRESSED_TEXTURE::TRUNCATED " << path << std::endl;
+      image.levels.clear();
+      return false;
+    }
+  }
+  return image.valid();
+}
+
+#endif
@@ -0,0 +1,222 @@
+#ifndef UNIFORM_BUFFER_H
+#define UNIFORM_BUFFER_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include "learnopengl/shader.h"
+
+using std::vector;
+
+// ARB_buffer_storage (core in 4.4), glad is only generated for 3.3
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+typedef void (APIENTRYP PFNBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+
+/*
+* std140 uniform blocks
+*
+* A block is a plain struct laid out exactly like its GLSL std140 declaration, with a NAME
+* matching the block name. Shader binds every block it reflects to one binding point per
+* name, so a block written once is seen by every program that declares it.
+*
+*   struct LightsBlock {
+*     static constexpr const char *NAME = "Lights";
+*     alignas(16) glm::vec3 position;   // vec3 position;
+*     float radius;                     // float radius;
+*   };
+*   STD140_OFFSET(LightsBlock, radius, 12);
+*
+* std140 rules worth remembering: vec3 and vec4 align to 16 (a float may follow a vec3),
+* every array element and struct is padded to 16 and mat4 is four vec4 columns. The offsets
+* are checked when compiling, so a block that drifts from its GLSL fails to build.
+*/
+#define STD140_OFFSET(Block, member, offset) \
+  static_assert(offsetof(Block, member) == (offset), #Block "::" #member " is not at its std140 offset")
+#define STD140_SIZE(Block, size) \
+  static_assert(sizeof(Block) == (size) && sizeof(Block) % 16 == 0, #Block " does not have its std140 size")
+
+// Camera block shared by every program: layout (std140) uniform Camera { mat4 view; mat4 projection; vec4 position; };
+struct CameraBlock {
+  static constexpr const char *NAME = "Camera";
+  glm::mat4 view;
+  glm::mat4 projection;
+  glm::vec4 position; // w unused
+};
+STD140_OFFSET(CameraBlock, view, 0);
+STD140_OFFSET(CameraBlock, projection, 64);
+STD140_OFFSET(CameraBlock, position, 128);
+STD140_SIZE(CameraBlock, 144);
+
+/*
+* Ring of uniform data written once per frame
+*
+* The buffer is split into one region per frame in flight (three by default). beginFrame()
+* waits on the fence of the region it is about to reuse, which the GPU normally signalled
+* long ago, and endFrame() fences it again, so the CPU never writes over data a frame
+* still being drawn reads.
+*
+* With ARB_buffer_storage the whole buffer stays persistently and coherently mapped and a
+* write is a memcpy. Without it every write maps its range unsynchronized, which the fences
+* make just as safe.
+*/
+class UniformRing {
+public:
+  struct Stats {
+    unsigned int frames = 0;
+    unsigned int stalls = 0; // beginFrame() calls that had to wait for the GPU
+    size_t peakBytes = 0;
+  };
+
+  UniformRing(size_t frameBytes, unsigned int frames = 3) : frames(frames) {
+    GLint offsetAlignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    alignment = (size_t)std::max(offsetAlignment, 1);
+    this->frameBytes = alignUp(frameBytes);
+    fences.assign(frames, nullptr);
+
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    GLsizeiptr size = (GLsizeiptr)(this->frameBytes * frames);
+    PFNBUFFERSTORAGEPROC bufferStorage = nullptr;
+    if (glfwExtensionSupported("GL_ARB_buffer_storage"))
+      bufferStorage = (PFNBUFFERSTORAGEPROC)glfwGetProcAddress("glBufferStorage");
+    if (bufferStorage) {
+      GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+      bufferStorage(GL_UNIFORM_BUFFER, size, nullptr, flags);
+      mapped = static_cast<uint8_t*>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, size, flags));
+    }
+    if (!mapped)
+      glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  }
+
+  // The buffer has a single owner, so the ring can not be copied
+  UniformRing(const UniformRing&) = delete;
+  UniformRing &operator=(const UniformRing&) = delete;
+
+  ~UniformRing() {
+    if (!glfwGetCurrentContext())
+      return;
+    for (GLsync fence : fences)
+      if (fence)
+        glDeleteSync(fence);
+    if (mapped) {
+      glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+      glUnmapBuffer(GL_UNIFORM_BUFFER);
+      glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &buffer);
+  }
+
+  void beginFrame() {
+    frame = (frame + 1) % frames;
+    cursor = 0;
+    stats.frames++;
+    GLsync fence = fences[frame];
+    if (!fence)
+      return;
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+      stats.stalls++;
+      // flush once so the fence is guaranteed to be signalled eventually
+      do {
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+      } while (result == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(fence);
+    fences[frame] = nullptr;
+  }
+
+  // After the last draw that reads this frame's blocks
+  void endFrame() {
+    stats.peakBytes = std::max(stats.peakBytes, cursor);
+    fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+
+  // Copies the block into this frame's region and binds it for every program declaring it
+  template <typename Block>
+  void write(const Block &block) {
+    write(Block::NAME, &block, sizeof(Block));
+  }
+
+  // Blocks sized at runtime, e.g. an array of std140 structs sized by a define
+  template <typename Element>
+  void writeArray(const char *name, const vector<Element> &elements) {
+    static_assert(sizeof(Element) % 16 == 0, "std140 array elements are padded to 16 bytes");
+    write(name, elements.data(), elements.size() * sizeof(Element));
+  }
+
+  void write(const char *name, const void *data, size_t bytes) {
+    if (cursor + bytes > frameBytes) {
+      std::cout << "ERROR::UNIFORM_RING::FRAME_FULL " << name << std::endl;
+      return;
+    }
+    size_t offset = frame * frameBytes + cursor;
+    if (mapped) {
+      std::memcpy(mapped + offset, data, bytes);
+    } else {
+      glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+      GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+      void *target = glMapBufferRange(GL_UNIFORM_BUFFER, (GLintptr)offset, (GLsizeiptr)bytes, flags);
+      if (target) {
+        std::memcpy(target, data, bytes);
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+      }
+      glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding(name), buffer, (GLintptr)offset, (GLsizeiptr)bytes);
+    cursor = alignUp(cursor + bytes);
+  }
+
+  bool persistent() const {
+    return mapped != nullptr;
+  }
+
+  Stats getStats() const {
+    return stats;
+  }
+
+  void printStats() const {
+    std::cout << "Uniform ring: " << frames << " x " << frameBytes / 1024 << " KiB " << (mapped ? "persistent" : "mapped per write")
+      << ", peak " << stats.peakBytes << " bytes a frame, " << stats.stalls << " stalls in " << stats.frames << " frames" << std::endl;
+  }
+
+private:
+  unsigned int buffer = 0;
+  unsigned int frames;
+  unsigned int frame = 0;
+  size_t frameBytes = 0;
+  size_t alignment = 256;
+  size_t cursor = 0;
+  uint8_t *mapped = nullptr;
+  vector<GLsync> fences;
+  vector<std::pair<std::string, GLuint>> bindings; // block names written so far
+  Stats stats;
+
+  // Compared in place, so a steady frame finds its blocks without building a string
+  GLuint binding(const char *name) {
+    for (const auto &[block, point] : bindings)
+      if (block == name)
+        return point;
+    GLuint point = Shader::uniformBlockBinding(name);
+    bindings.push_back({ name, point });
+    return point;
+  }
+
+  size_t alignUp(size_t bytes) const {
+    return (bytes + alignment - 1) / alignment * alignment;
+  }
+};
+
+#endif
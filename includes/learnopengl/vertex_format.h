@@ -0,0 +1,179 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+using std::vector;
+using glm::vec4;
+using glm::vec3;
+using glm::vec2;
+
+struct Vertex {
+  vec3 Position;
+  vec3 Normal;
+  vec2 TexCoords;
+  vec4 Tangent; // xyz tangent, w bitangent sign (+1 / -1)
+};
+
+/*
+* GPU side vertex layouts
+*
+* Float uploads position, normal and uv as floats (32 bytes) and leaves the tangent on the CPU.
+* FloatTangent uploads Vertex as is (48 bytes), for float shaders that normal map.
+* Packed squeezes all of it into 20 bytes:
+*
+*   location 0  position  unorm16 x4  quantized against the mesh bounds, w = bitangent sign
+*   location 1  normal    snorm16 x2  octahedral
+*   location 2  uv        half x2
+*   location 7  tangent   snorm16 x2  octahedral
+*
+* The tangent lives at location 7 so the instanced mat4 at 3-6 (asteroid field) still fits.
+* Packed shaders rebuild the position with the positionOffset / positionScale uniforms,
+* which Mesh::setMaterial sets, and decode the normal with octDecode().
+*/
+enum class VertexFormat {
+  Float,
+  FloatTangent,
+  Packed,
+};
+
+struct FloatVertex {
+  vec3 Position;
+  vec3 Normal;
+  vec2 TexCoords;
+};
+
+static_assert(sizeof(FloatVertex) == 32, "FloatVertex must stay tightly packed");
+
+struct PackedVertex {
+  uint16_t position[4];
+  int16_t normal[2];
+  uint16_t texCoords[2];
+  int16_t tangent[2];
+};
+
+static_assert(sizeof(PackedVertex) == 20, "PackedVertex must stay tightly packed");
+
+const unsigned int TANGENT_ATTRIBUTE = 7;
+
+inline size_t vertexStride(VertexFormat format) {
+  switch (format) {
+    case VertexFormat::Float: return sizeof(FloatVertex);
+    case VertexFormat::FloatTangent: return sizeof(Vertex);
+    case VertexFormat::Packed: return sizeof(PackedVertex);
+  }
+  return sizeof(Vertex);
+}
+
+// Maps a unit vector onto the octahedron, then unfolds the lower half onto the square [-1, 1]^2
+inline vec2 octEncode(vec3 n) {
+  float sum = glm::abs(n.x) + glm::abs(n.y) + glm::abs(n.z);
+  if (sum == 0.0f)
+    return vec2(0.0f);
+  n /= sum;
+  if (n.z >= 0.0f)
+    return vec2(n.x, n.y);
+  vec2 folded = vec2(1.0f - glm::abs(n.y), 1.0f - glm::abs(n.x));
+  return vec2(n.x >= 0.0f ? folded.x : -folded.x, n.y >= 0.0f ? folded.y : -folded.y);
+}
+
+inline int16_t packSnorm16(float value) {
+  return (int16_t)glm::round(glm::clamp(value, -1.0f, 1.0f) * 32767.0f);
+}
+
+inline uint16_t packUnorm16(float value) {
+  return (uint16_t)glm::round(glm::clamp(value, 0.0f, 1.0f) * 65535.0f);
+}
+
+inline void computeBounds(const Vertex *vertices, unsigned int count, vec3 &boundsMin, vec3 &boundsMax) {
+  boundsMin = vec3(0.0f);
+  boundsMax = vec3(0.0f);
+  if (count == 0)
+    return;
+  boundsMin = boundsMax = vertices[0].Position;
+  for (unsigned int i = 1; i < count; ++i) {
+    boundsMin = glm::min(boundsMin, vertices[i].Position);
+    boundsMax = glm::max(boundsMax, vertices[i].Position);
+  }
+}
+
+// Scale that maps unorm16 [0, 1] back onto the bounds; flat axes get 1 to avoid dividing by zero
+inline vec3 quantizationScale(vec3 boundsMin, vec3 boundsMax) {
+  vec3 extent = boundsMax - boundsMin;
+  return vec3(extent.x > 0.0f ? extent.x : 1.0f, extent.y > 0.0f ? extent.y : 1.0f, extent.z > 0.0f ? extent.z : 1.0f);
+}
+
+inline vector<PackedVertex> packVertices(const Vertex *vertices, unsigned int count, vec3 boundsMin, vec3 boundsMax) {
+  vec3 scale = quantizationScale(boundsMin, boundsMax);
+  vector<PackedVertex> packed(count);
+  for (unsigned int i = 0; i < count; ++i) {
+    const Vertex &vertex = vertices[i];
+    PackedVertex &out = packed[i];
+
+    vec3 position = (vertex.Position - boundsMin) / scale;
+    out.position[0] = packUnorm16(position.x);
+    out.position[1] = packUnorm16(position.y);
+    out.position[2] = packUnorm16(position.z);
+    out.position[3] = vertex.Tangent.w < 0.0f ? 0 : 65535;
+
+    vec2 normal = octEncode(vertex.Normal);
+    out.normal[0] = packSnorm16(normal.x);
+    out.normal[1] = packSnorm16(normal.y);
+
+    out.texCoords[0] = glm::packHalf1x16(vertex.TexCoords.x);
+    out.texCoords[1] = glm::packHalf1x16(vertex.TexCoords.y);
+
+    vec2 tangent = octEncode(vec3(vertex.Tangent));
+    out.tangent[0] = packSnorm16(tangent.x);
+    out.tangent[1] = packSnorm16(tangent.y);
+  }
+  return packed;
+}
+
+inline vector<FloatVertex> dropTangents(const Vertex *vertices, unsigned int count) {
+  vector<FloatVertex> stripped(count);
+  for (unsigned int i = 0; i < count; ++i)
+    stripped[i] = { vertices[i].Position, vertices[i].Normal, vertices[i].TexCoords };
+  return stripped;
+}
+
+// Describes the layout of the bound GL_ARRAY_BUFFER to the bound VAO
+inline void setupVertexAttributes(VertexFormat format) {
+  if (format == VertexFormat::Packed) {
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
+
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, texCoords));
+
+    glEnableVertexAttribArray(TANGENT_ATTRIBUTE);
+    glVertexAttribPointer(TANGENT_ATTRIBUTE, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, tangent));
+    return;
+  }
+
+  // Vertex and FloatVertex share the first 32 bytes, only the stride differs
+  GLsizei stride = (GLsizei)vertexStride(format);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+
+  glEnableVertexAttribArray(1);
+  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, Normal));
+
+  glEnableVertexAttribArray(2);
+  glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, TexCoords));
+
+  if (format == VertexFormat::FloatTangent) {
+    glEnableVertexAttribArray(TANGENT_ATTRIBUTE);
+    glVertexAttribPointer(TANGENT_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, Tangent));
+  }
+}
+
+#endif
@@ -0,0 +1,71 @@
+#include <learnopengl/brdf_lut.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+
+/*
+* Offline BRDF LUT generator
+*
+*   brdf-lut-generator [--size texels] [--samples count] [output]
+*
+* Integrates the split sum BRDF LUT on every core and writes it as a C++ table, by default over
+* includes/learnopengl/brdf_lut_table.h which brdf_lut.h embeds. Run it again and rebuild after
+* changing the integration in brdf_lut.h.
+*/
+using std::string;
+
+struct Options {
+  unsigned int size = 64;
+  unsigned int samples = 1024;
+  string output = string(INCLUDES_DIR) + "/learnopengl/brdf_lut_table.h";
+};
+
+bool parseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; ++i) {
+    string argument = argv[i];
+    if (argument == "--size" && i + 1 < argc)
+      options.size = (unsigned int)std::stoul(argv[++i]);
+    else if (argument == "--samples" && i + 1 < argc)
+      options.samples = (unsigned int)std::stoul(argv[++i]);
+    else if (argument.rfind("--", 0) == 0) {
+      std::cout << "Usage: brdf-lut-generator [--size texels] [--samples count] [output]" << std::endl;
+      return false;
+    } else
+      options.output = argument;
+  }
+  return options.size > 0 && options.samples > 0;
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options))
+    return 1;
+
+  auto started = std::chrono::steady_clock::now();
+  vector<uint16_t> table = buildBrdfLut(options.size, options.samples);
+
+  std::ofstream out(options.output, std::ios::trunc);
+  if (!out) {
+    std::cout << "ERROR::BRDF_LUT_GENERATOR::FAILED_TO_WRITE " << options.output << std::endl;
+    return 1;
+  }
+  out << "#ifndef BRDF_LUT_TABLE_H\n#define BRDF_LUT_TABLE_H\n\n#include <cstdint>\n\n"
+      << "// Generated by tools/brdf-lut-generator, do not edit: split sum BRDF (scale, bias) as 16 bit unorm\n"
+      << "inline constexpr unsigned int BRDF_LUT_SIZE = " << options.size << ";\n"
+      << "inline constexpr unsigned int BRDF_LUT_SAMPLES = " << options.samples << ";\n"
+      << "inline constexpr uint16_t BRDF_LUT[" << table.size() << "] = {\n";
+  for (size_t i = 0; i < table.size(); ++i) {
+    out << (i % 16 == 0 ? "  " : " ") << table[i] << ",";
+    if (i % 16 == 15 || i + 1 == table.size())
+      out << "\n";
+  }
+  out << "};\n\n#endif\n";
+  out.close();
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+  std::cout << "Wrote " << options.size << "x" << options.size << " BRDF LUT (" << options.samples << " samples, "
+    << table.size() * sizeof(uint16_t) / 1024 << " KiB) to " << options.output << " in " << seconds << "s" << std::endl;
+  return 0;
+}
@@ -0,0 +1,292 @@
+#include <learnopengl/block_encoder.h>
+#include <learnopengl/mip_builder.h>
+#include <learnopengl/image_loader.h>
+#include <stbi_image.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <iostream>
+#include <filesystem>
+
+/*
+* Offline texture compressor
+*
+*   texture-compressor [--bc7] [--bc5-normals] [--uncompressed] [--box] [--linear]
+*                      [--alpha-cutoff value] [--flip] [--force] [directories or files...]
+*
+* Cooks every image it finds (resources/textures and resources/objects by default) into a block
+* compressed .ktx2 next to the source, which TextureCache then uploads instead of decoding it.
+* Files whose .ktx2 is newer than the source are skipped unless --force is given.
+*
+*   single channel      BC4
+*   normal maps         BC7, or BC5 with --bc5-normals (z is dropped, the shader has to rebuild it)
+*   colour with alpha   BC3, or BC7 with --bc7
+*   opaque colour       BC1, or BC7 with --bc7
+*
+* --uncompressed stores RGBA8 instead, so only the mip chain is cooked.
+*
+* Every file gets a full mip chain from mip_builder.h (Kaiser, or 2x2 box with --box). Colour
+* textures are filtered in linear light unless --linear is given, normal maps are renormalised and
+* alpha tested textures keep their coverage at --alpha-cutoff (0.2, as in blend.glsl).
+*
+* --flip cooks for examples that call ImageLoader::setFlipVerticallyOnLoad(true).
+* Blocks are encoded on every core; the PSNR of the top level is reported per file.
+*/
+namespace fs = std::filesystem;
+
+struct Options {
+  bool bc7 = false;
+  bool bc5Normals = false;
+  bool flip = false;
+  bool force = false;
+  bool uncompressed = false;
+  bool box = false;
+  bool linear = false;
+  float alphaCutoff = 0.2f;
+  vector<fs::path> inputs;
+};
+
+struct Job {
+  fs::path source;
+  fs::path output;
+  BlockFormat format;
+  Image image;
+  vector<vector<uint8_t>> mips; // RGBA8, level 0 first
+  CompressedImage result;
+  double psnr = 0.0;
+};
+
+struct WorkItem {
+  unsigned int job;
+  unsigned int level;
+  unsigned int firstRow;
+  unsigned int lastRow;
+};
+
+const unsigned int ROWS_PER_ITEM = 8;
+
+bool isSourceImage(const fs::path &path) {
+  string extension = path.extension().string();
+  for (char &c : extension)
+    c = (char)tolower(c);
+  return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp";
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; ++i) {
+    string argument = argv[i];
+    if (argument == "--bc7")
+      options.bc7 = true;
+    else if (argument == "--bc5-normals")
+      options.bc5Normals = true;
+    else if (argument == "--flip")
+      options.flip = true;
+    else if (argument == "--force")
+      options.force = true;
+    else if (argument == "--uncompressed")
+      options.uncompressed = true;
+    else if (argument == "--box")
+      options.box = true;
+    else if (argument == "--linear")
+      options.linear = true;
+    else if (argument == "--alpha-cutoff" && i + 1 < argc)
+      options.alphaCutoff = std::stof(argv[++i]);
+    else if (argument.rfind("--", 0) == 0) {
+      std::cout << "Usage: texture-compressor [--bc7] [--bc5-normals] [--uncompressed] [--box] [--linear]"
+        << " [--alpha-cutoff value] [--flip] [--force] [paths...]" << std::endl;
+      return false;
+    } else
+      options.inputs.push_back(argument);
+  }
+  if (options.inputs.empty()) {
+    options.inputs.push_back(fs::path(RESOURCES_DIR) / "textures");
+    options.inputs.push_back(fs::path(RESOURCES_DIR) / "objects");
+  }
+  return true;
+}
+
+vector<fs::path> findSources(const Options &options) {
+  vector<fs::path> sources;
+  for (const fs::path &input : options.inputs) {
+    if (fs::is_regular_file(input)) {
+      sources.push_back(input);
+      continue;
+    }
+    if (!fs::is_directory(input)) {
+      std::cout << "ERROR::TEXTURE_COMPRESSOR::NOT_FOUND " << input.string() << std::endl;
+      continue;
+    }
+    for (const fs::directory_entry &entry : fs::recursive_directory_iterator(input))
+      if (entry.is_regular_file() && isSourceImage(entry.path()))
+        sources.push_back(entry.path());
+  }
+
+  // Skip sources whose cooked file is still up to date
+  vector<fs::path> stale;
+  for (const fs::path &source : sources) {
+    fs::path output = fs::path(source).replace_extension(".ktx2");
+    if (!options.force && fs::exists(output) && fs::last_write_time(output) >= fs::last_write_time(source))
+      continue;
+    stale.push_back(source);
+  }
+  return stale;
+}
+
+BlockFormat chooseFormat(const Options &options, const fs::path &source, int channels, const Image &image) {
+  if (options.uncompressed)
+    return BlockFormat::RGBA8;
+  if (channels == 1)
+    return BlockFormat::BC4;
+  if (source.filename().string().find("normal") != string::npos)
+    return options.bc5Normals ? BlockFormat::BC5 : BlockFormat::BC7;
+
+  bool alpha = false;
+  const uint8_t *pixels = image.data();
+  for (size_t i = 0; i < (size_t)image.width * image.height && !alpha; ++i)
+    alpha = pixels[i * 4 + 3] != 255;
+  if (options.bc7)
+    return BlockFormat::BC7;
+  return alpha ? BlockFormat::BC3 : BlockFormat::BC1;
+}
+
+// Colour textures are filtered in linear light; data maps (and anything with --linear) as they are
+bool isColourTexture(const Options &options, const fs::path &source, int channels) {
+  if (options.linear || channels == 1)
+    return false;
+  string name = source.filename().string();
+  for (const char *data : { "normal", "specular", "roughness", "metallic", "ao", "disp", "height", "mask" })
+    if (name.find(data) != string::npos)
+      return false;
+  return true;
+}
+
+// Mostly fully opaque or fully transparent texels means the alpha is for testing, not blending
+bool isAlphaTested(const Image &image) {
+  size_t partial = 0;
+  size_t transparent = 0;
+  size_t texels = (size_t)image.width * image.height;
+  const uint8_t *pixels = image.data();
+  for (size_t i = 0; i < texels; ++i) {
+    uint8_t alpha = pixels[i * 4 + 3];
+    transparent += alpha < 16 ? 1 : 0;
+    partial += alpha >= 16 && alpha < 240 ? 1 : 0;
+  }
+  return transparent > 0 && partial * 10 < texels;
+}
+
+MipSettings mipSettings(const Options &options, const fs::path &source, int channels, const Image &image) {
+  MipSettings settings;
+  settings.filter = options.box ? MipFilter::Box : MipFilter::Kaiser;
+  settings.normalMap = source.filename().string().find("normal") != string::npos;
+  settings.srgb = isColourTexture(options, source, channels);
+  if (channels == 4 && isAlphaTested(image))
+    settings.alphaCutoff = options.alphaCutoff;
+  return settings;
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options))
+    return 1;
+
+  auto started = std::chrono::steady_clock::now();
+
+  // 1. Decode every stale source on the image loader pool
+  vector<fs::path> sources = findSources(options);
+  if (sources.empty()) {
+    std::cout << "All textures are up to date" << std::endl;
+    return 0;
+  }
+  vector<ImageRequest> requests;
+  for (const fs::path &source : sources)
+    requests.push_back({ source.string(), 4, false, options.flip ? 1 : 0 });
+  vector<Image> images = ImageLoader::instance().loadAll(requests);
+
+  // 2. Pick formats and build every mip chain, one texture per core
+  vector<Job> jobs;
+  vector<MipSettings> settings;
+  for (unsigned int i = 0; i < sources.size(); ++i) {
+    int width, height, channels;
+    if (!images[i].valid() || !stbi_info(sources[i].string().c_str(), &width, &height, &channels)) {
+      std::cout << "ERROR::TEXTURE_COMPRESSOR::FAILED_TO_LOAD " << sources[i].string() << std::endl;
+      continue;
+    }
+
+    Job job;
+    job.source = sources[i];
+    job.output = fs::path(sources[i]).replace_extension(".ktx2");
+    job.format = chooseFormat(options, sources[i], channels, images[i]);
+    job.image = std::move(images[i]);
+    job.result.format = job.format;
+    job.result.width = job.image.width;
+    job.result.height = job.image.height;
+    job.result.bottomUp = options.flip;
+    settings.push_back(mipSettings(options, sources[i], channels, job.image));
+    jobs.push_back(std::move(job));
+  }
+  ImageLoader &pool = ImageLoader::instance();
+  unsigned int threadCount = pool.workerCount() + 1; // the workers and this thread
+  pool.parallelFor(jobs.size(), [&](size_t i) {
+    Job &job = jobs[i];
+    job.mips = buildMipChain(job.image.data(), job.image.width, job.image.height, settings[i]);
+    job.image.release();
+  });
+
+  // 3. Split every level into block row ranges and encode them on every core
+  vector<WorkItem> items;
+  for (unsigned int i = 0; i < jobs.size(); ++i) {
+    Job &job = jobs[i];
+    if (job.format == BlockFormat::RGBA8) {
+      job.result.levels = job.mips;
+      continue;
+    }
+    unsigned int levelWidth = job.result.width;
+    unsigned int levelHeight = job.result.height;
+    for (unsigned int level = 0; level < job.mips.size(); ++level) {
+      job.result.levels.emplace_back(compressedLevelBytes(job.format, levelWidth, levelHeight));
+      unsigned int rows = (levelHeight + 3) / 4;
+      for (unsigned int row = 0; row < rows; row += ROWS_PER_ITEM)
+        items.push_back({ i, level, row, std::min(row + ROWS_PER_ITEM, rows) });
+      levelWidth = std::max(levelWidth / 2, 1u);
+      levelHeight = std::max(levelHeight / 2, 1u);
+    }
+  }
+  pool.parallelFor(items.size(), [&](size_t i) {
+    const WorkItem &item = items[i];
+    Job &job = jobs[item.job];
+    unsigned int width = std::max(job.result.width >> item.level, 1u);
+    unsigned int height = std::max(job.result.height >> item.level, 1u);
+    encodeBlockRows(job.format, job.mips[item.level].data(), width, height, item.firstRow, item.lastRow, job.result.levels[item.level].data());
+  });
+
+  // 4. Write the files and report size and quality
+  size_t totalBefore = 0;
+  size_t totalAfter = 0;
+  for (Job &job : jobs) {
+    if (job.format != BlockFormat::RGBA8)
+      job.psnr = blockPSNR(job.format, job.mips[0].data(), job.result.width, job.result.height, job.result.levels[0].data());
+    if (!saveKtx2(job.output.string(), job.result))
+      continue;
+
+    size_t before = 0;
+    for (const vector<uint8_t> &mip : job.mips)
+      before += mip.size();
+    totalBefore += before;
+    totalAfter += job.result.bytes();
+    std::cout << std::left << std::setw(48) << fs::relative(job.source, RESOURCES_DIR).string() << std::right
+      << std::setw(5) << blockFormatName(job.format) << std::setw(6) << job.result.width << "x" << std::setw(5) << std::left << job.result.height << std::right
+      << std::setw(8) << before / 1024 << " KiB -> " << std::setw(6) << job.result.bytes() / 1024 << " KiB"
+      << "  PSNR " << std::fixed << std::setprecision(2);
+    if (job.format == BlockFormat::RGBA8)
+      std::cout << "lossless" << std::endl;
+    else
+      std::cout << job.psnr << " dB" << std::endl;
+  }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+  std::cout << "Compressed " << jobs.size() << " textures on " << threadCount << " threads in " << std::setprecision(2) << seconds
+    << "s: " << totalBefore / 1024 << " KiB -> " << totalAfter / 1024 << " KiB ("
+    << (totalAfter > 0 ? (double)totalBefore / totalAfter : 0.0) << "x smaller)" << std::endl;
+  return 0;
+}